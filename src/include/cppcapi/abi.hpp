@@ -0,0 +1,221 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the ABI fingerprint and its negotiation, allowing services and clients built with the
+ * same toolchain to pass exceptions across the boundary as-is.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "interface.h"
+
+#define CPPCAPI_ABI_STR_IMPL(x) #x
+#define CPPCAPI_ABI_STR(x) CPPCAPI_ABI_STR_IMPL(x)
+
+#if defined(__clang__)
+#define CPPCAPI_ABI_COMPILER "clang-" __clang_version__
+#elif defined(__GNUC__)
+#define CPPCAPI_ABI_COMPILER "gcc-" __VERSION__
+#else
+#define CPPCAPI_ABI_COMPILER "unknown"
+#endif
+
+#if defined(_LIBCPP_VERSION)
+#define CPPCAPI_ABI_STDLIB \
+	"libc++-" CPPCAPI_ABI_STR(_LIBCPP_VERSION) "-abi" CPPCAPI_ABI_STR(_LIBCPP_ABI_VERSION)
+#elif defined(__GLIBCXX__)
+#define CPPCAPI_ABI_STDLIB \
+	"libstdc++-" CPPCAPI_ABI_STR(__GLIBCXX__) "-cxx11abi" CPPCAPI_ABI_STR(_GLIBCXX_USE_CXX11_ABI)
+#else
+#define CPPCAPI_ABI_STDLIB "unknown"
+#endif
+
+/**
+ * Fingerprint of the compiler and standard library, which must match for exceptions thrown by one
+ * to be caught by the other.
+ *
+ * Can be overridden, e.g. to an empty string to disable passing exceptions as-is.
+ */
+#ifndef CPPCAPI_ABI_FINGERPRINT
+#define CPPCAPI_ABI_FINGERPRINT CPPCAPI_ABI_COMPILER ";" CPPCAPI_ABI_STDLIB
+#endif
+
+namespace cppcapi
+{
+/// ABI fingerprint of this build.
+inline constexpr char const * abi_fingerprint = CPPCAPI_ABI_FINGERPRINT;
+
+namespace detail
+{
+enum class AbiState : std::uint8_t
+{
+	unnegotiated,
+	matched,
+	mismatched
+};
+
+/// Result of negotiating with clients of this service.
+inline std::atomic<AbiState> & service_abi_state() noexcept
+{
+	static std::atomic<AbiState> state{AbiState::unnegotiated};
+	return state;
+}
+
+/**
+ * Whether this client negotiated a matching ABI with any service, so requests the original
+ * exception from all services, each of which checks the request, see request_exception.
+ */
+inline std::atomic<bool> & client_abi_matched() noexcept
+{
+	static std::atomic<bool> matched{false};
+	return matched;
+}
+
+/// Storage for the original exception within a payload, or `nullptr` if not suitably aligned.
+inline void * exception_storage(cppcapi_ErrorPayload & payload) noexcept
+{
+	static_assert(sizeof(std::exception_ptr) <= CPPCAPI_ERROR_PAYLOAD_CAPACITY);
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	if (reinterpret_cast<std::uintptr_t>(payload.data) % alignof(std::exception_ptr) != 0)
+		return nullptr;
+	return payload.data;
+}
+
+/**
+ * Request the original exception from a service, on behalf of this client.
+ *
+ * The request carries the ABI fingerprint of this client in the payload, so a service only passes
+ * the exception as-is if the calling client matches, whichever clients it has negotiated with.
+ *
+ * @param payload Payload following the message buffer, whose `type` is zeroed.
+ */
+inline void request_exception(cppcapi_ErrorPayload & payload) noexcept
+{
+	char const * const fingerprint = abi_fingerprint;
+	std::memcpy(payload.data, &fingerprint, sizeof(fingerprint));
+	payload.size = sizeof(fingerprint);
+}
+
+/// Whether a payload was requested by a client with the same ABI as this service.
+inline bool is_requested_by_matching_abi(cppcapi_ErrorPayload const & payload) noexcept
+{
+	char const * fingerprint = nullptr;
+	if (payload.size != sizeof(fingerprint))
+		return false;
+	std::memcpy(&fingerprint, payload.data, sizeof(fingerprint));
+	return fingerprint != nullptr &&
+		(fingerprint == abi_fingerprint || std::strcmp(fingerprint, abi_fingerprint) == 0);
+}
+
+/**
+ * Move the exception currently being handled into a payload, if a matching client requested it.
+ *
+ * Must be called from within the handler catching the exception.
+ *
+ * @param err Storage for error message, whose `size` must not yet have been overwritten.
+ * @param payload Requested payload, or `nullptr` if none was requested.
+ * @return Whether the exception was passed, in which case the message is left empty.
+ */
+inline bool pass_exception(cppcapi_ErrorMessage & err, cppcapi_ErrorPayload * payload) noexcept
+{
+	if (payload == nullptr || err.size != cppcapi_error_exception_requested ||
+		service_abi_state().load(std::memory_order_relaxed) != AbiState::matched ||
+		!is_requested_by_matching_abi(*payload))
+		return false;
+
+	void * const storage = exception_storage(*payload);
+	if (storage == nullptr)
+		return false;
+
+	new (storage) std::exception_ptr{std::current_exception()};
+	payload->type = CPPCAPI_ERROR_PAYLOAD_EXCEPTION;
+	payload->size = sizeof(std::exception_ptr);
+	err.size = 0;
+	return true;
+}
+
+/**
+ * Move the original exception out of a payload, if the service passed it.
+ *
+ * @param payload Payload of a failed call, or `nullptr`.
+ * @return Original exception, or null if the service did not pass it.
+ */
+inline std::exception_ptr take_exception(cppcapi_ErrorPayload * payload) noexcept
+{
+	if (payload == nullptr || payload->type != CPPCAPI_ERROR_PAYLOAD_EXCEPTION)
+		return {};
+
+	auto * const passed =
+		std::launder(static_cast<std::exception_ptr *>(exception_storage(*payload)));
+	std::exception_ptr exception = std::move(*passed);
+	passed->~exception_ptr();
+	payload->type = 0;
+	return exception;
+}
+}  // namespace detail
+
+namespace service
+{
+/**
+ * Negotiate the ABI with a client, to be called from the service's exported
+ * CPPCAPI_NEGOTIATE_ABI_SYMBOL function, e.g.
+ *
+ *     extern "C" MY_EXPORT int cppcapi_negotiate_abi(char const * client_fingerprint)
+ *     {
+ *         return cppcapi::service::negotiate_abi(client_fingerprint);
+ *     }
+ *
+ * Exceptions are only passed as-is whilst every client that has negotiated has a matching ABI,
+ * so a single mismatched client reverts all calls to error codes and messages. Each request for
+ * the original exception also carries the fingerprint of the calling client, so clients that
+ * didn't negotiate with this service, e.g. because they matched another, are checked too.
+ *
+ * @param client_fingerprint ABI fingerprint of the client.
+ * @return Non-zero if exceptions will be passed as-is.
+ */
+inline int negotiate_abi(char const * client_fingerprint) noexcept
+{
+	auto & state = detail::service_abi_state();
+	if (client_fingerprint == nullptr || *abi_fingerprint == '\0' ||
+		std::strcmp(client_fingerprint, abi_fingerprint) != 0)
+	{
+		state.store(detail::AbiState::mismatched);
+		return 0;
+	}
+	auto expected = detail::AbiState::unnegotiated;
+	state.compare_exchange_strong(expected, detail::AbiState::matched);
+	return state.load() == detail::AbiState::matched ? 1 : 0;
+}
+}  // namespace service
+
+namespace client
+{
+/**
+ * Negotiate the ABI with a service, via its exported CPPCAPI_NEGOTIATE_ABI_SYMBOL function.
+ *
+ * If matched, then subsequent synchronous calls that would throw on error request the original
+ * exception, rethrowing it as-is rather than converting it to and from an error code and message.
+ * Otherwise, or for services that didn't match, errors are converted via the ErrorMap as usual.
+ *
+ * Note that, once matched with any service, the original exception is requested from every
+ * service. Requests carry this client's fingerprint, so services with a different ABI decline.
+ *
+ * @param negotiate Function exported by the service, or `nullptr` if it doesn't export one.
+ * @return Whether exceptions will be passed as-is by the service.
+ */
+inline bool negotiate_abi(cppcapi_NegotiateAbiFn const negotiate) noexcept
+{
+	if (negotiate == nullptr || negotiate(abi_fingerprint) == 0)
+		return false;
+	detail::client_abi_matched().store(true);
+	return true;
+}
+}  // namespace client
+}  // namespace cppcapi
@@ -0,0 +1,81 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Borrowed view used to wrap handles that are not owned by the wrapper.
+ */
+#pragma once
+
+namespace cppcapi::client
+{
+/**
+ * Non-owning view of a handle as a client adapter.
+ *
+ * The adapter is constructed in place but never destroyed, so never calls `release` on the
+ * handle. Used when a handle is lent for the duration of a call, e.g. a service function taking a
+ * reference to an adapter, where the caller retains ownership of the handle.
+ *
+ * Only valid for as long as the lender keeps the handle alive.
+ *
+ * @tparam Adapter Client adapter class, see SuiteAdapter.
+ */
+template <class Adapter>
+class Borrowed
+{
+public:
+	using Handle = typename Adapter::Handle;
+
+	/**
+	 * Wrap a handle without taking ownership.
+	 *
+	 * @param handle Opaque handle to borrow.
+	 */
+	explicit Borrowed(Handle handle) : adapter_{handle} {}
+
+	/// Copies would alias the same view, moves are unnecessary given guaranteed copy elision.
+	Borrowed(Borrowed const &) = delete;
+	Borrowed(Borrowed &&) = delete;
+	Borrowed & operator=(Borrowed const &) = delete;
+	Borrowed & operator=(Borrowed &&) = delete;
+
+	/// Deliberately skip destruction of the adapter, so the borrowed handle is not released.
+	~Borrowed() {}	// NOLINT(modernize-use-equals-default)
+
+	[[nodiscard]] Adapter & get() noexcept
+	{
+		return adapter_;
+	}
+
+	[[nodiscard]] Adapter const & get() const noexcept
+	{
+		return adapter_;
+	}
+
+	Adapter * operator->() noexcept
+	{
+		return &adapter_;
+	}
+
+	Adapter const * operator->() const noexcept
+	{
+		return &adapter_;
+	}
+
+	/// Allow passing to functions taking a reference to the adapter.
+	operator Adapter &() noexcept	// NOLINT(google-explicit-constructor)
+	{
+		return adapter_;
+	}
+
+	/// Allow passing to functions taking a const reference to the adapter.
+	operator Adapter const &() const noexcept  // NOLINT(google-explicit-constructor)
+	{
+		return adapter_;
+	}
+
+private:
+	union
+	{
+		Adapter adapter_;
+	};
+};
+}  // namespace cppcapi::client
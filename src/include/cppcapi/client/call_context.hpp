@@ -0,0 +1,126 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the CallContext used by clients to set a deadline for, or cancel, suite function calls.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "../interface.h"
+
+namespace cppcapi::client
+{
+/**
+ * Deadline and cancellation state to attach to suite function calls.
+ *
+ * Can be passed explicitly as the argument to SuiteAdapter::call corresponding to a
+ * `cppcapi_CallContext const *` parameter, or made current for all calls on this thread via a
+ * Scope. Must outlive any calls (including asynchronous calls) it is attached to.
+ */
+class CallContext
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Makes a context current for calls on this thread that don't explicitly provide one, for the
+	 * lifetime of the scope.
+	 */
+	class Scope
+	{
+	public:
+		explicit Scope(CallContext const & context) noexcept : previous_{current_}
+		{
+			current_ = &context;
+		}
+
+		Scope(Scope const &) = delete;
+		Scope(Scope &&) = delete;
+		Scope & operator=(Scope const &) = delete;
+		Scope & operator=(Scope &&) = delete;
+
+		~Scope()
+		{
+			current_ = previous_;
+		}
+
+	private:
+		CallContext const * previous_;
+	};
+
+	/// Construct a context with no deadline.
+	CallContext() noexcept : CallContext{Clock::time_point{}} {}
+
+	/**
+	 * Construct a context with a deadline.
+	 *
+	 * @param deadline Point in time after which calls should fail rather than start.
+	 */
+	explicit CallContext(Clock::time_point const deadline) noexcept
+		: c_context_{to_deadline_ns(deadline), &CallContext::is_cancelled, this}
+	{
+	}
+
+	/**
+	 * Construct a context with a deadline relative to now.
+	 *
+	 * @param timeout Duration after which calls should fail rather than start.
+	 */
+	explicit CallContext(Clock::duration const timeout) noexcept
+		: CallContext{Clock::now() + timeout}
+	{
+	}
+
+	/// Context is referenced by address from the C struct, so is neither copyable nor movable.
+	CallContext(CallContext const &) = delete;
+	CallContext(CallContext &&) = delete;
+	CallContext & operator=(CallContext const &) = delete;
+	CallContext & operator=(CallContext &&) = delete;
+	~CallContext() = default;
+
+	/// Cancel all calls using this context. Can be called from any thread.
+	void cancel() noexcept
+	{
+		cancelled_.store(true, std::memory_order_release);
+	}
+
+	/// Whether `cancel` has been called.
+	[[nodiscard]] bool cancelled() const noexcept
+	{
+		return cancelled_.load(std::memory_order_acquire);
+	}
+
+	/// C struct to pass to suite functions.
+	[[nodiscard]] cppcapi_CallContext const * get() const noexcept
+	{
+		return &c_context_;
+	}
+
+	/// C struct of the context made current on this thread by a Scope, or null if none.
+	static cppcapi_CallContext const * current() noexcept
+	{
+		return current_ == nullptr ? nullptr : current_->get();
+	}
+
+private:
+	static long long to_deadline_ns(Clock::time_point const deadline) noexcept
+	{
+		if (deadline == Clock::time_point{})
+			return cppcapi_no_deadline;
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch())
+			.count();
+	}
+
+	static int is_cancelled(void * data)
+	{
+		return static_cast<CallContext const *>(data)->cancelled() ? 1 : 0;
+	}
+
+	std::atomic<bool> cancelled_{false};
+	cppcapi_CallContext c_context_;
+
+	inline static thread_local CallContext const * current_ = nullptr;
+};
+}  // namespace cppcapi::client
@@ -0,0 +1,235 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the CommandBuffer used by clients to record suite function calls for batch execution.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../commands.hpp"
+#include "../error_map.hpp"
+#include "../interface.h"
+
+namespace cppcapi::client
+{
+/**
+ * Recording of suite function calls, to be replayed by the service in a single `execute` call.
+ *
+ * Commands are typically recorded via SuiteAdapter::record, which takes care of converting
+ * arguments to handles. Temporary arguments are kept alive by the buffer until it is cleared or
+ * destroyed, whereas arguments given as lvalues must outlive execution.
+ *
+ * @tparam TCommands Commands list agreed between client and service.
+ * @tparam TErrorMap ErrorMap detailing mapping of exceptions to error codes.
+ */
+template <class TCommands, class TErrorMap>
+class CommandBuffer
+{
+public:
+	using Commands = TCommands;
+	/// Signature of the suite function that replays a command buffer.
+	using ExecuteFn = cppcapi_ErrorCode (*)(
+		cppcapi_ErrorMessage *, cppcapi_CommandResult *, cppcapi_CommandBuffer const *);
+
+	static constexpr std::size_t default_error_capacity = 500;
+
+	/**
+	 * Deferred value of an out-parameter of a recorded command.
+	 *
+	 * @tparam Ret Type of out-parameter.
+	 */
+	template <class Ret>
+	class Result
+	{
+	public:
+		Result(CommandBuffer const & buffer, std::size_t const index, Ret const & value)
+			: buffer_{&buffer}, index_{index}, value_{&value}
+		{
+		}
+
+		/**
+		 * Get the value of the out-parameter, once the buffer has been executed.
+		 *
+		 * A non-zero error code of the command is thrown as an exception, as defined by the
+		 * ErrorMap.
+		 *
+		 * @return Value of out-parameter.
+		 */
+		Ret get() const
+		{
+			buffer_->throw_on_error(index_);
+			return *value_;
+		}
+
+		/// Index of the command within the buffer.
+		[[nodiscard]] std::size_t index() const
+		{
+			return index_;
+		}
+
+	private:
+		CommandBuffer const * buffer_;
+		std::size_t index_;
+		Ret const * value_;
+	};
+
+	explicit CommandBuffer(std::size_t const error_capacity = default_error_capacity)
+		: err_storage_(error_capacity, '\0')
+	{
+	}
+
+	/**
+	 * Append a command with already-converted C arguments.
+	 *
+	 * @tparam member Pointer to member of the function pointer suite.
+	 * @param args Arguments to the suite function, excluding any leading error message.
+	 * @return Index of the command within the buffer.
+	 */
+	template <auto member, class... Args>
+	std::size_t append(Args const... args)
+	{
+		if (executed_)
+			cppcapi::detail::raise<std::logic_error>(
+				"Cannot record into an executed command buffer, clear it first");
+		Commands::template encode<member>(data_, args...);
+		return count_++;
+	}
+
+	/**
+	 * Keep an argument alive until the buffer is cleared, if it is a temporary.
+	 *
+	 * @param value Argument to keep alive.
+	 * @return Reference to kept value, or the original lvalue.
+	 */
+	template <class Arg>
+	decltype(auto) keep(Arg && value)
+	{
+		if constexpr (std::is_lvalue_reference_v<Arg> || !std::is_class_v<std::decay_t<Arg>>)
+		{
+			return std::forward<Arg>(value);
+		}
+		else
+		{
+			auto kept = std::make_shared<std::decay_t<Arg>>(std::forward<Arg>(value));
+			auto & ref = *kept;
+			keep_alive_.push_back(std::move(kept));
+			return ref;
+		}
+	}
+
+	/**
+	 * Allocate storage for an out-parameter that lives until the buffer is cleared.
+	 *
+	 * @tparam Ret Type of out-parameter.
+	 * @return Pointer to storage.
+	 */
+	template <class Ret>
+	Ret * allocate()
+	{
+		auto out = std::make_shared<Ret>();
+		Ret * ptr = out.get();
+		keep_alive_.push_back(std::move(out));
+		return ptr;
+	}
+
+	/**
+	 * Replay all recorded commands using the service's `execute` suite function.
+	 *
+	 * Per-command errors are not thrown, but can be queried via `code`/`throw_on_error` or
+	 * Result::get.
+	 *
+	 * @param execute_fn Suite function that replays the buffer.
+	 * @return Error code of the first command that failed, or cppcapi_ok.
+	 */
+	cppcapi_ErrorCode execute(ExecuteFn execute_fn)
+	{
+		results_.assign(count_, cppcapi_CommandResult{cppcapi_ok, 0, 0});
+		cppcapi_ErrorMessage err{err_storage_.size(), 0, err_storage_.data()};
+		cppcapi_CommandBuffer const buffer{data_.data(), data_.size(), count_};
+
+		cppcapi_ErrorCode const code = execute_fn(&err, results_.data(), &buffer);
+		executed_ = true;
+
+		bool const any_failed = std::any_of(
+			results_.begin(),
+			results_.end(),
+			[](auto const & command_result) { return command_result.code != cppcapi_ok; });
+
+		// A failure not attributable to any individual command means the buffer as a whole
+		// failed, e.g. it was malformed.
+		if (code != cppcapi_ok && !any_failed)
+			TErrorMap::throw_exception(err, code);
+
+		return code;
+	}
+
+	/// Error code of the command at the given index, once executed.
+	[[nodiscard]] cppcapi_ErrorCode code(std::size_t const index) const
+	{
+		return result(index).code;
+	}
+
+	/**
+	 * Throw the error of the command at the given index, if any, as defined by the ErrorMap.
+	 *
+	 * @param index Index of the command.
+	 */
+	void throw_on_error(std::size_t const index) const
+	{
+		auto const & command_result = result(index);
+		if (command_result.code == cppcapi_ok)
+			return;
+
+		auto * message = const_cast<char *>(err_storage_.data()) + command_result.message_offset;
+		// Capacity includes the terminator, so is non-zero even for an empty message.
+		cppcapi_ErrorMessage const err{
+			command_result.message_size + 1, command_result.message_size, message};
+		TErrorMap::throw_exception(err, command_result.code);
+	}
+
+	/// Number of recorded commands.
+	[[nodiscard]] std::size_t size() const
+	{
+		return count_;
+	}
+
+	/// Whether no commands have been recorded.
+	[[nodiscard]] bool empty() const
+	{
+		return count_ == 0;
+	}
+
+	/// Remove all commands, results and kept-alive arguments, ready for re-use.
+	void clear()
+	{
+		data_.clear();
+		results_.clear();
+		keep_alive_.clear();
+		count_ = 0;
+		executed_ = false;
+	}
+
+private:
+	cppcapi_CommandResult const & result(std::size_t const index) const
+	{
+		if (!executed_)
+			cppcapi::detail::raise<std::logic_error>("Command buffer has not been executed");
+		return results_.at(index);
+	}
+
+	std::vector<unsigned char> data_;
+	std::size_t count_{0};
+	bool executed_{false};
+	std::vector<cppcapi_CommandResult> results_;
+	std::vector<std::shared_ptr<void>> keep_alive_;
+	std::string err_storage_;
+};
+}  // namespace cppcapi::client
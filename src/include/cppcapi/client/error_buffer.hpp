@@ -0,0 +1,148 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the per-thread storage for error messages of synchronous suite function calls.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <exception>
+#include <utility>
+
+#include "../abi.hpp"
+#include "../error_map.hpp"
+#include "../interface.h"
+
+namespace cppcapi::client
+{
+/**
+ * Makes synchronous suite function calls on this thread status-only, for the lifetime of the
+ * scope.
+ *
+ * Rather than copying the message of every error into client storage, the service keeps the
+ * message alive in thread-local storage and the client only reads it when converting the error
+ * code to an exception, see cppcapi_ErrorMessage. Useful where errors are expected and handled by
+ * type, so their messages are rarely needed.
+ *
+ * Only affects calls whose error is inspected on the calling thread before any other call is
+ * made, i.e. SuiteAdapter::call and Range. Asynchronous calls and command buffers always copy
+ * messages into client storage.
+ */
+class StatusOnlyScope
+{
+public:
+	StatusOnlyScope() noexcept : previous_{active_}
+	{
+		active_ = true;
+	}
+
+	StatusOnlyScope(StatusOnlyScope const &) = delete;
+	StatusOnlyScope(StatusOnlyScope &&) = delete;
+	StatusOnlyScope & operator=(StatusOnlyScope const &) = delete;
+	StatusOnlyScope & operator=(StatusOnlyScope &&) = delete;
+
+	~StatusOnlyScope()
+	{
+		active_ = previous_;
+	}
+
+	/// Whether a scope is active on this thread.
+	[[nodiscard]] static bool active() noexcept
+	{
+		return active_;
+	}
+
+private:
+	bool previous_;
+
+	inline static thread_local bool active_ = false;
+};
+
+namespace detail
+{
+/**
+ * Capacity of the per-thread buffer receiving error messages.
+ *
+ * Chosen such that the payload data following the message is aligned for a `std::exception_ptr`.
+ */
+inline constexpr std::size_t error_buffer_capacity = 504;
+
+/// Per-thread storage for the message and payload of a synchronous suite function call.
+struct alignas(std::exception_ptr) ErrorBuffer
+{
+	char message[error_buffer_capacity];  // NOLINT(*-avoid-c-arrays)
+	/// Must immediately follow the message, see cppcapi_ErrorMessage.
+	cppcapi_ErrorPayload payload;
+};
+
+static_assert(
+	offsetof(ErrorBuffer, payload) == error_buffer_capacity,
+	"Error payload must immediately follow the message buffer");
+static_assert(
+	(offsetof(ErrorBuffer, payload) + offsetof(cppcapi_ErrorPayload, data)) %
+			alignof(std::exception_ptr) ==
+		0,
+	"Error payload data must be aligned to hold an exception passed as-is");
+
+inline ErrorBuffer & error_buffer() noexcept
+{
+	thread_local ErrorBuffer buffer{};
+	return buffer;
+}
+
+/**
+ * Error message storage for a synchronous suite function call on this thread.
+ *
+ * All adapters and ranges share a single buffer per thread, which is safe since a synchronous
+ * call's message is converted to an exception before the next call is made.
+ *
+ * @param rethrow Whether the error will be rethrown, so the original exception can be requested
+ * if the ABI was negotiated, see client::negotiate_abi.
+ * @return Message referencing the per-thread buffer, also requesting a payload, or a status-only
+ * message if a StatusOnlyScope is active.
+ */
+inline cppcapi_ErrorMessage error_message([[maybe_unused]] bool const rethrow = true) noexcept
+{
+	if (StatusOnlyScope::active())
+		return {0, 0, nullptr};
+
+	ErrorBuffer & buffer = error_buffer();
+	buffer.payload.type = 0;
+#if CPPCAPI_EXCEPTIONS
+	if (rethrow && cppcapi::detail::client_abi_matched().load(std::memory_order_relaxed))
+	{
+		cppcapi::detail::request_exception(buffer.payload);
+		return {error_buffer_capacity, cppcapi_error_exception_requested, buffer.message};
+	}
+#endif
+	return {error_buffer_capacity, cppcapi_error_payload_requested, buffer.message};
+}
+
+/**
+ * Payload of a failed synchronous suite function call on this thread.
+ *
+ * @param err Message returned by error_message.
+ * @return Payload, or `nullptr` if `err` did not request one.
+ */
+inline cppcapi_ErrorPayload * error_payload(cppcapi_ErrorMessage const & err) noexcept
+{
+	ErrorBuffer & buffer = error_buffer();
+	return err.data == buffer.message ? &buffer.payload : nullptr;
+}
+
+/**
+ * Rethrow the original exception of a failed synchronous suite function call on this thread, if
+ * the service passed it as-is.
+ *
+ * @param err Message returned by error_message.
+ */
+inline void rethrow_if_passed([[maybe_unused]] cppcapi_ErrorMessage const & err)
+{
+#if CPPCAPI_EXCEPTIONS
+	if (std::exception_ptr exception = cppcapi::detail::take_exception(error_payload(err)))
+		std::rethrow_exception(std::move(exception));
+#endif
+}
+}  // namespace detail
+}  // namespace cppcapi::client
@@ -0,0 +1,243 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Future returned by clients calling asynchronous suite functions.
+ */
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../error_map.hpp"
+#include "../interface.h"
+#include "../pointers.hpp"
+
+namespace cppcapi::client
+{
+/**
+ * Options controlling how an asynchronous suite function is invoked.
+ */
+struct AsyncOptions
+{
+	/// Executor to run the call on, or null to use the service's default executor.
+	cppcapi_Executor const * executor = nullptr;
+	/// Whether to create an `eventfd` that is signalled on completion, see Future::eventfd.
+	bool use_eventfd = false;
+};
+
+namespace detail
+{
+/**
+ * Storage type for an argument that must outlive an asynchronous call.
+ *
+ * Rvalues (e.g. temporaries) are moved and copyable lvalues are copied into the shared state of
+ * the call. Non-copyable lvalues (e.g. adapters) are stored by reference, so must outlive the call.
+ */
+template <class Arg>
+using kept_t = std::conditional_t<
+	std::is_lvalue_reference_v<Arg> && !std::is_copy_constructible_v<std::decay_t<Arg>>,
+	Arg,
+	std::decay_t<Arg>>;
+
+/**
+ * State shared between a Future and the service completing the call it represents.
+ *
+ * @tparam Ret Type of out-parameter, or void if none.
+ */
+template <class Ret>
+struct AsyncState
+{
+	using RetStorage = std::conditional_t<std::is_void_v<Ret>, char, Ret>;
+
+	explicit AsyncState(std::size_t const error_capacity)
+		: err_storage(error_capacity, '\0'), err{err_storage.size(), 0, err_storage.data()}
+	{
+	}
+
+	AsyncState(AsyncState const &) = delete;
+	AsyncState(AsyncState &&) = delete;
+	AsyncState & operator=(AsyncState const &) = delete;
+	AsyncState & operator=(AsyncState &&) = delete;
+
+	virtual ~AsyncState()
+	{
+		if (eventfd >= 0)
+			::close(eventfd);
+	}
+
+	/**
+	 * Construct a C completion struct that will notify this state.
+	 *
+	 * The completion holds a strong reference to the state until the service signals completion.
+	 *
+	 * @param self Shared pointer to this state.
+	 * @param options Executor and notification options.
+	 * @return C completion struct to pass to the suite function.
+	 */
+	static cppcapi_Completion make_completion(
+		SharedPtr<AsyncState> const & self, AsyncOptions const & options)
+	{
+		if (options.use_eventfd)
+		{
+			self->eventfd = ::eventfd(0, EFD_CLOEXEC);
+			if (self->eventfd < 0)
+				cppcapi::detail::raise<std::system_error>(
+					errno, std::generic_category(), "Failed to create eventfd");
+		}
+
+		return {
+			&AsyncState::on_complete,
+			new SharedPtr<AsyncState>{self},
+			&self->err,
+			self->eventfd,
+			options.executor};
+	}
+
+	static void on_complete(void * user_data, cppcapi_ErrorCode const code)
+	{
+		std::unique_ptr<SharedPtr<AsyncState>> const self{
+			static_cast<SharedPtr<AsyncState> *>(user_data)};
+		{
+			std::lock_guard lock{(*self)->mutex};
+			(*self)->code = code;
+			(*self)->done = true;
+		}
+		(*self)->cv.notify_all();
+	}
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool done{false};
+	cppcapi_ErrorCode code{cppcapi_ok};
+	std::string err_storage;
+	cppcapi_ErrorMessage err;
+	RetStorage ret{};
+	int eventfd{-1};
+};
+
+/**
+ * AsyncState extended with storage for the arguments of the call, keeping them alive until
+ * completion.
+ *
+ * @tparam Ret Type of out-parameter, or void if none.
+ * @tparam Args Argument types as given by the caller.
+ */
+template <class Ret, class... Args>
+struct AsyncCall : AsyncState<Ret>
+{
+	template <class... Rest>
+	explicit AsyncCall(std::size_t const error_capacity, Rest &&... rest)
+		: AsyncState<Ret>{error_capacity}, args{std::forward<Rest>(rest)...}
+	{
+	}
+
+	std::tuple<kept_t<Args>...> args;
+};
+}  // namespace detail
+
+/**
+ * Handle to the result of an asynchronous suite function call.
+ *
+ * Similar to `std::future` as returned by `std::async`, in particular the destructor blocks until
+ * the call has completed, ensuring that arguments and the adapter being called outlive the call.
+ *
+ * @tparam Ret Type of out-parameter of the suite function, or void if none.
+ * @tparam TErrorMap ErrorMap detailing mapping of exceptions to error codes.
+ */
+template <class Ret, class TErrorMap>
+class Future
+{
+	using State = detail::AsyncState<Ret>;
+
+public:
+	explicit Future(SharedPtr<State> state) : state_{std::move(state)} {}
+
+	Future(Future const &) = delete;
+	Future & operator=(Future const &) = delete;
+
+	Future(Future && other) noexcept = default;
+
+	Future & operator=(Future && other) noexcept
+	{
+		if (state_)
+			wait();
+		state_ = std::move(other.state_);
+		return *this;
+	}
+
+	/// Wait for completion if not already complete.
+	~Future()
+	{
+		if (state_)
+			wait();
+	}
+
+	/// Check whether the call has completed, without blocking.
+	[[nodiscard]] bool ready() const
+	{
+		std::lock_guard lock{state_->mutex};
+		return state_->done;
+	}
+
+	/// Block until the call has completed.
+	void wait() const
+	{
+		std::unique_lock lock{state_->mutex};
+		state_->cv.wait(lock, [this] { return state_->done; });
+	}
+
+	/**
+	 * Block until the call has completed or the timeout expires.
+	 *
+	 * @param timeout Maximum duration to wait.
+	 * @return Whether the call has completed.
+	 */
+	template <class Rep, class Period>
+	bool wait_for(std::chrono::duration<Rep, Period> const & timeout) const
+	{
+		std::unique_lock lock{state_->mutex};
+		return state_->cv.wait_for(lock, timeout, [this] { return state_->done; });
+	}
+
+	/**
+	 * Block until the call has completed, then get the value of the out-parameter, if any.
+	 *
+	 * A non-zero error code is thrown as an exception, as defined by the ErrorMap.
+	 *
+	 * @return Value of the suite function's out-parameter.
+	 */
+	Ret get() const
+	{
+		wait();
+		if (state_->code != cppcapi_ok)
+			TErrorMap::throw_exception(state_->err, state_->code);
+
+		if constexpr (!std::is_void_v<Ret>)
+			return state_->ret;
+	}
+
+	/**
+	 * File descriptor signalled on completion, suitable for `poll`/`epoll`.
+	 *
+	 * Only valid if AsyncOptions::use_eventfd was set, otherwise -1. Owned by this Future.
+	 */
+	[[nodiscard]] int eventfd() const
+	{
+		return state_->eventfd;
+	}
+
+private:
+	SharedPtr<State> state_;
+};
+}  // namespace cppcapi::client
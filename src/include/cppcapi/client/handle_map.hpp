@@ -9,21 +9,80 @@
 
 namespace cppcapi::client
 {
+/**
+ * List of pointers to suite members whose functions are pure, i.e. whose result for a given
+ * handle only changes as a result of other calls made with that handle.
+ *
+ * @tparam Tmembers Pointers to function pointer members of a suite.
+ */
+template <auto... Tmembers>
+struct PureFunctions
+{
+};
+
 /**
  * Client-specific traits for a particular opaque handle type.
  *
  * @tparam THandle Type of opaque handle.
  * @tparam TSuite Function pointer suite struct associated with handle.
  * @tparam TClass Adapter class responsible for wrapping handles of Handle type on the client.
- * @tparam Tsuite_factory Function returning a function pointer suite, if available at compile-time.
+ * @tparam Tsuite_factory Function returning a pointer to the (typically constant-initialized)
+ * function pointer suite, if available at compile-time.
+ * @tparam Tpure_functions Pointers to suite members taking no arguments other than the handle,
+ * whose results adapters may cache, see SuiteAdapter::call.
  */
-template <class THandle, class TSuite, class TClass, TSuite (*Tsuite_factory)() = nullptr>
+template <
+	class THandle,
+	class TSuite,
+	class TClass,
+	TSuite const * (*Tsuite_factory)() = nullptr,
+	auto... Tpure_functions>
 struct HandleTraits
 {
 	using Handle = THandle;
 	using Suite = TSuite;
 	using Class = TClass;
+	using Pure = PureFunctions<Tpure_functions...>;
 	static constexpr auto suite_factory = Tsuite_factory;
+	static constexpr bool dynamic_suite = false;
+	static constexpr bool write_buffered = false;
+};
+
+/**
+ * Client-specific traits for an opaque handle whose instances carry the suite of their dynamic
+ * type, i.e. handles using service::DynamicDispatch.
+ *
+ * Adapters wrapping an existing handle take their suite from the handle, rather than from a
+ * compile-time suite factory.
+ *
+ * @tparam THandle Type of opaque handle.
+ * @tparam TSuite Function pointer suite struct shared by all dynamic types.
+ * @tparam TClass Adapter class responsible for wrapping handles of Handle type on the client.
+ */
+template <class THandle, class TSuite, class TClass>
+struct DynamicHandleTraits : HandleTraits<THandle, TSuite, TClass>
+{
+	static constexpr bool dynamic_suite = true;
+};
+
+/**
+ * Client-specific traits for an opaque handle whose adapters can be bound to a WriteBuffer.
+ *
+ * Once bound, see SuiteAdapter::bind_writes, any call crossing the boundary via the adapter first
+ * flushes the buffer, so reads observe the effects of deferred calls.
+ *
+ * Template parameters are as for HandleTraits.
+ */
+template <
+	class THandle,
+	class TSuite,
+	class TClass,
+	TSuite const * (*Tsuite_factory)() = nullptr,
+	auto... Tpure_functions>
+struct WriteBufferedHandleTraits
+	: HandleTraits<THandle, TSuite, TClass, Tsuite_factory, Tpure_functions...>
+{
+	static constexpr bool write_buffered = true;
 };
 
 struct fallback_suite_t : std::false_type
@@ -41,6 +100,21 @@ struct fallback_suite_factory_t : std::false_type
 	static constexpr auto type = nullptr;
 };
 
+struct fallback_dynamic_suite_t : std::false_type
+{
+	static constexpr bool type = false;
+};
+
+struct fallback_write_buffered_t : std::false_type
+{
+	static constexpr bool type = false;
+};
+
+struct fallback_pure_t : std::false_type
+{
+	using type = PureFunctions<>;
+};
+
 /**
  * Utility to look up the traits of a given opaque handle.
  *
@@ -63,6 +137,18 @@ struct HandleMap
 	using suite_factory_from_handle_t = typename std::disjunction<
 		typename HandleMap<Rest>::template suite_factory_from_handle_t<HandleToLookup>...>;
 
+	template <class HandleToLookup>
+	using dynamic_suite_from_handle_t = typename std::disjunction<
+		typename HandleMap<Rest>::template dynamic_suite_from_handle_t<HandleToLookup>...>;
+
+	template <class HandleToLookup>
+	using write_buffered_from_handle_t = typename std::disjunction<
+		typename HandleMap<Rest>::template write_buffered_from_handle_t<HandleToLookup>...>;
+
+	template <class HandleToLookup>
+	using pure_from_handle_t = typename std::disjunction<
+		typename HandleMap<Rest>::template pure_from_handle_t<HandleToLookup>...>;
+
 	/**
 	 * Find the adapter class associated with the given handle type.
 	 *
@@ -79,6 +165,14 @@ struct HandleMap
 	template <class HandleToLookup>
 	using suite_from_handle = typename suite_from_handle_t<HandleToLookup>::type;
 
+	/**
+	 * Find the PureFunctions of the suite associated with the given handle type.
+	 *
+	 * @tparam HandleToLookup Handle type to look up in traits list.
+	 */
+	template <class HandleToLookup>
+	using pure_from_handle = typename pure_from_handle_t<HandleToLookup>::type;
+
 	/**
 	 * Find the function pointer suite factory function associated with the given handle type.
 	 *
@@ -93,6 +187,30 @@ struct HandleMap
 	{
 		return suite_factory_from_handle_t<HandleToLookup>::type;
 	}
+
+	/**
+	 * Find whether instances of the given handle type carry the suite of their dynamic type.
+	 *
+	 * @tparam HandleToLookup Handle type to look up in traits list.
+	 * @return Whether the handle was registered via DynamicHandleTraits.
+	 */
+	template <class HandleToLookup>
+	static constexpr bool dynamic_suite_from_handle()
+	{
+		return dynamic_suite_from_handle_t<HandleToLookup>::type;
+	}
+
+	/**
+	 * Find whether adapters of the given handle type can be bound to a WriteBuffer.
+	 *
+	 * @tparam HandleToLookup Handle type to look up in traits list.
+	 * @return Whether the handle was registered via WriteBufferedHandleTraits.
+	 */
+	template <class HandleToLookup>
+	static constexpr bool write_buffered_from_handle()
+	{
+		return write_buffered_from_handle_t<HandleToLookup>::type;
+	}
 };
 
 /**
@@ -111,8 +229,14 @@ struct HandleMap<Traits>
 	using Class = typename Traits::Class;
 	/// Hoist function pointer suite class from traits.
 	using Suite = typename Traits::Suite;
+	/// Hoist list of pure suite functions from traits.
+	using Pure = typename Traits::Pure;
 	/// Hoist function pointer suite factory from traits.
 	static constexpr auto suite_factory = Traits::suite_factory;
+	/// Hoist whether instances carry the suite of their dynamic type from traits.
+	static constexpr bool dynamic_suite = Traits::dynamic_suite;
+	/// Hoist whether adapters can be bound to a WriteBuffer from traits.
+	static constexpr bool write_buffered = Traits::write_buffered;
 
 private:
 	template <class HandleToLookup>
@@ -133,6 +257,24 @@ private:
 		static constexpr auto type = suite_factory;
 	};
 
+	template <class HandleToLookup>
+	struct this_dynamic_suite_from_handle_t : std::is_same<Handle, HandleToLookup>
+	{
+		static constexpr bool type = dynamic_suite;
+	};
+
+	template <class HandleToLookup>
+	struct this_write_buffered_from_handle_t : std::is_same<Handle, HandleToLookup>
+	{
+		static constexpr bool type = write_buffered;
+	};
+
+	template <class HandleToLookup>
+	struct this_pure_from_handle_t : std::is_same<Handle, HandleToLookup>
+	{
+		using type = Pure;
+	};
+
 public:
 	template <class HandleToLookup>
 	using class_from_handle_t =
@@ -146,6 +288,19 @@ public:
 	using suite_factory_from_handle_t = typename std::
 		disjunction<this_suite_factory_from_handle_t<HandleToLookup>, fallback_suite_factory_t>;
 
+	template <class HandleToLookup>
+	using dynamic_suite_from_handle_t = typename std::
+		disjunction<this_dynamic_suite_from_handle_t<HandleToLookup>, fallback_dynamic_suite_t>;
+
+	template <class HandleToLookup>
+	using write_buffered_from_handle_t = typename std::disjunction<
+		this_write_buffered_from_handle_t<HandleToLookup>,
+		fallback_write_buffered_t>;
+
+	template <class HandleToLookup>
+	using pure_from_handle_t =
+		typename std::disjunction<this_pure_from_handle_t<HandleToLookup>, fallback_pure_t>;
+
 	/**
 	 * Get the adapter class associated with our Handle if HandleToLookup matches, otherwise
 	 * `std::false_type`.
@@ -164,6 +319,14 @@ public:
 	template <class HandleToLookup>
 	using suite_from_handle = typename suite_from_handle_t<HandleToLookup>::type;
 
+	/**
+	 * Get the PureFunctions of our suite if HandleToLookup matches, otherwise an empty list.
+	 *
+	 * @tparam HandleToLookup Handle type to compare with ours.
+	 */
+	template <class HandleToLookup>
+	using pure_from_handle = typename pure_from_handle_t<HandleToLookup>::type;
+
 	/**
 	 * Get the function pointer suite factory function associated with our Handle if HandleToLookup
 	 * matches, otherwise `nullptr`.
@@ -179,6 +342,32 @@ public:
 	{
 		return suite_factory_from_handle_t<HandleToLookup>::type;
 	}
+
+	/**
+	 * Get whether instances of our Handle carry the suite of their dynamic type if HandleToLookup
+	 * matches, otherwise `false`.
+	 *
+	 * @tparam HandleToLookup Handle type to compare with ours.
+	 * @return Whether the handle was registered via DynamicHandleTraits.
+	 */
+	template <class HandleToLookup>
+	static constexpr bool dynamic_suite_from_handle()
+	{
+		return dynamic_suite_from_handle_t<HandleToLookup>::type;
+	}
+
+	/**
+	 * Get whether adapters of our Handle can be bound to a WriteBuffer if HandleToLookup matches,
+	 * otherwise `false`.
+	 *
+	 * @tparam HandleToLookup Handle type to compare with ours.
+	 * @return Whether the handle was registered via WriteBufferedHandleTraits.
+	 */
+	template <class HandleToLookup>
+	static constexpr bool write_buffered_from_handle()
+	{
+		return write_buffered_from_handle_t<HandleToLookup>::type;
+	}
 };
 
 /**
@@ -205,6 +394,14 @@ struct HandleMap<>
 	template <class HandleToLookup>
 	using suite_from_handle = fallback_suite_t::type;
 
+	/**
+	 * Give the same fallback type no matter what handle type is given.
+	 *
+	 * @tparam HandleToLookup Handle type to look up.
+	 */
+	template <class HandleToLookup>
+	using pure_from_handle = fallback_pure_t::type;
+
 	/**
 	 * Give the same fallback type no matter what handle type is given.
 	 *
@@ -215,5 +412,27 @@ struct HandleMap<>
 	{
 		return fallback_suite_factory_t::type;
 	}
+
+	/**
+	 * Give the same fallback value no matter what handle type is given.
+	 *
+	 * @tparam HandleToLookup Handle type to look up.
+	 */
+	template <class HandleToLookup>
+	static constexpr bool dynamic_suite_from_handle()
+	{
+		return fallback_dynamic_suite_t::type;
+	}
+
+	/**
+	 * Give the same fallback value no matter what handle type is given.
+	 *
+	 * @tparam HandleToLookup Handle type to look up.
+	 */
+	template <class HandleToLookup>
+	static constexpr bool write_buffered_from_handle()
+	{
+		return fallback_write_buffered_t::type;
+	}
 };
 }  // namespace cppcapi::client
\ No newline at end of file
@@ -0,0 +1,120 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Memo used by client adapters to cache the results of pure suite functions.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../interface.h"
+#include "handle_map.hpp"
+
+namespace cppcapi::client::detail
+{
+template <class Suite, class Pure>
+class Memo;
+
+/**
+ * Cache of the results of pure suite functions for a single handle.
+ *
+ * Specialized to be empty if there are no pure functions, so costs nothing for adapters that
+ * don't opt in.
+ *
+ * Cached results are not synchronized, so a memoizing adapter must not be used concurrently.
+ *
+ * @tparam Suite Function pointer suite.
+ * @tparam members Pointers to suite members declared pure, see PureFunctions.
+ */
+template <class Suite, auto... members>
+class Memo<Suite, PureFunctions<members...>>
+{
+	/// Result of a pure suite function, whether returned directly or via an out-parameter.
+	template <class Member>
+	struct result_t
+	{
+		static_assert(
+			!sizeof(Member),
+			"Pure suite functions must take no arguments other than the handle, and return a "
+			"value");
+	};
+
+	template <class Ret, class Handle>
+	struct result_t<Ret (*Suite::*)(Handle)>
+	{
+		using type = Ret;
+	};
+
+	template <class Ret, class Handle>
+	struct result_t<cppcapi_ErrorCode (*Suite::*)(cppcapi_ErrorMessage *, Ret *, Handle)>
+	{
+		using type = Ret;
+	};
+
+	template <auto member>
+	using result = typename result_t<decltype(member)>::type;
+
+protected:
+	/// Whether any results are cached.
+	static constexpr bool kmemoized = sizeof...(members) > 0;
+
+	/**
+	 * Find the cached result of a suite function, if the function is pure.
+	 *
+	 * @tparam Ret Result of the suite function.
+	 * @tparam Fn Type of suite function.
+	 * @param suite Suite the function belongs to.
+	 * @param fn Suite function.
+	 * @return Storage for the cached result, or `nullptr` if the function is not pure.
+	 */
+	template <class Ret, class Fn>
+	std::optional<Ret> * memo_slot(Suite const & suite, Fn const fn) const noexcept
+	{
+		return memo_slot<Ret>(suite, fn, std::index_sequence_for<decltype(members)...>{});
+	}
+
+	/// Discard all cached results, e.g. after a call that may have mutated the instance.
+	void invalidate() const noexcept
+	{
+		std::apply([](auto &... results) { (results.reset(), ...); }, results_);
+	}
+
+private:
+	template <class Ret, class Fn, std::size_t... idxs>
+	std::optional<Ret> * memo_slot(
+		Suite const & suite, Fn const fn, std::index_sequence<idxs...>) const noexcept
+	{
+		std::optional<Ret> * slot = nullptr;
+		((slot = slot != nullptr ? slot : memo_slot_at<idxs, Ret>(suite, fn)), ...);
+		return slot;
+	}
+
+	template <std::size_t idx, class Ret, class Fn>
+	std::optional<Ret> * memo_slot_at(Suite const & suite, Fn const fn) const noexcept
+	{
+		constexpr auto member = std::get<idx>(std::make_tuple(members...));
+		if constexpr (
+			std::is_same_v<std::decay_t<decltype(member)>, Fn Suite::*> &&
+			std::is_same_v<result<member>, Ret>)
+			return suite.*member == fn ? &std::get<idx>(results_) : nullptr;
+		else
+			return nullptr;
+	}
+
+	mutable std::tuple<std::optional<result<members>>...> results_;
+};
+
+/// No pure functions, so nothing to cache.
+template <class Suite>
+class Memo<Suite, PureFunctions<>>
+{
+protected:
+	static constexpr bool kmemoized = false;
+
+	void invalidate() const noexcept {}
+};
+}  // namespace cppcapi::client::detail
@@ -0,0 +1,204 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Range used by clients to iterate over ranges exposed by a service's cursor suite.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "../interface.h"
+#include "error_buffer.hpp"
+
+namespace cppcapi::client
+{
+/**
+ * Input range over the elements of an open cursor, fetching elements from the service in chunks.
+ *
+ * Each chunk requires a single call to the service, so iterating `N` elements requires
+ * `N / chunk_size + 1` calls. Elements are buffered on the client, so references to them are
+ * invalidated when the iterator is incremented past the end of the current chunk.
+ *
+ * Typically constructed via SuiteAdapter::range. The cursor is closed when the range is destroyed.
+ *
+ * @tparam TCursor Opaque cursor handle type.
+ * @tparam TElement C type of elements.
+ * @tparam TErrorMap ErrorMap detailing mapping of exceptions to error codes.
+ */
+template <class TCursor, class TElement, class TErrorMap>
+class Range
+{
+public:
+	using Cursor = TCursor;
+	using Element = TElement;
+	/// Signature of cursor suite function fetching the next chunk of elements.
+	using NextChunkFn = cppcapi_ErrorCode (*)(
+		cppcapi_ErrorMessage *, std::size_t *, Cursor, Element *, std::size_t);
+	/// Signature of cursor suite function closing the cursor.
+	using CloseFn = void (*)(Cursor);
+
+	static constexpr std::size_t default_chunk_size = 64;
+	static constexpr std::size_t default_error_capacity = detail::error_buffer_capacity;
+
+	/// Input iterator over the elements of the range.
+	class iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Element;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Element const *;
+		using reference = Element const &;
+
+		iterator() = default;
+
+		explicit iterator(Range * range) : range_{range} {}
+
+		reference operator*() const
+		{
+			return range_->chunk_[range_->pos_];
+		}
+
+		pointer operator->() const
+		{
+			return &**this;
+		}
+
+		iterator & operator++()
+		{
+			range_->advance();
+			return *this;
+		}
+
+		void operator++(int)
+		{
+			++*this;
+		}
+
+		/// Iterators compare equal if both are at the end of the range, or neither are.
+		bool operator==(iterator const & other) const
+		{
+			return at_end() == other.at_end();
+		}
+
+		bool operator!=(iterator const & other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		[[nodiscard]] bool at_end() const
+		{
+			return range_ == nullptr || range_->at_end();
+		}
+
+		Range * range_{nullptr};
+	};
+
+	/**
+	 * Construct taking ownership of an open cursor.
+	 *
+	 * @param cursor Open cursor.
+	 * @param next_chunk Cursor suite function fetching the next chunk of elements.
+	 * @param close Cursor suite function closing the cursor.
+	 * @param chunk_size Maximum number of elements to fetch per call to the service.
+	 */
+	Range(
+		Cursor cursor,
+		NextChunkFn next_chunk,
+		CloseFn close,
+		std::size_t const chunk_size = default_chunk_size)
+		: cursor_{cursor}, next_chunk_{next_chunk}, close_{close}, chunk_size_{chunk_size}
+	{
+	}
+
+	Range(Range const &) = delete;
+	Range & operator=(Range const &) = delete;
+
+	Range(Range && other) noexcept
+		: cursor_{std::exchange(other.cursor_, nullptr)},
+		  next_chunk_{other.next_chunk_},
+		  close_{other.close_},
+		  chunk_size_{other.chunk_size_},
+		  chunk_{std::move(other.chunk_)},
+		  pos_{other.pos_},
+		  started_{other.started_},
+		  exhausted_{other.exhausted_}
+	{
+	}
+
+	Range & operator=(Range &&) = delete;
+
+	~Range()
+	{
+		if (cursor_ != nullptr)
+			close_(cursor_);
+	}
+
+	/**
+	 * Get an iterator to the current element, fetching the first chunk if not already fetched.
+	 *
+	 * This is an input range, so can only be iterated once.
+	 */
+	iterator begin()
+	{
+		if (!started_)
+		{
+			started_ = true;
+			fetch();
+		}
+		return iterator{this};
+	}
+
+	iterator end()
+	{
+		return iterator{};
+	}
+
+private:
+	[[nodiscard]] bool at_end() const
+	{
+		return pos_ >= chunk_.size();
+	}
+
+	void advance()
+	{
+		++pos_;
+		if (at_end() && !exhausted_)
+			fetch();
+	}
+
+	void fetch()
+	{
+		cppcapi_ErrorMessage err = detail::error_message();
+		std::size_t count = 0;
+
+		chunk_.resize(chunk_size_);
+		cppcapi_ErrorCode const code =
+			next_chunk_(&err, &count, cursor_, chunk_.data(), chunk_size_);
+		chunk_.resize(count);
+		pos_ = 0;
+		// A short chunk signals the end of the range.
+		exhausted_ = count < chunk_size_;
+
+		if (code != cppcapi_ok)
+		{
+			exhausted_ = true;
+			detail::rethrow_if_passed(err);
+			TErrorMap::throw_exception(err, code, detail::error_payload(err));
+		}
+	}
+
+	Cursor cursor_;
+	NextChunkFn next_chunk_;
+	CloseFn close_;
+	std::size_t chunk_size_;
+	std::vector<Element> chunk_;
+	std::size_t pos_{0};
+	bool started_{false};
+	bool exhausted_{false};
+};
+}  // namespace cppcapi::client
@@ -0,0 +1,181 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Result returned by the non-throwing client API, e.g. SuiteAdapter::try_call.
+ */
+#pragma once
+
+#include <cstring>
+
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "../error_map.hpp"
+#include "../interface.h"
+#include "error_buffer.hpp"
+
+namespace cppcapi::client
+{
+/**
+ * Error code and message of a failed suite function call.
+ */
+struct Error
+{
+	/// Error code, as mapped from the service's exception by the ErrorMap.
+	cppcapi_ErrorCode code;
+	/// Message of the service's exception.
+	std::string message;
+	/// Structured payload of the service's exception, if any, see payload_as.
+	cppcapi_ErrorPayload payload{};
+
+	/// Construct from the error code, message and any payload of a failed call.
+	static Error from(cppcapi_ErrorCode const code, cppcapi_ErrorMessage const & err)
+	{
+		Error error{code, std::string{cppcapi::detail::message_view(err)}};
+		if (auto const * const payload = detail::error_payload(err))
+			error.payload = *payload;
+		return error;
+	}
+
+	/**
+	 * Decode the payload, if written by the service for this error code.
+	 *
+	 * @tparam Payload Trivially copyable payload type, e.g. the `Payload` of the exception mapped
+	 * to this error code.
+	 * @return Decoded payload, or `std::nullopt` if absent or of a different size.
+	 */
+	template <class Payload>
+	[[nodiscard]] std::optional<Payload> payload_as() const noexcept
+	{
+		static_assert(std::is_trivially_copyable_v<Payload>, "Payload must be trivially copyable");
+		if (payload.type != code || payload.size != sizeof(Payload))
+			return std::nullopt;
+		Payload decoded{};
+		std::memcpy(&decoded, payload.data, sizeof(Payload));
+		return decoded;
+	}
+};
+
+/**
+ * Either the result of a successful suite function call or the Error of a failed call, returned
+ * instead of throwing, similar to C++23 `std::expected`.
+ *
+ * @tparam T Type of result.
+ */
+template <class T>
+class Result
+{
+public:
+	using value_type = T;
+
+	// NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+	Result(T value) : storage_{std::in_place_index<0>, std::move(value)} {}
+	// NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+	Result(Error error) : storage_{std::in_place_index<1>, std::move(error)} {}
+
+	/// Whether the call succeeded.
+	[[nodiscard]] bool has_value() const noexcept
+	{
+		return storage_.index() == 0;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return has_value();
+	}
+
+	/**
+	 * Result of the call, which must have succeeded.
+	 *
+	 * @throw std::bad_variant_access if the call failed, or aborts if exceptions are disabled.
+	 */
+	[[nodiscard]] T & value() &
+	{
+		return std::get<0>(storage_);
+	}
+
+	[[nodiscard]] T const & value() const &
+	{
+		return std::get<0>(storage_);
+	}
+
+	[[nodiscard]] T && value() &&
+	{
+		return std::get<0>(std::move(storage_));
+	}
+
+	[[nodiscard]] T & operator*() &
+	{
+		return value();
+	}
+
+	[[nodiscard]] T const & operator*() const &
+	{
+		return value();
+	}
+
+	[[nodiscard]] T * operator->()
+	{
+		return &value();
+	}
+
+	[[nodiscard]] T const * operator->() const
+	{
+		return &value();
+	}
+
+	/// Result of the call if it succeeded, otherwise the given fallback.
+	template <class U>
+	[[nodiscard]] T value_or(U && fallback) const &
+	{
+		return has_value() ? value() : static_cast<T>(std::forward<U>(fallback));
+	}
+
+	/// Error of the call, which must have failed.
+	[[nodiscard]] Error const & error() const
+	{
+		return std::get<1>(storage_);
+	}
+
+private:
+	std::variant<T, Error> storage_;
+};
+
+/**
+ * Success, or the Error of a failed suite function call with no result.
+ */
+template <>
+class Result<void>
+{
+public:
+	using value_type = void;
+
+	/// Successful call.
+	Result() = default;
+	// NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+	Result(Error error) : error_{std::move(error)} {}
+
+	/// Whether the call succeeded.
+	[[nodiscard]] bool has_value() const noexcept
+	{
+		return !error_.has_value();
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return has_value();
+	}
+
+	/// Error of the call, which must have failed.
+	[[nodiscard]] Error const & error() const
+	{
+		return *error_;
+	}
+
+private:
+	std::optional<Error> error_;
+};
+}  // namespace cppcapi::client
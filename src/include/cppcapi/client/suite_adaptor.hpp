@@ -5,14 +5,140 @@
  */
 #pragma once
 
+#include <atomic>
+#include <optional>
 #include <stdexcept>
+#include <tuple>
 
 #include "../error_map.hpp"
 #include "../interface.h"
 #include "../service/handle_manager.hpp"
+#include "call_context.hpp"
+#include "command_buffer.hpp"
+#include "error_buffer.hpp"
+#include "future.hpp"
+#include "memo.hpp"
+#include "range.hpp"
+#include "result.hpp"
+#include "write_buffer.hpp"
 
 namespace cppcapi::client
 {
+namespace detail
+{
+/**
+ * Suite storage for adapters, where each adapter references its own suite.
+ *
+ * Allows adapters of the same handle type to use different suites, e.g. from different plugins,
+ * at the cost of a suite reference per adapter. Adapters are polymorphic, so may be destroyed via
+ * a pointer to their base.
+ *
+ * @tparam Suite Function pointer suite.
+ */
+template <class Suite>
+class InstanceSuite
+{
+public:
+	virtual ~InstanceSuite() = default;
+
+protected:
+	explicit InstanceSuite(Suite const & suite) : suite_{suite} {}
+	InstanceSuite(InstanceSuite const &) = default;
+
+	[[nodiscard]] Suite const & suite() const noexcept
+	{
+		return suite_;
+	}
+
+	/// Function pointer suite associated with the handle, shared by all adapters.
+	Suite const & suite_;
+};
+
+/**
+ * Suite storage for compact adapters, where all adapters of a handle type share a single suite.
+ *
+ * The suite is resolved once, by the first adapter constructed, then held in a static rather
+ * than per adapter. Adapters hold nothing but their handle and have no virtual functions, so an
+ * array of adapters is laid out exactly like an array of raw handles.
+ *
+ * @tparam Suite Function pointer suite.
+ * @tparam Handle Opaque handle type, distinguishing the static suite of each handle type.
+ */
+template <class Suite, class Handle>
+class StaticSuite
+{
+protected:
+	explicit StaticSuite(Suite const & suite)
+	{
+		if (suite_.load(std::memory_order_acquire) != &suite)
+			bind(suite);
+	}
+
+	[[nodiscard]] static Suite const & suite() noexcept
+	{
+		return *suite_.load(std::memory_order_acquire);
+	}
+
+	/// Whether the suite has been resolved.
+	[[nodiscard]] static bool is_bound() noexcept
+	{
+		return suite_.load(std::memory_order_acquire) != nullptr;
+	}
+
+private:
+	static void bind(Suite const & suite)
+	{
+		Suite const * expected = nullptr;
+		if (!suite_.compare_exchange_strong(expected, &suite, std::memory_order_acq_rel) &&
+			expected != &suite)
+			cppcapi::detail::raise<std::logic_error>(
+				"Compact adapters of a handle type must all use the same suite");
+	}
+
+	inline static std::atomic<Suite const *> suite_{nullptr};
+};
+
+/**
+ * Check if a suite has a `retain` function, adding a reference to the instance of a handle.
+ *
+ * SFINAE type. This default means the given suite has no `retain` member.
+ */
+template <typename Suite, typename = void>
+struct has_retain_t : std::false_type
+{
+};
+
+template <typename Suite>
+struct has_retain_t<Suite, decltype(Suite::retain, void())> : std::true_type
+{
+};
+
+/**
+ * Check if a suite has a `clone` function, minting a new handle to the instance of a handle.
+ *
+ * SFINAE type. This default means the given suite has no `clone` member.
+ */
+template <typename Suite, typename = void>
+struct has_clone_t : std::false_type
+{
+};
+
+template <typename Suite>
+struct has_clone_t<Suite, decltype(Suite::clone, void())> : std::true_type
+{
+};
+
+/// Placeholder parameter type, disabling the copy constructor of adapters that can't be copied.
+class NotCopyable
+{
+	NotCopyable() = default;
+};
+
+template <class Suite, class Handle, bool compact>
+using suite_storage_t =
+	std::conditional_t<compact, StaticSuite<Suite, Handle>, InstanceSuite<Suite>>;
+}  // namespace detail
+
 /**
  * Base class for adapters wrapping opaque handles on the client.
  *
@@ -20,11 +146,35 @@ namespace cppcapi::client
  * @tparam TServiceHandleMap HandleMap detailing mapping of handles to instances.
  * @tparam TClientHandleMap HandleMap detailing mapping of handles to wrapper classes.
  * @tparam TErrorMap ErrorMap detailing mapping of exceptions to error codes.
+ * @tparam Tcompact Whether all adapters of the handle type share a single suite, resolved once,
+ * rather than each referencing their own. Compact adapters are the size of a raw handle and are
+ * not polymorphic, see detail::StaticSuite. Subclasses must then use `suite()` rather than
+ * `suite_`.
+ *
+ * If the client HandleTraits declare any PureFunctions, then the adapter caches their results,
+ * see detail::Memo.
+ *
+ * If the handle is registered via WriteBufferedHandleTraits, then the adapter can be bound to a
+ * WriteBuffer that is flushed before any call crosses the boundary, see detail::WriteBinding.
  */
-template <class THandle, class TServiceHandleMap, class TClientHandleMap, class TErrorMap>
+template <
+	class THandle,
+	class TServiceHandleMap,
+	class TClientHandleMap,
+	class TErrorMap,
+	bool Tcompact = false>
 struct SuiteAdapter
+	: detail::suite_storage_t<
+		  typename TClientHandleMap::template suite_from_handle<THandle>,
+		  THandle,
+		  Tcompact>,
+	  detail::Memo<
+		  typename TClientHandleMap::template suite_from_handle<THandle>,
+		  typename TClientHandleMap::template pure_from_handle<THandle>>,
+	  detail::WriteBinding<TClientHandleMap::template write_buffered_from_handle<THandle>()>
 {
-	static constexpr std::size_t default_error_capacity = 500;
+	static constexpr std::size_t default_error_capacity = detail::error_buffer_capacity;
+	static constexpr std::size_t default_chunk_size = 64;
 
 	template <class Handle>
 	using HandleManager =
@@ -32,15 +182,44 @@ struct SuiteAdapter
 
 protected:
 	/// Convenience for referring to this base class in subclasses.
-	using Base = SuiteAdapter<THandle, TServiceHandleMap, TClientHandleMap, TErrorMap>;
+	using Base = SuiteAdapter<THandle, TServiceHandleMap, TClientHandleMap, TErrorMap, Tcompact>;
+	/// Storage of the suite, either per adapter or shared by all adapters of the handle type.
+	using SuiteStorage = detail::suite_storage_t<
+		typename TClientHandleMap::template suite_from_handle<THandle>,
+		THandle,
+		Tcompact>;
+	/// Cache of the results of pure suite functions, empty if there are none.
+	using Memo = detail::Memo<
+		typename TClientHandleMap::template suite_from_handle<THandle>,
+		typename TClientHandleMap::template pure_from_handle<THandle>>;
+	/// Binding to a WriteBuffer, empty unless registered via WriteBufferedHandleTraits.
+	using WriteBinding =
+		detail::WriteBinding<TClientHandleMap::template write_buffered_from_handle<THandle>()>;
 
 public:
 	/// Opaque handle type.
 	using Handle = THandle;
 	/// C function pointer suite associated with the handle.
 	using Suite = typename TClientHandleMap::template suite_from_handle<THandle>;
-	/// Signature of function used to construct a function pointer suite for the handle.
-	using SuiteFactory = Suite (*)();
+	/**
+	 * Signature of function used to get the function pointer suite for the handle.
+	 *
+	 * The returned suite must have static storage duration, typically a `static constexpr` table
+	 * local to the factory, so it can be shared by all adapters without copying.
+	 */
+	using SuiteFactory = Suite const * (*)();
+	/// Result of calling an asynchronous suite function.
+	template <class Ret>
+	using Future = client::Future<Ret, TErrorMap>;
+	/// Buffer of recorded suite function calls for batch execution.
+	template <class Commands>
+	using CommandBuffer = client::CommandBuffer<Commands, TErrorMap>;
+	/// Queue of fire-and-forget suite function calls, flushed to the service in batches.
+	template <class Commands>
+	using WriteBuffer = client::WriteBuffer<Commands, TErrorMap>;
+	/// Range over the elements of a service's cursor.
+	template <class Cursor, class Element>
+	using Range = client::Range<Cursor, Element, TErrorMap>;
 
 protected:
 	/**
@@ -52,6 +231,31 @@ protected:
 	static constexpr SuiteFactory ksuite_factory =
 		TClientHandleMap::template suite_factory_from_handle<THandle>();
 
+	/**
+	 * Whether instances of the handle carry the suite of their dynamic type, in which case
+	 * adapters wrapping an existing handle take their suite from the handle.
+	 *
+	 * See client::DynamicHandleTraits.
+	 */
+	static constexpr bool kdynamic_suite =
+		TClientHandleMap::template dynamic_suite_from_handle<THandle>();
+
+	/**
+	 * Whether adapters can be copied, i.e. the suite has a `retain` or `clone` function that
+	 * gives the copy its own reference to the instance.
+	 */
+	static constexpr bool kcopyable =
+		detail::has_retain_t<Suite>::value || detail::has_clone_t<Suite>::value;
+
+	static_assert(
+		!(Tcompact && kdynamic_suite),
+		"Compact adapters cannot be used with handles carrying the suite of their dynamic type");
+	static_assert(
+		!(Tcompact && TClientHandleMap::template write_buffered_from_handle<THandle>()),
+		"Compact adapters cannot be bound to a write buffer");
+
+	using SuiteStorage::suite;
+
 public:
 	/**
 	 * Construct from a given handle, assuming compile-time known associated function pointer suite.
@@ -60,12 +264,17 @@ public:
 	 * host DSO has already exported the suite factory as a global symbol available immediately on
 	 * loading (linking) the plugin.
 	 *
+	 * If instances of the handle carry the suite of their dynamic type, then that suite is used
+	 * instead, so all subsequent calls dispatch directly to the dynamic type's suite.
+	 *
+	 * Compact adapters without a compile-time known suite factory can use this constructor once
+	 * another adapter of the same type has resolved the suite, e.g. via Loader::load_adapter.
+	 *
 	 * @param handle Opaque handle to service type.
 	 */
 	SuiteAdapter(Handle handle)	 // NOLINT(google-explicit-constructor)
-		: SuiteAdapter{ksuite_factory, handle}
+		: SuiteStorage{suite_of(handle)}, handle_{handle}
 	{
-		static_assert(ksuite_factory != nullptr, "Attempting to construct with null suite factory");
 	}
 
 	/**
@@ -75,8 +284,8 @@ public:
 	 * suite factory has to be queried from the plugin DSO. Once this constructor has been called,
 	 * the subclass should immediately use the suite's `create` function to fill in the null handle.
 	 *
-	 * @param suite_factory Factory function that returns the function pointer suite associated with
-	 * the handle.
+	 * @param suite_factory Factory function that returns a pointer to the function pointer suite
+	 * associated with the handle.
 	 */
 	explicit SuiteAdapter(SuiteFactory suite_factory) : SuiteAdapter{suite_factory, nullptr} {}
 
@@ -84,19 +293,31 @@ public:
 	 * Construct injecting provided opaque handle and associated function pointer suite.
 	 *
 	 * @param handle Opaque handle to service type.
-	 * @param suite_factory Factory function that returns the function pointer suite associated with
-	 * the handle.
+	 * @param suite_factory Factory function that returns a pointer to the function pointer suite
+	 * associated with the handle.
 	 */
 	explicit SuiteAdapter(SuiteFactory suite_factory, Handle handle)
-		: suite_{suite_factory()}, handle_{handle}
+		: SuiteStorage{*suite_factory()}, handle_{handle}
 	{
 	}
 
-	/// It is not safe to copy a handle adapter, since it may lead to use-after-free.
-	SuiteAdapter(SuiteAdapter const &) = delete;
+	/**
+	 * Copy the other adapter, giving the copy its own reference to the instance.
+	 *
+	 * Uses the suite's `retain` function, if any, to add a reference to the instance of the
+	 * shared handle, otherwise its `clone` function to mint a new handle to the same instance.
+	 *
+	 * If the suite has neither, then adapters are move-only, since copying the handle may lead to
+	 * use-after-free.
+	 */
+	SuiteAdapter(std::conditional_t<kcopyable, SuiteAdapter, detail::NotCopyable> const & other)
+		: SuiteStorage{other}, Memo{other}, WriteBinding{other}, handle_{retain_handle(other)}
+	{
+	}
 
 	/// Move the handle from the other adapter and set its handle to null.
-	SuiteAdapter(SuiteAdapter && other) noexcept : suite_{other.suite_}, handle_{other.handle_}
+	SuiteAdapter(SuiteAdapter && other) noexcept
+		: SuiteStorage{other}, Memo{other}, WriteBinding{other}, handle_{other.handle_}
 	{
 		other.handle_ = nullptr;
 	};
@@ -105,8 +326,10 @@ public:
 	 * Call our suite's `release` function, if appropriate.
 	 *
 	 * I.e. Call `release` if the handle is not null and the suite defines a `release` function.
+	 *
+	 * Virtual unless the adapter is compact, via the suite storage base class.
 	 */
-	virtual ~SuiteAdapter()
+	~SuiteAdapter()
 	{
 		if (handle_ == nullptr)
 			return;	 // Assume moved out
@@ -115,7 +338,7 @@ public:
 		// technically it could but should be a no-op, and certainly not try to free memory pointed
 		// to by the handle)
 		if constexpr (has_release_t<Suite>::value)
-			suite_.release(handle_);
+			suite().release(handle_);
 
 		handle_ = nullptr;
 	}
@@ -130,6 +353,37 @@ protected:
 	/// Allow default construction, relying on the subclass to populate the handle.
 	SuiteAdapter() : SuiteAdapter{Handle{nullptr}} {}
 
+	/**
+	 * Get the function pointer suite to use for a handle.
+	 *
+	 * @param handle Opaque handle to service type.
+	 * @return Suite given by the compile-time suite factory, or the suite of the dynamic type of
+	 * the instance if instances of the handle carry one, or the already resolved suite of a compact
+	 * adapter.
+	 */
+	static Suite const & suite_of(Handle handle)
+	{
+		if constexpr (kdynamic_suite)
+		{
+			if (handle == nullptr)
+				cppcapi::detail::raise<std::invalid_argument>(
+					"Cannot get the dynamic suite of a null handle");
+			return *cppcapi::dynamic_suite<Suite>(handle);
+		}
+		else if constexpr (ksuite_factory != nullptr)
+		{
+			return *ksuite_factory();
+		}
+		else
+		{
+			static_assert(Tcompact, "Attempting to construct with null suite factory");
+			if (!SuiteStorage::is_bound())
+				cppcapi::detail::raise<std::logic_error>(
+					"Compact adapter constructed before its suite was resolved");
+			return suite();
+		}
+	}
+
 	/**
 	 * Call our suite's `create` function, updating our opaque handle with the result.
 	 *
@@ -149,14 +403,54 @@ protected:
 	void create(Args &&... args)
 	{
 		if (handle_ != nullptr)
-			throw std::invalid_argument{
-				"Cannot `create` a handle adapter if handle is already assigned."};
-		// TODO: suite_.create is not default initialized (to nullptr).
+			cppcapi::detail::raise<std::invalid_argument>(
+				"Cannot `create` a handle adapter if handle is already assigned.");
+		// TODO: suite().create is not default initialized (to nullptr).
 		//		if (suite_.create == nullptr)
 		//			throw std::invalid_argument{
 		//				"Cannot `create` a handle adapter when no function pointer suite is
 		// assigned."};
-		call(suite_.create, std::forward<Args>(args)...);
+		call(suite().create, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Create a new instance of the associated class, as with `create`, returning any error rather
+	 * than throwing it.
+	 *
+	 * @tparam Args Additional constructor argument types.
+	 * @param args Constructor arguments.
+	 * @return The error, if any.
+	 */
+	template <class... Args>
+	Result<void> try_create(Args &&... args)
+	{
+		if (handle_ != nullptr)
+			return Error{
+				cppcapi_error, "Cannot `create` a handle adapter if handle is already assigned."};
+		return try_call_factory(suite().create, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Call a named constructor suite function, e.g. `create_from_*`, updating our opaque handle
+	 * with the result.
+	 *
+	 * Allows an instance to be constructed fully-formed in a single call, rather than calling
+	 * `create` followed by further initialization calls. Arguments are converted to handles as
+	 * with `call`.
+	 *
+	 * @tparam Factory Type of factory suite function, see
+	 * service::SuiteDecorator::decorate_constructor.
+	 * @tparam Args Constructor argument types.
+	 * @param factory Factory suite function to call.
+	 * @param args Constructor arguments.
+	 */
+	template <class Factory, class... Args>
+	void create_with(Factory factory, Args &&... args)
+	{
+		if (handle_ != nullptr)
+			cppcapi::detail::raise<std::invalid_argument>(
+				"Cannot `create` a handle adapter if handle is already assigned.");
+		call(factory, std::forward<Args>(args)...);
 	}
 
 	/**
@@ -167,6 +461,20 @@ protected:
 	 *
 	 * A non-zero error code is thrown as an exception, as defined by the ErrorMap.
 	 *
+	 * If the suite function takes a `cppcapi_CallContext const *` immediately after the handle,
+	 * then a CallContext can be given as the first of `args`. If omitted, the context made current
+	 * on this thread by a CallContext::Scope (if any) is used.
+	 *
+	 * If the suite function is declared in the client HandleTraits as one of the PureFunctions,
+	 * then its result is cached by this adapter, and subsequent calls return the cached result
+	 * without crossing the boundary. Calling any other suite function via this adapter discards
+	 * all cached results, since the call may mutate the instance. This applies to all overloads
+	 * of `call`, as well as `call_async` and `execute`.
+	 *
+	 * If a WriteBuffer is bound to this adapter, see detail::WriteBinding, then it is flushed
+	 * before crossing the boundary, so the call observes the effects of deferred calls. This
+	 * likewise applies to `try_call`, `call_async`, `execute` and `range`.
+	 *
 	 * @tparam Ret Type of return value (out parameter).
 	 * @tparam Args Additional argument types required by the suite function.
 	 * @tparam Rest Additional argument types given to the suite function.
@@ -179,13 +487,21 @@ protected:
 		cppcapi_ErrorCode (*fn)(cppcapi_ErrorMessage *, Ret *, Handle, Args...),
 		Rest &&... args) const
 	{
-		Ret ret;
-		cppcapi_ErrorCode code;
-		cppcapi_ErrorMessage err{err_storage_.size(), 0, err_storage_.data()};
+		return memoize<Ret>(
+			fn,
+			[&]
+			{
+				this->flush_writes();
+				Ret ret;
+				cppcapi_ErrorCode code;
+				cppcapi_ErrorMessage err = detail::error_message();
 
-		code = fn(&err, &ret, handle_, as_handle<Args>(std::forward<Rest>(args))...);
-		throw_on_error(code, err);
-		return ret;
+				code = convert_and_invoke<Args...>(
+					[&](auto... c_args) { return fn(&err, &ret, handle_, c_args...); },
+					std::forward<Rest>(args)...);
+				throw_on_error(code, err);
+				return ret;
+			});
 	}
 
 	/**
@@ -196,6 +512,8 @@ protected:
 	 *
 	 * A non-zero error code is thrown as an exception, as defined by the ErrorMap.
 	 *
+	 * Any call context is injected as detailed above.
+	 *
 	 * @tparam Args Additional argument types required by the suite function.
 	 * @tparam Rest Additional argument types given to the suite function.
 	 * @param fn Suite function to call.
@@ -205,13 +523,85 @@ protected:
 	void call(
 		cppcapi_ErrorCode (*fn)(cppcapi_ErrorMessage *, Handle, Args...), Rest &&... args) const
 	{
+		this->flush_writes();
 		cppcapi_ErrorCode code;
-		cppcapi_ErrorMessage err{err_storage_.size(), 0, err_storage_.data()};
+		cppcapi_ErrorMessage err = detail::error_message();
 
-		code = fn(&err, handle_, as_handle<Args>(std::forward<Rest>(args))...);
+		this->invalidate();
+		code = convert_and_invoke<Args...>(
+			[&](auto... c_args) { return fn(&err, handle_, c_args...); },
+			std::forward<Rest>(args)...);
 		throw_on_error(code, err);
 	}
 
+	/**
+	 * Call a suite function that has a return value and can error, returning any error rather
+	 * than throwing it.
+	 *
+	 * Avoids the cost of unwinding for errors that are expected, e.g. a key not being found. The
+	 * error code is as mapped by the ErrorMap, but no exception is constructed. Otherwise behaves
+	 * as `call`, including caching the results of pure functions, so long as they succeed.
+	 *
+	 * Errors of deferred calls flushed from a bound WriteBuffer beforehand are still thrown, as a
+	 * FlushError, since they are not errors of this call.
+	 *
+	 * Usable when building without exceptions, see CPPCAPI_EXCEPTIONS.
+	 *
+	 * @tparam Ret Type of return value (out parameter).
+	 * @tparam Args Additional argument types required by the suite function.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param fn Suite function to call.
+	 * @param args Additional arguments given to the suite function.
+	 * @return Value of suite function's out parameter after invocation, or the error.
+	 */
+	template <class Ret, class... Args, class... Rest>
+	Result<Ret> try_call(
+		cppcapi_ErrorCode (*fn)(cppcapi_ErrorMessage *, Ret *, Handle, Args...),
+		Rest &&... args) const
+	{
+		std::optional<Ret> * slot = memo_slot_or_invalidate<Ret>(fn);
+		if (slot != nullptr && slot->has_value())
+			return **slot;
+
+		this->flush_writes();
+		Ret ret;
+		cppcapi_ErrorMessage err = detail::error_message(false);
+		cppcapi_ErrorCode const code = convert_and_invoke<Args...>(
+			[&](auto... c_args) { return fn(&err, &ret, handle_, c_args...); },
+			std::forward<Rest>(args)...);
+		if (code != cppcapi_ok)
+			return Error::from(code, err);
+		if (slot != nullptr)
+			slot->emplace(ret);
+		return ret;
+	}
+
+	/**
+	 * Call a suite function that has no return value but can error, returning any error rather
+	 * than throwing it.
+	 *
+	 * @tparam Args Additional argument types required by the suite function.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param fn Suite function to call.
+	 * @param args Additional arguments given to the suite function.
+	 * @return The error, if any.
+	 */
+	template <class... Args, class... Rest>
+	Result<void> try_call(
+		cppcapi_ErrorCode (*fn)(cppcapi_ErrorMessage *, Handle, Args...), Rest &&... args) const
+	{
+		this->flush_writes();
+		cppcapi_ErrorMessage err = detail::error_message(false);
+
+		this->invalidate();
+		cppcapi_ErrorCode const code = convert_and_invoke<Args...>(
+			[&](auto... c_args) { return fn(&err, handle_, c_args...); },
+			std::forward<Rest>(args)...);
+		if (code != cppcapi_ok)
+			return Error::from(code, err);
+		return {};
+	}
+
 	/**
 	 * Call a suite function that has no return via out-param, and cannot error.
 	 *
@@ -226,7 +616,15 @@ protected:
 	template <class Ret, class... Args, class... Rest>
 	Ret call(Ret (*fn)(Handle, Args...), Rest &&... args) const
 	{
-		return fn(handle_, as_handle<Args>(std::forward<Rest>(args))...);
+		return memoize<Ret>(
+			fn,
+			[&]
+			{
+				this->flush_writes();
+				return convert_and_invoke<Args...>(
+					[&](auto... c_args) { return fn(handle_, c_args...); },
+					std::forward<Rest>(args)...);
+			});
 	}
 
 	/**
@@ -241,9 +639,212 @@ protected:
 	 */
 	void call(void (*fn)(Handle)) const
 	{
+		this->flush_writes();
+		this->invalidate();
 		fn(handle_);
 	}
 
+	/**
+	 * Call an asynchronous suite function that has an out-parameter.
+	 *
+	 * The handle, completion and out-parameter storage are all handled, allowing the caller to just
+	 * provide any additional arguments specific to the given function. Arguments are copied or
+	 * moved into the state of the call, except non-copyable lvalues (e.g. adapters), which must
+	 * outlive the returned Future.
+	 *
+	 * @tparam Ret Type of return value (out parameter).
+	 * @tparam Args Additional argument types required by the suite function.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param options Executor and notification options.
+	 * @param fn Asynchronous suite function to call.
+	 * @param args Additional arguments given to the suite function.
+	 * @return Future providing the value of the out-parameter once complete.
+	 */
+	template <class Ret, class... Args, class... Rest>
+	Future<Ret> call_async(
+		AsyncOptions const & options,
+		void (*fn)(cppcapi_Completion const *, Ret *, Handle, Args...),
+		Rest &&... args) const
+	{
+		this->flush_writes();
+		auto state = cppcapi::make_shared<detail::AsyncCall<Ret, Rest...>>(
+			default_error_capacity, std::forward<Rest>(args)...);
+		cppcapi_Completion const completion =
+			detail::AsyncState<Ret>::make_completion(state, options);
+
+		this->invalidate();
+		std::apply(
+			[&](auto &... kept) { fn(&completion, &state->ret, handle_, as_handle<Args>(kept)...); },
+			state->args);
+
+		return Future<Ret>{std::move(state)};
+	}
+
+	/**
+	 * Call an asynchronous suite function that has no out-parameter.
+	 *
+	 * @see call_async above.
+	 *
+	 * @tparam Args Additional argument types required by the suite function.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param options Executor and notification options.
+	 * @param fn Asynchronous suite function to call.
+	 * @param args Additional arguments given to the suite function.
+	 * @return Future signalling completion.
+	 */
+	template <class... Args, class... Rest>
+	Future<void> call_async(
+		AsyncOptions const & options,
+		void (*fn)(cppcapi_Completion const *, Handle, Args...),
+		Rest &&... args) const
+	{
+		this->flush_writes();
+		auto state = cppcapi::make_shared<detail::AsyncCall<void, Rest...>>(
+			default_error_capacity, std::forward<Rest>(args)...);
+		cppcapi_Completion const completion =
+			detail::AsyncState<void>::make_completion(state, options);
+
+		this->invalidate();
+		std::apply(
+			[&](auto &... kept) { fn(&completion, handle_, as_handle<Args>(kept)...); },
+			state->args);
+
+		return Future<void>{std::move(state)};
+	}
+
+	/// Call an asynchronous suite function with an out-parameter on the default executor.
+	template <class Ret, class... Args, class... Rest>
+	Future<Ret> call_async(
+		void (*fn)(cppcapi_Completion const *, Ret *, Handle, Args...), Rest &&... args) const
+	{
+		return call_async(AsyncOptions{}, fn, std::forward<Rest>(args)...);
+	}
+
+	/// Call an asynchronous suite function with no out-parameter on the default executor.
+	template <class... Args, class... Rest>
+	Future<void> call_async(
+		void (*fn)(cppcapi_Completion const *, Handle, Args...), Rest &&... args) const
+	{
+		return call_async(AsyncOptions{}, fn, std::forward<Rest>(args)...);
+	}
+
+	/**
+	 * Record a call to a suite function into a command buffer, rather than calling it immediately.
+	 *
+	 * The handle, and any out-parameter storage, are injected as with `call`. The recorded call is
+	 * executed later, along with all other commands in the buffer, via CommandBuffer::execute.
+	 *
+	 * @tparam member Pointer to member of our function pointer suite to record a call to.
+	 * @tparam Commands Commands list agreed between client and service.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param buffer Buffer to record into.
+	 * @param args Additional arguments given to the suite function.
+	 * @return Index of the command for functions without an out-parameter, otherwise a
+	 * CommandBuffer::Result providing the out-parameter value after execution.
+	 */
+	template <auto member, class Commands, class... Rest>
+	auto record(CommandBuffer<Commands> & buffer, Rest &&... args) const
+	{
+		return record_impl<member>(buffer, member, std::forward<Rest>(args)...);
+	}
+
+	/**
+	 * Execute all calls recorded in a command buffer in a single call to the service.
+	 *
+	 * @tparam Commands Commands list agreed between client and service.
+	 * @param buffer Buffer of recorded commands.
+	 * @return Error code of the first command that failed, or cppcapi_ok.
+	 */
+	template <class Commands>
+	cppcapi_ErrorCode execute(CommandBuffer<Commands> & buffer) const
+	{
+		this->flush_writes();
+		this->invalidate();
+		return buffer.execute(suite().execute);
+	}
+
+	/**
+	 * Queue a call to a suite function without an out-parameter, to be executed when the queue is
+	 * flushed, rather than calling it immediately.
+	 *
+	 * The queue is flushed once it reaches its threshold, in which case errors of any queued call
+	 * are thrown from here as a FlushError. Arguments are copied or moved into the queue, except
+	 * non-copyable lvalues (e.g. adapters), which must outlive the flush.
+	 *
+	 * @tparam member Pointer to member of our function pointer suite to queue a call to.
+	 * @tparam Commands Commands list agreed between client and service.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param writes Queue of calls.
+	 * @param args Additional arguments given to the suite function.
+	 */
+	template <auto member, class Commands, class... Rest>
+	void defer(WriteBuffer<Commands> & writes, Rest &&... args) const
+	{
+		[[maybe_unused]] auto const index =
+			record<member>(writes.commands(), copy_if_lvalue(std::forward<Rest>(args))...);
+		static_assert(
+			std::is_same_v<decltype(index), std::size_t const>,
+			"Only suite functions without an out-parameter can be deferred");
+		this->invalidate();
+		writes.flush_if_full();
+	}
+
+	/**
+	 * Flush queued calls, then call a suite function, such that it observes their effects.
+	 *
+	 * Typically used for reads of a handle that may have pending deferred calls, where the buffer
+	 * is not bound to the adapter, see detail::WriteBinding.
+	 *
+	 * @tparam Commands Commands list agreed between client and service.
+	 * @tparam Fn Type of suite function.
+	 * @tparam Rest Additional argument types given to the suite function.
+	 * @param writes Queue of calls to flush.
+	 * @param fn Suite function to call.
+	 * @param args Additional arguments given to the suite function.
+	 * @return Result of `call`.
+	 */
+	template <class Commands, class Fn, class... Rest>
+	decltype(auto) call_after(WriteBuffer<Commands> & writes, Fn const fn, Rest &&... args) const
+	{
+		writes.flush();
+		return call(fn, std::forward<Rest>(args)...);
+	}
+
+	/**
+	 * Open a cursor over a range exposed by the service, and wrap it in an input range.
+	 *
+	 * The `open` function is called as with `call`, injecting the handle and any call context.
+	 * Elements are then fetched lazily, in chunks, as the returned range is iterated. The cursor is
+	 * closed when the returned range is destroyed.
+	 *
+	 * @tparam chunk_size Maximum number of elements to fetch per call to the service.
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @tparam Element C type of elements.
+	 * @tparam Args Additional argument types required by the `open` suite function.
+	 * @tparam Rest Additional argument types given to the `open` suite function.
+	 * @param open Suite function opening the cursor.
+	 * @param next_chunk Suite function fetching the next chunk of elements from the cursor.
+	 * @param close Suite function closing the cursor.
+	 * @param args Additional arguments given to the `open` suite function.
+	 * @return Input range over the elements of the cursor.
+	 */
+	template <
+		std::size_t chunk_size = default_chunk_size,
+		class Cursor,
+		class Element,
+		class... Args,
+		class... Rest>
+	Range<Cursor, Element> range(
+		cppcapi_ErrorCode (*open)(cppcapi_ErrorMessage *, Cursor *, Handle, Args...),
+		cppcapi_ErrorCode (*next_chunk)(
+			cppcapi_ErrorMessage *, std::size_t *, Cursor, Element *, std::size_t),
+		void (*close)(Cursor),
+		Rest &&... args) const
+	{
+		return Range<Cursor, Element>{
+			call(open, std::forward<Rest>(args)...), next_chunk, close, chunk_size};
+	}
+
 	/**
 	 * Convert an error code into an exception and throw it.
 	 *
@@ -255,18 +856,14 @@ protected:
 		if (code == cppcapi_ok)
 			return;
 
-		TErrorMap::throw_exception(err, code);
+		detail::rethrow_if_passed(err);
+		TErrorMap::throw_exception(err, code, detail::error_payload(err));
 	}
 
 protected:
-	/// Function pointer suite associated with Handle.
-	Suite const suite_;
 	/// Opaque handle to C++ object in the service.
 	Handle handle_;
 
-	/// Storage for error messages.
-	inline static thread_local auto err_storage_ = std::string(default_error_capacity, '\0');
-
 private:
 	/**
 	 * Check if given type has a `release` member.
@@ -292,13 +889,100 @@ private:
 	{
 	};
 
+	/// Get a new reference to the instance of another adapter, see copy constructor.
+	static Handle retain_handle(SuiteAdapter const & other)
+	{
+		if (other.handle_ == nullptr)
+			return nullptr;
+
+		if constexpr (detail::has_retain_t<Suite>::value)
+		{
+			other.suite().retain(other.handle_);
+			return other.handle_;
+		}
+		else
+		{
+			return other.call(other.suite().clone);
+		}
+	}
+
+	/**
+	 * Invoke a suite function, returning its cached result if it is pure, otherwise discarding
+	 * all cached results.
+	 *
+	 * @tparam Ret Result of the suite function.
+	 * @tparam Fn Type of suite function.
+	 * @tparam Invoke Type of callable invoking the suite function.
+	 * @param fn Suite function, to look up in the pure functions.
+	 * @param invoke Callable invoking the suite function.
+	 * @return Result of the suite function.
+	 */
+	template <class Ret, class Fn, class Invoke>
+	Ret memoize(Fn const fn, Invoke && invoke) const
+	{
+		if constexpr (!std::is_void_v<Ret>)
+		{
+			if (std::optional<Ret> * slot = memo_slot_or_invalidate<Ret>(fn))
+			{
+				if (!slot->has_value())
+					slot->emplace(invoke());
+				return **slot;
+			}
+			return invoke();
+		}
+		else
+		{
+			this->invalidate();
+			return invoke();
+		}
+	}
+
+	/**
+	 * Find the cache of a suite function's result if it is pure, otherwise discard all cached
+	 * results.
+	 *
+	 * @tparam Ret Result of the suite function.
+	 * @tparam Fn Type of suite function.
+	 * @param fn Suite function, to look up in the pure functions.
+	 * @return Storage for the cached result, or `nullptr` if the function is not pure.
+	 */
+	template <class Ret, class Fn>
+	std::optional<Ret> * memo_slot_or_invalidate(Fn const fn) const
+	{
+		if constexpr (Memo::kmemoized)
+		{
+			if (std::optional<Ret> * slot = this->template memo_slot<Ret>(suite(), fn))
+				return slot;
+		}
+		this->invalidate();
+		return nullptr;
+	}
+
+	/// Copy copyable lvalues, so they can be kept alive by a buffer, otherwise forward.
+	template <class Arg>
+	static decltype(auto) copy_if_lvalue(Arg && arg)
+	{
+		using Value = std::decay_t<Arg>;
+		if constexpr (
+			std::is_lvalue_reference_v<Arg> && std::is_class_v<Value> &&
+			std::is_copy_constructible_v<Value>)
+			return Value{arg};
+		else
+			return std::forward<Arg>(arg);
+	}
+
 	template <class ToRef, class FromRef>
 	static constexpr decltype(auto) as_handle(FromRef && obj)
 	{
 		using From = std::decay_t<FromRef>;
 		using To = std::decay_t<ToRef>;
 
-		if constexpr (std::is_constructible_v<To, From> && HandleManager<To>::is_for_client())
+		if constexpr (std::is_same_v<From, CallContext>)
+		{
+			// Call context, which is not a handle but is passed by pointer to its C struct.
+			return obj.get();
+		}
+		else if constexpr (std::is_constructible_v<To, From> && HandleManager<To>::is_for_client())
 		{
 			// Adapter class with (explicit) conversion operator back to handle that it wraps.
 			return static_cast<To>(obj);
@@ -320,11 +1004,79 @@ private:
 		}
 	}
 
+	/**
+	 * Whether a suite function takes a call context as its first additional argument, but the
+	 * caller did not provide one.
+	 *
+	 * @tparam num_given Number of additional arguments given by the caller.
+	 * @tparam Args Additional argument types required by the suite function.
+	 */
+	template <std::size_t num_given, class... Args>
+	static constexpr bool is_call_context_omitted()
+	{
+		if constexpr (sizeof...(Args) != num_given + 1)
+			return false;
+		else
+			return std::is_same_v<
+				std::tuple_element_t<0, std::tuple<Args...>>,
+				cppcapi_CallContext const *>;
+	}
+
+	/**
+	 * Convert arguments to C types and pass them to a callable invoking a suite function.
+	 *
+	 * Injects the current thread's call context if the suite function requires one but none was
+	 * given.
+	 */
+	template <class... Args, class Invoke, class... Rest>
+	static decltype(auto) convert_and_invoke(Invoke && invoke, Rest &&... args)
+	{
+		if constexpr (is_call_context_omitted<sizeof...(Rest), Args...>())
+		{
+			return convert_and_invoke<Args...>(
+				std::forward<Invoke>(invoke), CallContext::current(), std::forward<Rest>(args)...);
+		}
+		else
+		{
+			return invoke(as_handle<Args>(std::forward<Rest>(args))...);
+		}
+	}
+
+	template <auto member, class Commands, class Ret, class... Args, class... Rest>
+	auto record_impl(
+		CommandBuffer<Commands> & buffer,
+		cppcapi_ErrorCode (*Suite::*)(cppcapi_ErrorMessage *, Ret *, Handle, Args...),
+		Rest &&... args) const
+	{
+		Ret * out = buffer.template allocate<Ret>();
+		std::size_t const index = buffer.template append<member>(
+			out, handle_, as_handle<Args>(buffer.keep(std::forward<Rest>(args)))...);
+		return typename CommandBuffer<Commands>::template Result<Ret>{buffer, index, *out};
+	}
+
+	template <auto member, class Commands, class... Args, class... Rest>
+	std::size_t record_impl(
+		CommandBuffer<Commands> & buffer,
+		cppcapi_ErrorCode (*Suite::*)(cppcapi_ErrorMessage *, Handle, Args...),
+		Rest &&... args) const
+	{
+		return buffer.template append<member>(
+			handle_, as_handle<Args>(buffer.keep(std::forward<Rest>(args)))...);
+	}
+
+	template <auto member, class Commands, class... Args, class... Rest>
+	std::size_t record_impl(
+		CommandBuffer<Commands> & buffer, void (*Suite::*)(Handle, Args...), Rest &&... args) const
+	{
+		return buffer.template append<member>(
+			handle_, as_handle<Args>(buffer.keep(std::forward<Rest>(args)))...);
+	}
+
 	template <class... Args, class... Rest>
 	void call(cppcapi_ErrorCode (*fn)(cppcapi_ErrorMessage *, Handle *, Args...), Rest &&... args)
 	{
 		cppcapi_ErrorCode code;
-		cppcapi_ErrorMessage err{err_storage_.size(), 0, err_storage_.data()};
+		cppcapi_ErrorMessage err = detail::error_message();
 
 		code = fn(&err, &handle_, as_handle<Args>(std::forward<Rest>(args))...);
 		throw_on_error(code, err);
@@ -335,5 +1087,26 @@ private:
 	{
 		handle_ = fn(as_handle<Args>(std::forward<Rest>(args))...);
 	}
+
+	template <class... Args, class... Rest>
+	Result<void> try_call_factory(
+		cppcapi_ErrorCode (*fn)(cppcapi_ErrorMessage *, Handle *, Args...), Rest &&... args)
+	{
+		cppcapi_ErrorMessage err = detail::error_message(false);
+
+		cppcapi_ErrorCode const code =
+			fn(&err, &handle_, as_handle<Args>(std::forward<Rest>(args))...);
+		if (code != cppcapi_ok)
+			return Error::from(code, err);
+		return {};
+	}
+
+	/// Factories that cannot error.
+	template <class Factory, class... Args>
+	Result<void> try_call_factory(Factory factory, Args &&... args)
+	{
+		call(factory, std::forward<Args>(args)...);
+		return {};
+	}
 };
 }  // namespace cppcapi::client
\ No newline at end of file
@@ -0,0 +1,243 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the WriteBuffer used by clients to coalesce fire-and-forget suite function calls.
+ */
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "../interface.h"
+#include "command_buffer.hpp"
+
+namespace cppcapi::client
+{
+/**
+ * Error thrown when flushing a WriteBuffer, identifying the first deferred call that failed.
+ *
+ * The exception of the failing call, as defined by the ErrorMap, is nested and can be rethrown
+ * via `std::rethrow_if_nested`.
+ */
+class FlushError : public std::runtime_error
+{
+public:
+	explicit FlushError(std::size_t const index)
+		: std::runtime_error{"Deferred call " + std::to_string(index) + " failed"}, index_{index}
+	{
+	}
+
+	/// Index of the failed call, counting all calls deferred to the buffer since construction.
+	[[nodiscard]] std::size_t index() const noexcept
+	{
+		return index_;
+	}
+
+private:
+	std::size_t index_;
+};
+
+/**
+ * Queue of fire-and-forget suite function calls, flushed to the service in batches.
+ *
+ * Calls without return values are deferred via SuiteAdapter::defer, rather than each crossing to
+ * the service, then executed in a single call when the number of queued calls reaches a
+ * threshold, or `flush` is called explicitly. Reads that depend on deferred calls must be
+ * preceded by a `flush`, either by binding the buffer to the adapter, see
+ * WriteBufferedHandleTraits, or explicitly, see SuiteAdapter::call_after.
+ *
+ * Errors are not thrown by the deferring call, but at flush as a FlushError.
+ *
+ * @tparam TCommands Commands list agreed between client and service.
+ * @tparam TErrorMap ErrorMap detailing mapping of exceptions to error codes.
+ */
+template <class TCommands, class TErrorMap>
+class WriteBuffer
+{
+public:
+	using Commands = TCommands;
+	using Buffer = CommandBuffer<Commands, TErrorMap>;
+	using ExecuteFn = typename Buffer::ExecuteFn;
+
+	static constexpr std::size_t default_threshold = 64;
+
+	/**
+	 * Construct an empty queue.
+	 *
+	 * @param execute_fn Suite function that replays a command buffer.
+	 * @param threshold Number of queued calls that triggers a flush.
+	 */
+	explicit WriteBuffer(
+		ExecuteFn const execute_fn, std::size_t const threshold = default_threshold)
+		: execute_fn_{execute_fn}, threshold_{threshold}
+	{
+	}
+
+	WriteBuffer(WriteBuffer const &) = delete;
+	WriteBuffer(WriteBuffer &&) = delete;
+	WriteBuffer & operator=(WriteBuffer const &) = delete;
+	WriteBuffer & operator=(WriteBuffer &&) = delete;
+
+	/**
+	 * Flush any queued calls, so must be destroyed before the handles they were made with.
+	 *
+	 * Errors cannot be reported from a destructor, so are discarded. Call `flush` explicitly
+	 * beforehand to observe them.
+	 */
+	~WriteBuffer()
+	{
+		if (buffer_.empty())
+			return;
+		try
+		{
+			buffer_.execute(execute_fn_);
+		}
+		catch (...)	 // NOLINT(bugprone-empty-catch)
+		{
+		}
+	}
+
+	/**
+	 * Execute all queued calls in a single call to the service.
+	 *
+	 * All queued calls are executed, even if some fail, and the queue is then emptied.
+	 *
+	 * @throw FlushError if any call failed, nesting the exception of the first to fail.
+	 */
+	void flush()
+	{
+		if (buffer_.empty())
+			return;
+
+		std::size_t const first_index = num_flushed_;
+		num_flushed_ += buffer_.size();
+		cppcapi_ErrorCode code = cppcapi_ok;
+		try
+		{
+			code = buffer_.execute(execute_fn_);
+		}
+		catch (...)
+		{
+			// The buffer as a whole failed, so there is no failed call to identify.
+			buffer_.clear();
+			throw;
+		}
+		if (code == cppcapi_ok)
+		{
+			buffer_.clear();
+			return;
+		}
+
+		std::size_t idx = 0;
+		while (buffer_.code(idx) == cppcapi_ok) ++idx;
+		try
+		{
+			buffer_.throw_on_error(idx);
+		}
+		catch (...)
+		{
+			buffer_.clear();
+			std::throw_with_nested(FlushError{first_index + idx});
+		}
+	}
+
+	/// Number of queued calls.
+	[[nodiscard]] std::size_t size() const
+	{
+		return buffer_.size();
+	}
+
+	/// Whether no calls are queued.
+	[[nodiscard]] bool empty() const
+	{
+		return buffer_.empty();
+	}
+
+	/**
+	 * Underlying buffer that calls are recorded into.
+	 *
+	 * Typically used via SuiteAdapter::defer, rather than directly.
+	 */
+	Buffer & commands()
+	{
+		return buffer_;
+	}
+
+	/// Flush if the number of queued calls has reached the threshold.
+	void flush_if_full()
+	{
+		if (buffer_.size() >= threshold_)
+			flush();
+	}
+
+private:
+	Buffer buffer_;
+	ExecuteFn execute_fn_;
+	std::size_t threshold_;
+	std::size_t num_flushed_{0};
+};
+
+namespace detail
+{
+template <bool enabled>
+class WriteBinding;
+
+/**
+ * Binding of an adapter to a WriteBuffer, flushed before any call via the adapter crosses the
+ * boundary, so reads observe the effects of deferred calls.
+ *
+ * Specialized to be empty unless opted in via WriteBufferedHandleTraits, so costs nothing for
+ * adapters that don't.
+ *
+ * The binding is not synchronized, so must not change whilst the adapter is used concurrently.
+ */
+template <>
+class WriteBinding<true>
+{
+public:
+	/**
+	 * Bind a write buffer, which must outlive the binding, replacing any previous binding.
+	 *
+	 * @param writes Queue of calls to flush before subsequent calls.
+	 */
+	template <class Commands, class ErrorMap>
+	void bind_writes(WriteBuffer<Commands, ErrorMap> & writes) noexcept
+	{
+		writes_ = &writes;
+		flush_ = [](void * data) { static_cast<WriteBuffer<Commands, ErrorMap> *>(data)->flush(); };
+	}
+
+	/// Remove any binding, e.g. before the bound write buffer is destroyed.
+	void unbind_writes() noexcept
+	{
+		writes_ = nullptr;
+	}
+
+protected:
+	/**
+	 * Flush the bound write buffer, if any.
+	 *
+	 * @throw FlushError if any deferred call failed, see WriteBuffer::flush.
+	 */
+	void flush_writes() const
+	{
+		if (writes_ != nullptr)
+			flush_(writes_);
+	}
+
+private:
+	void * writes_{nullptr};
+	void (*flush_)(void *){nullptr};
+};
+
+/// Not opted in to binding a write buffer, so nothing to flush.
+template <>
+class WriteBinding<false>
+{
+protected:
+	void flush_writes() const noexcept {}
+};
+}  // namespace detail
+}  // namespace cppcapi::client
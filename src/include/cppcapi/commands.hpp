@@ -0,0 +1,240 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Commands list used by clients and services to encode/decode command buffers.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "error_map.hpp"
+#include "interface.h"
+
+namespace cppcapi
+{
+namespace detail
+{
+/**
+ * Traits of a function pointer suite member that can be recorded into a command buffer.
+ *
+ * Only suite functions that return nothing, or return an error code alongside a
+ * cppcapi_ErrorMessage first parameter, can be recorded, since there is nowhere to put a return
+ * value. Out-parameters are recorded as pointers.
+ */
+template <class Member>
+struct command_traits
+{
+	static_assert(
+		!std::is_same_v<Member, Member>,
+		"Only suite functions returning void, or cppcapi_ErrorCode given a cppcapi_ErrorMessage, "
+		"can be recorded as commands");
+};
+
+template <class TSuite, class... TParams>
+struct command_traits<void (*TSuite::*)(TParams...)>
+{
+	using Suite = TSuite;
+	using Params = std::tuple<TParams...>;
+	static constexpr bool can_error = false;
+};
+
+template <class TSuite, class... TParams>
+struct command_traits<cppcapi_ErrorCode (*TSuite::*)(cppcapi_ErrorMessage *, TParams...)>
+{
+	using Suite = TSuite;
+	using Params = std::tuple<TParams...>;
+	static constexpr bool can_error = true;
+};
+
+template <auto member, auto... members>
+struct first_member_t
+{
+	using Suite = typename command_traits<decltype(member)>::Suite;
+};
+}  // namespace detail
+
+/**
+ * List of suite functions that can be recorded into, and replayed from, a command buffer.
+ *
+ * The position of a suite function in the list is its opcode, so the same list must be used by
+ * both client and service, i.e. it is part of the C interface.
+ *
+ * @tparam members Pointers to members of the function pointer suite, e.g. `&MySuite::my_func`.
+ */
+template <auto... members>
+struct Commands
+{
+	static_assert(sizeof...(members) > 0, "Command list must not be empty");
+
+	/// Function pointer suite that the commands belong to.
+	using Suite = typename detail::first_member_t<members...>::Suite;
+
+	static_assert(
+		(std::is_same_v<Suite, typename detail::command_traits<decltype(members)>::Suite> && ...),
+		"All commands must belong to the same function pointer suite");
+
+	/// Number of commands in the list.
+	static constexpr std::size_t size = sizeof...(members);
+
+	/**
+	 * Get the opcode of a suite function, i.e. its index in the list.
+	 *
+	 * @tparam member Pointer to member of the function pointer suite.
+	 * @return Opcode.
+	 */
+	template <auto member>
+	static constexpr std::uint32_t opcode()
+	{
+		constexpr std::array<bool, size> matches{is_same_member<member, members>()...};
+		for (std::size_t idx = 0; idx < size; ++idx)
+			if (matches[idx])
+				return static_cast<std::uint32_t>(idx);
+		throw std::logic_error{"Suite function is not in the command list"};
+	}
+
+	/**
+	 * Append a command to a byte buffer.
+	 *
+	 * @tparam member Pointer to member of the function pointer suite.
+	 * @param data Buffer to append to.
+	 * @param args Arguments to the suite function, excluding any leading error message.
+	 */
+	template <auto member, class... Args>
+	static void encode(std::vector<unsigned char> & data, Args const... args)
+	{
+		using Params = typename detail::command_traits<decltype(member)>::Params;
+		static_assert(
+			std::is_same_v<Params, std::tuple<Args...>>,
+			"Command arguments must exactly match the suite function parameters");
+		static_assert(
+			(std::is_trivially_copyable_v<Args> && ...),
+			"Command arguments must be trivially copyable C types");
+
+		constexpr std::uint32_t opcode_value = opcode<member>();
+		cppcapi_CommandHeader const header{
+			opcode_value, static_cast<unsigned int>((sizeof(Args) + ... + 0))};
+
+		std::size_t offset = data.size();
+		data.resize(offset + sizeof(header) + header.size);
+		std::memcpy(data.data() + offset, &header, sizeof(header));
+		offset += sizeof(header);
+		((std::memcpy(data.data() + offset, &args, sizeof(Args)), offset += sizeof(Args)), ...);
+	}
+
+	/**
+	 * Replay each command in a buffer against the given function pointer suite.
+	 *
+	 * All commands are executed in order, regardless of whether previous commands failed. Error
+	 * messages of failed commands are packed into `err`, with their location stored in the
+	 * corresponding result.
+	 *
+	 * @param suite Function pointer suite to dispatch to.
+	 * @param err Storage for error messages.
+	 * @param results Array of `buffer.count` results to populate.
+	 * @param buffer Commands to execute.
+	 * @return Error code of the first command to fail, or cppcapi_ok. If the buffer is malformed
+	 * then cppcapi_error is returned and `err` holds a single message.
+	 */
+	static cppcapi_ErrorCode execute(
+		Suite const & suite,
+		cppcapi_ErrorMessage & err,
+		cppcapi_CommandResult * results,
+		cppcapi_CommandBuffer const & buffer) noexcept
+	{
+		static constexpr std::array<Invoker, size> invokers{&invoke<members>...};
+
+		cppcapi_ErrorCode first_code = cppcapi_ok;
+		std::size_t message_offset = 0;
+		std::size_t data_offset = 0;
+
+		for (std::size_t idx = 0; idx < buffer.count; ++idx)
+		{
+			cppcapi_CommandHeader header;
+			if (buffer.size - data_offset < sizeof(header))
+				return malformed(err);
+			std::memcpy(&header, buffer.data + data_offset, sizeof(header));
+			data_offset += sizeof(header);
+			if (header.opcode >= size || buffer.size - data_offset < header.size)
+				return malformed(err);
+
+			// Give each command the remaining error message storage.
+			char overflow = '\0';
+			std::size_t const remaining = err.capacity - message_offset;
+			cppcapi_ErrorMessage command_err{
+				remaining ? remaining : 1, 0, remaining ? err.data + message_offset : &overflow};
+
+			cppcapi_ErrorCode const code =
+				invokers[header.opcode](suite, command_err, buffer.data + data_offset);
+			data_offset += header.size;
+
+			results[idx] = {code, message_offset, 0};
+			if (code == cppcapi_ok)
+				continue;
+
+			if (first_code == cppcapi_ok)
+				first_code = code;
+			if (remaining)
+			{
+				results[idx].message_size = command_err.size;
+				message_offset += std::min(command_err.size + 1, remaining);
+			}
+		}
+		return first_code;
+	}
+
+private:
+	using Invoker =
+		cppcapi_ErrorCode (*)(Suite const &, cppcapi_ErrorMessage &, unsigned char const *);
+
+	template <auto lhs, auto rhs>
+	static constexpr bool is_same_member()
+	{
+		if constexpr (std::is_same_v<decltype(lhs), decltype(rhs)>)
+			return lhs == rhs;
+		else
+			return false;
+	}
+
+	/// Decode the arguments of a single command and call the corresponding suite function.
+	template <auto member>
+	static cppcapi_ErrorCode invoke(
+		Suite const & suite, cppcapi_ErrorMessage & err, unsigned char const * data)
+	{
+		using Traits = detail::command_traits<decltype(member)>;
+		typename Traits::Params args;
+
+		std::apply(
+			[&data](auto &... arg)
+			{ ((std::memcpy(&arg, data, sizeof(arg)), data += sizeof(arg)), ...); },
+			args);
+
+		return std::apply(
+			[&suite, &err](auto... arg)
+			{
+				if constexpr (Traits::can_error)
+				{
+					return (suite.*member)(&err, arg...);
+				}
+				else
+				{
+					(suite.*member)(arg...);
+					return cppcapi_ok;
+				}
+			},
+			args);
+	}
+
+	static cppcapi_ErrorCode malformed(cppcapi_ErrorMessage & err) noexcept
+	{
+		detail::static_message(err, "Malformed command buffer");
+		return cppcapi_error;
+	}
+};
+}  // namespace cppcapi
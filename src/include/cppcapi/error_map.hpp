@@ -6,13 +6,35 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
 
+#include <array>
+#include <exception>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+
+#include "abi.hpp"
 #include "interface.h"
 
+/**
+ * Whether exceptions are enabled, i.e. not compiling with `-fno-exceptions`.
+ *
+ * Clients can be built without exceptions, so long as they only use the non-throwing API, e.g.
+ * client::SuiteAdapter::try_call. Any error that would otherwise be thrown aborts instead.
+ * Services always require exceptions.
+ */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define CPPCAPI_EXCEPTIONS 1
+#else
+#define CPPCAPI_EXCEPTIONS 0
+#endif
+
 namespace cppcapi
 {
 
@@ -20,11 +42,17 @@ namespace cppcapi
  * Traits mapping an exception class to error code.
  *
  * @tparam TException Exception class.
- * @tparam Tcode Error code.
+ * @tparam Tcode Error code. Must not be one of the codes reserved for success, cancellation or
+ * deadlines, which every ErrorMap maps to its own exceptions.
  */
 template <class TException, cppcapi_ErrorCode Tcode>
 struct ErrorTraits
 {
+	static_assert(Tcode != cppcapi_ok, "Error code cppcapi_ok cannot be mapped to an exception");
+	static_assert(
+		Tcode != cppcapi_cancelled && Tcode != cppcapi_deadline_exceeded,
+		"Error codes cppcapi_cancelled and cppcapi_deadline_exceeded are reserved");
+
 	using Exception = TException;
 	static constexpr cppcapi_ErrorCode code = Tcode;
 };
@@ -37,6 +65,23 @@ struct UnknownError : std::runtime_error
 	using runtime_error::runtime_error;
 };
 
+/**
+ * Exception signalling a call was cancelled, mapped to cppcapi_cancelled by every ErrorMap.
+ */
+struct Cancelled : std::runtime_error
+{
+	using runtime_error::runtime_error;
+};
+
+/**
+ * Exception signalling the deadline of a call passed, mapped to cppcapi_deadline_exceeded by every
+ * ErrorMap.
+ */
+struct DeadlineExceeded : std::runtime_error
+{
+	using runtime_error::runtime_error;
+};
+
 /**
  * Utility to extract the type/code of an exception.
  *
@@ -52,59 +97,389 @@ struct ErrorMap;
  */
 namespace detail
 {
+/**
+ * Throw an exception, or abort if exceptions are disabled.
+ *
+ * @tparam Exception Type of exception to throw.
+ * @tparam Args Constructor argument types.
+ * @param args Constructor arguments.
+ */
+template <class Exception, class... Args>
+[[noreturn]] void raise([[maybe_unused]] Args &&... args)
+{
+#if CPPCAPI_EXCEPTIONS
+	throw Exception{std::forward<Args>(args)...};
+#else
+	std::abort();
+#endif
+}
+
+/**
+ * Exception whose message is referenced by the last status-only error message on this thread.
+ *
+ * Keeps the exception alive after it has been caught, so that the client can read its message
+ * after the call returns, see cppcapi_ErrorMessage.
+ */
+inline std::exception_ptr & pinned_exception() noexcept
+{
+	thread_local std::exception_ptr exception;
+	return exception;
+}
 
 inline void extract_message(cppcapi_ErrorMessage & err, const std::string_view msg) noexcept
 {
+	if (err.capacity == 0)
+		return;
 	err.size = std::min(msg.size(), err.capacity);
 	strncpy(err.data, msg.data(), err.size);
 	err.data[err.capacity - 1] = '\0';
 }
 
+/// Reference or copy a message with static storage duration, e.g. a string literal.
+inline void static_message(cppcapi_ErrorMessage & err, char const * msg) noexcept
+{
+	if (err.capacity == 0)
+		err.data = const_cast<char *>(msg);	 // NOLINT(cppcoreguidelines-pro-type-const-cast)
+	else
+		extract_message(err, msg);
+}
+
+/// Must be called from within the handler catching `ex`.
 inline void extract_exception_message(
 	cppcapi_ErrorMessage & err, std::exception const & ex) noexcept
 {
+	if (err.capacity == 0)
+	{
+		pinned_exception() = std::current_exception();
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		err.data = const_cast<char *>(ex.what());
+		return;
+	}
 	extract_message(err, ex.what());
 }
 
 inline void non_exception_message(cppcapi_ErrorMessage & err) noexcept
 {
-	extract_message(err, "Unknown non-exception error caught");
+	static_message(err, "Unknown non-exception error caught");
 }
 
+/**
+ * Payload storage following the message buffer, if the client requested a payload.
+ *
+ * Must be called before the message is extracted, since that overwrites `size`.
+ */
+inline cppcapi_ErrorPayload * requested_payload(cppcapi_ErrorMessage const & err) noexcept
+{
+	if (err.capacity == 0 ||
+		(err.size != cppcapi_error_payload_requested &&
+		 err.size != cppcapi_error_exception_requested))
+		return nullptr;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	return reinterpret_cast<cppcapi_ErrorPayload *>(err.data + err.capacity);
+}
+
+/**
+ * Whether an exception carries a structured payload.
+ *
+ * Such an exception has a nested trivially copyable `Payload` type, a `noexcept` `payload()`
+ * accessor, and is constructible from a message and a `Payload`.
+ */
+template <class Exception, class = void>
+struct has_payload : std::false_type
+{
+};
+
+template <class Exception>
+struct has_payload<
+	Exception,
+	std::void_t<typename Exception::Payload, decltype(std::declval<Exception const &>().payload())>>
+	: std::true_type
+{
+};
+
+template <class Exception>
+inline constexpr bool has_payload_v = has_payload<Exception>::value;
+
+/// Copy the payload of an exception, tagged by the code of its ErrorTraits.
 template <class ExceptionAndCode>
-void throw_if_matches(cppcapi_ErrorMessage const & err, cppcapi_ErrorCode const code)
+void write_payload(
+	cppcapi_ErrorPayload * const out, typename ExceptionAndCode::Exception const & ex) noexcept
 {
-	if (code == ExceptionAndCode::code)
+	using Exception = typename ExceptionAndCode::Exception;
+	if constexpr (has_payload_v<Exception>)
 	{
-		using Exception = typename ExceptionAndCode::Exception;
+		using Payload = typename Exception::Payload;
+		static_assert(std::is_trivially_copyable_v<Payload>, "Payload must be trivially copyable");
+		static_assert(
+			sizeof(Payload) <= CPPCAPI_ERROR_PAYLOAD_CAPACITY,
+			"Payload must fit in CPPCAPI_ERROR_PAYLOAD_CAPACITY bytes");
+		static_assert(noexcept(ex.payload()), "Exception::payload() must be noexcept");
+
+		if (out == nullptr)
+			return;
+		Payload const payload = ex.payload();
+		std::memcpy(out->data, &payload, sizeof(Payload));
+		out->size = sizeof(Payload);
+		out->type = ExceptionAndCode::code;
+	}
+}
+
+/**
+ * Decode the payload of a failed call, if it was written for the given ErrorTraits.
+ *
+ * @return Decoded payload, or a value-initialised payload if absent, e.g. the service predates
+ * payloads.
+ */
+template <class ExceptionAndCode>
+auto read_payload(cppcapi_ErrorPayload const * const payload) noexcept
+{
+	using Payload = typename ExceptionAndCode::Exception::Payload;
+	Payload decoded{};
+	if (payload != nullptr && payload->type == ExceptionAndCode::code &&
+		payload->size == sizeof(Payload))
+		std::memcpy(&decoded, payload->data, sizeof(Payload));
+	return decoded;
+}
+
+/**
+ * Pass an exception as-is, if negotiated and requested, otherwise extract its message.
+ *
+ * Must be called from within the handler catching `ex`.
+ *
+ * @return Storage for any structured payload of the exception, or `nullptr` if not requested or
+ * the exception was passed as-is.
+ */
+inline cppcapi_ErrorPayload * capture_exception(
+	cppcapi_ErrorMessage & err, std::exception const & ex) noexcept
+{
+	cppcapi_ErrorPayload * const payload = requested_payload(err);
+	if (pass_exception(err, payload))
+		return nullptr;
+	extract_exception_message(err, ex);
+	return payload;
+}
+
+/**
+ * View of the message of a failed call, reading it from the service only if the call was
+ * status-only.
+ */
+inline std::string_view message_view(cppcapi_ErrorMessage const & err) noexcept
+{
+	if (err.size == cppcapi_error_payload_requested ||
+		err.size == cppcapi_error_exception_requested)
+		// Service didn't write a message.
+		return {};
+	if (err.capacity != 0)
+		return {err.data, err.size};
+	return err.data == nullptr ? std::string_view{} : std::string_view{err.data};
+}
+
+/**
+ * Throw the exception of the given ErrorTraits, constructed with the message of a failed call,
+ * and its payload if the exception has one.
+ */
+template <class ExceptionAndCode>
+[[noreturn]] void throw_as(
+	cppcapi_ErrorMessage const & err, cppcapi_ErrorPayload const * const payload = nullptr)
+{
+	using Exception = typename ExceptionAndCode::Exception;
 
+	if constexpr (has_payload_v<Exception>)
+	{
+		static_assert(
+			std::is_constructible_v<Exception, std::string, typename Exception::Payload>,
+			"Exception with a payload must be constructible from a std::string and its Payload");
+		raise<Exception>(
+			std::string{message_view(err)}, read_payload<ExceptionAndCode>(payload));
+	}
+	else
+	{
 		static_assert(
 			std::is_constructible_v<Exception, std::string> || std::is_constructible_v<Exception>,
 			"Exception type must be either default constructible or constructible from a "
 			"std::string");
 
 		if constexpr (std::is_constructible_v<Exception, std::string>)
+			raise<Exception>(std::string{message_view(err)});
+		else
+			raise<Exception>();
+	}
+}
+
+template <class ExceptionAndCode>
+void throw_if_matches(
+	cppcapi_ErrorMessage const & err,
+	cppcapi_ErrorCode const code,
+	cppcapi_ErrorPayload const * const payload = nullptr)
+{
+	if (code == ExceptionAndCode::code)
+		throw_as<ExceptionAndCode>(err, payload);
+}
+
+/**
+ * Compile-time table mapping error codes to the function throwing the associated exception.
+ *
+ * If the codes are dense, then the table is indexed directly by code, otherwise it is sorted by
+ * code and binary searched. Where several ErrorTraits share a code, the first takes precedence.
+ *
+ * @tparam ExceptionsAndCodes List of ErrorTraits.
+ */
+template <class... ExceptionsAndCodes>
+class ThrowerTable
+{
+public:
+	using Thrower = void (*)(cppcapi_ErrorMessage const &, cppcapi_ErrorPayload const *);
+
+	/**
+	 * Find the thrower associated with an error code.
+	 *
+	 * @param code Error code.
+	 * @return Thrower, or `nullptr` if the code is not mapped.
+	 */
+	static constexpr Thrower find(cppcapi_ErrorCode const code) noexcept
+	{
+		if constexpr (kdense)
 		{
-			throw Exception{{err.data, err.size}};
+			// Codes below the minimum wrap around to large indices.
+			auto const idx = static_cast<std::size_t>(static_cast<long long>(code) - kmin);
+			return idx < kdirect.size() ? kdirect[idx] : nullptr;
 		}
-		else if constexpr (std::is_constructible_v<Exception>)
+		else
 		{
-			throw Exception{};
+			std::size_t lo = 0;
+			std::size_t hi = ksorted.size();
+			while (lo < hi)
+			{
+				std::size_t const mid = lo + (hi - lo) / 2;
+				if (ksorted[mid].code < code)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return lo < ksorted.size() && ksorted[lo].code == code ? ksorted[lo].thrower : nullptr;
 		}
 	}
+
+private:
+	struct Entry
+	{
+		cppcapi_ErrorCode code;
+		Thrower thrower;
+	};
+
+	static constexpr std::size_t ksize = sizeof...(ExceptionsAndCodes);
+
+	/// Entries sorted by code, via a stable insertion sort so that the first of duplicates wins.
+	static constexpr std::array<Entry, ksize> sort_entries()
+	{
+		std::array<Entry, ksize> entries{
+			{Entry{ExceptionsAndCodes::code, &throw_as<ExceptionsAndCodes>}...}};
+		for (std::size_t idx = 1; idx < ksize; ++idx)
+		{
+			Entry const entry = entries[idx];
+			std::size_t pos = idx;
+			for (; pos > 0 && entries[pos - 1].code > entry.code; --pos)
+				entries[pos] = entries[pos - 1];
+			entries[pos] = entry;
+		}
+		return entries;
+	}
+
+	static constexpr std::array<Entry, ksize> ksorted = sort_entries();
+	static constexpr long long kmin = ksize ? ksorted.front().code : 0;
+	static constexpr long long kspan = ksize ? ksorted.back().code - kmin + 1 : 0;
+	/// Codes are dense enough that a directly indexed table is not much larger than the entries.
+	static constexpr bool kdense = kspan <= static_cast<long long>(4 * ksize + 16);
+
+	static constexpr auto make_direct()
+	{
+		std::array<Thrower, kdense ? static_cast<std::size_t>(kspan) : 0> direct{};
+		if constexpr (kdense)
+		{
+			for (Entry const & entry : ksorted)
+			{
+				auto & slot = direct[static_cast<std::size_t>(entry.code - kmin)];
+				if (slot == nullptr)
+					slot = entry.thrower;
+			}
+		}
+		return direct;
+	}
+
+	static constexpr auto kdirect = make_direct();
+};
+
+/// Set the error code, and write the payload, if the exception matches the ErrorTraits.
+template <class ExceptionAndCode>
+bool match_as(
+	std::exception const & ex,
+	cppcapi_ErrorCode & code,
+	cppcapi_ErrorPayload * const payload) noexcept
+{
+	auto const * const matched = dynamic_cast<typename ExceptionAndCode::Exception const *>(&ex);
+	if (matched == nullptr)
+		return false;
+	code = ExceptionAndCode::code;
+	write_payload<ExceptionAndCode>(payload, *matched);
+	return true;
 }
 
-template <class Outer, class Inner>
-static decltype(auto) decorate(Outer && outer, Inner && inner)
+template <class Traits, std::size_t... idxs>
+cppcapi_ErrorCode match_code(
+	std::exception const & ex,
+	cppcapi_ErrorPayload * const payload,
+	std::index_sequence<idxs...>) noexcept
 {
-	return [&outer, &inner] { return outer(std::forward<Inner>(inner)); };
+	cppcapi_ErrorCode code = cppcapi_error;
+	(match_as<std::tuple_element_t<sizeof...(idxs) - 1 - idxs, Traits>>(ex, code, payload) || ...);
+	return code;
 }
 
-template <class Outer, class... Inners>
-static decltype(auto) decorate(Outer && outer, Inners &&... inners)
+/**
+ * Find the error code of the ErrorTraits matching an exception.
+ *
+ * Checks each exception type in a single flat sequence, rather than via nested handlers. Later
+ * ErrorTraits take precedence, consistent with nested handlers where the last is innermost.
+ *
+ * @tparam ExceptionsAndCodes List of ErrorTraits.
+ * @param ex Exception to match.
+ * @param payload Storage for the payload of the matching exception, if requested, else `nullptr`.
+ * @return Error code of the matching ErrorTraits, or cppcapi_error if none match.
+ */
+template <class... ExceptionsAndCodes>
+cppcapi_ErrorCode match_code(
+	std::exception const & ex, cppcapi_ErrorPayload * const payload = nullptr) noexcept
 {
-	return [&outer, &inners...] { return outer(decorate(std::forward<Inners>(inners)...)); };
+	return match_code<std::tuple<ExceptionsAndCodes...>>(
+		ex, payload, std::index_sequence_for<ExceptionsAndCodes...>{});
 }
+
+/**
+ * Execute a callable, converting call-aborting exceptions to their reserved error codes.
+ *
+ * Used as the innermost handler of all ErrorMaps, so that these codes take precedence over any
+ * user-provided ErrorTraits matching a base class.
+ */
+template <typename Fn>
+cppcapi_ErrorCode call_abortable(cppcapi_ErrorMessage & err, Fn && fn)
+{
+	try
+	{
+		fn();
+	}
+	catch (Cancelled const & ex)
+	{
+		extract_exception_message(err, ex);
+		return cppcapi_cancelled;
+	}
+	catch (DeadlineExceeded const & ex)
+	{
+		extract_exception_message(err, ex);
+		return cppcapi_deadline_exceeded;
+	}
+	return cppcapi_ok;
+}
+
 }  // namespace detail
 
 /**
@@ -133,30 +508,37 @@ struct ErrorMap<>
 	{
 		try
 		{
-			fn();
+			return detail::call_abortable(err, std::forward<Fn>(fn));
 		}
 		catch (std::exception const & ex)
 		{
-			detail::extract_exception_message(err, ex);
+			detail::capture_exception(err, ex);
 			return cppcapi_error;
 		}
-		return cppcapi_ok;
 	}
 
 	/**
 	 * Throw exception if given error code matches.
 	 *
-	 * This default implementation throws UnknownError with given message if code is anything
-	 * other than cppcapi_ok.
+	 * This default implementation throws Cancelled or DeadlineExceeded for their reserved codes,
+	 * otherwise UnknownError with given message if code is anything other than cppcapi_ok.
 	 *
 	 * @param err Storage for error message.
 	 * @param code Error code.
+	 * @param payload Payload of the error, unused since no exception here has a payload.
 	 */
 	static constexpr void throw_exception(
-		cppcapi_ErrorMessage const & err, cppcapi_ErrorCode const code)
+		cppcapi_ErrorMessage const & err,
+		cppcapi_ErrorCode const code,
+		[[maybe_unused]] cppcapi_ErrorPayload const * const payload = nullptr)
 	{
-		if (code != cppcapi_ok)
-			throw UnknownError{{err.data, err.size}};
+		if (code == cppcapi_ok)
+			return;
+		if (code == cppcapi_cancelled)
+			detail::raise<Cancelled>(std::string{detail::message_view(err)});
+		if (code == cppcapi_deadline_exceeded)
+			detail::raise<DeadlineExceeded>(std::string{detail::message_view(err)});
+		detail::raise<UnknownError>(std::string{detail::message_view(err)});
 	};
 };
 
@@ -186,16 +568,16 @@ struct ErrorMap<ExceptionAndCode>
 	{
 		try
 		{
-			fn();
+			return detail::call_abortable(err, std::forward<Fn>(fn));
 		}
 		catch (typename ExceptionAndCode::Exception const & ex)
 		{
-			detail::extract_exception_message(err, ex);
+			detail::write_payload<ExceptionAndCode>(detail::capture_exception(err, ex), ex);
 			return ExceptionAndCode::code;
 		}
 		catch (std::exception const & ex)
 		{
-			detail::extract_exception_message(err, ex);
+			detail::capture_exception(err, ex);
 			return cppcapi_error;
 		}
 		catch (...)
@@ -203,7 +585,6 @@ struct ErrorMap<ExceptionAndCode>
 			detail::non_exception_message(err);
 			return cppcapi_error;
 		}
-		return cppcapi_ok;
 	}
 
 	/**
@@ -213,11 +594,14 @@ struct ErrorMap<ExceptionAndCode>
 	 *
 	 * @param err Storage for error message.
 	 * @param code Error code.
+	 * @param payload Payload of the error, if requested, else `nullptr`.
 	 */
 	static constexpr void throw_exception(
-		cppcapi_ErrorMessage const & err, cppcapi_ErrorCode const code)
+		cppcapi_ErrorMessage const & err,
+		cppcapi_ErrorCode const code,
+		cppcapi_ErrorPayload const * const payload = nullptr)
 	{
-		detail::throw_if_matches<ExceptionAndCode>(err, code);
+		detail::throw_if_matches<ExceptionAndCode>(err, code, payload);
 		ErrorMap<>::throw_exception(err, code);
 	};
 };
@@ -237,8 +621,10 @@ struct ErrorMap
 	 * Execute a callable and return cppcapi_ok, converting any thrown exception to an error code
 	 * and message.
 	 *
-	 * Recursively decorates the callable with an exception handler for each of the provided
-	 * ExceptionsAndCodes.
+	 * A single handler catches the exception and matches its type against each of the provided
+	 * ExceptionsAndCodes in turn, rather than nesting a handler per ExceptionsAndCodes. If an
+	 * exception matches several, e.g. both a base and derived class, then the last takes
+	 * precedence.
 	 *
 	 * @tparam Fn Callable type to execute.
 	 * @param err Storage for error message.
@@ -248,32 +634,17 @@ struct ErrorMap
 	template <typename Fn>
 	static cppcapi_ErrorCode wrap_exception(cppcapi_ErrorMessage & err, Fn && fn)
 	{
+		static_assert(
+			(std::is_base_of_v<std::exception, typename ExceptionsAndCodes::Exception> && ...),
+			"Mapped exceptions must derive from std::exception");
 		try
 		{
-			return detail::decorate(
-				[&err](auto && wrapped)
-				{
-					try
-					{
-						return wrapped();
-					}
-					catch (typename ExceptionsAndCodes::Exception const & ex)
-					{
-						detail::extract_exception_message(err, ex);
-						return ExceptionsAndCodes::code;
-					}
-				}...,
-				[&fn]
-				{
-					fn();
-					return cppcapi_ok;
-				})();
+			return detail::call_abortable(err, std::forward<Fn>(fn));
 		}
-		// Fallthrough catch-all if no ExceptionsAndCodes matches.
 		catch (std::exception const & ex)
 		{
-			detail::extract_exception_message(err, ex);
-			return cppcapi_error;
+			cppcapi_ErrorPayload * const payload = detail::capture_exception(err, ex);
+			return detail::match_code<ExceptionsAndCodes...>(ex, payload);
 		}
 		catch (...)
 		{
@@ -285,21 +656,26 @@ struct ErrorMap
 	/**
 	 * Throw exception if given error code matches.
 	 *
-	 * Will attempt to match against each of the ErrorTraits in turn, before falling back to the
-	 * default ErrorMap<> handler.
+	 * Looks up the code in a compile-time table of the ErrorTraits, so takes constant (or
+	 * logarithmic, if codes are sparse) time regardless of the number of ErrorTraits. If several
+	 * ErrorTraits share a code, then the first takes precedence. Falls back to the default
+	 * ErrorMap<> handler if the code is not found.
 	 *
 	 * @param err Storage for error message.
 	 * @param code Error code.
+	 * @param payload Payload of the error, if requested, else `nullptr`.
 	 */
 	static constexpr void throw_exception(
-		cppcapi_ErrorMessage const & err, cppcapi_ErrorCode const code)
+		cppcapi_ErrorMessage const & err,
+		cppcapi_ErrorCode const code,
+		cppcapi_ErrorPayload const * const payload = nullptr)
 	{
 		if (code == cppcapi_ok)
 			return;
 
-		(detail::throw_if_matches<ExceptionsAndCodes>(err, code),
-		 ...,
-		 ErrorMap<>::throw_exception(err, code));
+		if (auto const thrower = detail::ThrowerTable<ExceptionsAndCodes...>::find(code))
+			thrower(err, payload);
+		ErrorMap<>::throw_exception(err, code);
 	};
 };
 }  // namespace cppcapi
@@ -0,0 +1,323 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains instrumentation policies used by services to gather suite function call statistics.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "error_map.hpp"
+#include "interface.h"
+#include "metadata.hpp"
+
+namespace cppcapi
+{
+/**
+ * Instrumentation policy that gathers nothing.
+ *
+ * This is the default policy, under which decorated suite functions are identical to
+ * uninstrumented ones.
+ */
+struct NullInstrumentation
+{
+	static constexpr bool enabled = false;
+};
+
+/**
+ * Instrumentation policy gathering per-suite-function call counts, error counts and latency
+ * histograms.
+ *
+ * Each thread records into its own set of counters, so recording is lock-free and does not
+ * contend between threads. Counters are aggregated across threads when queried, e.g. via the C
+ * suite returned by `stats_suite`.
+ *
+ * Suite functions are identified by their compile-time function pointer, i.e. the `fn` given to
+ * SuiteDecorator::decorate, and are assigned an index on first call.
+ *
+ * Registering a function or thread allocates. Should that fail, the sample is dropped rather than
+ * failing the call, and registration is retried on the next call.
+ *
+ * @tparam max_functions Maximum number of distinct suite functions to record. Calls to further
+ * functions are not recorded.
+ */
+template <std::size_t max_functions = 256>
+class HistogramInstrumentation
+{
+	using Clock = std::chrono::steady_clock;
+	using Counter = std::atomic<std::uint64_t>;
+
+public:
+	static constexpr bool enabled = true;
+	static constexpr std::size_t num_buckets = CPPCAPI_STATS_NUM_BUCKETS;
+
+	/// Opaque token returned by `begin` to be passed to `end`.
+	using Token = Clock::time_point;
+
+	/**
+	 * Start measuring a suite function call.
+	 *
+	 * @tparam fn Compile-time identifier of the suite function.
+	 * @return Token to pass to `end`.
+	 */
+	template <auto fn>
+	static Token begin() noexcept
+	{
+		return Clock::now();
+	}
+
+	/**
+	 * Finish measuring a suite function call.
+	 *
+	 * @tparam fn Compile-time identifier of the suite function.
+	 * @param start Token returned by `begin`.
+	 * @param code Error code returned by the call.
+	 */
+	template <auto fn>
+	static void end(Token const start, cppcapi_ErrorCode const code) noexcept
+	{
+		auto const elapsed = static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+		Counters * const counters = function_counters<fn>();
+		if (counters == nullptr)
+			return;
+
+		increment(counters->calls, 1);
+		if (code != cppcapi_ok)
+			increment(counters->errors, 1);
+		increment(counters->total_ns, elapsed);
+		increment(counters->buckets[bucket(elapsed)], 1);
+	}
+
+	/**
+	 * Get a snapshot of statistics of the suite function at the given index.
+	 *
+	 * @param index Index of suite function, in order of first call.
+	 * @return Statistics aggregated across all threads.
+	 */
+	static cppcapi_FunctionStats stats(std::size_t const index)
+	{
+		Registry & reg = registry();
+		std::lock_guard lock{reg.mutex};
+		if (index >= reg.names.size())
+			throw std::out_of_range{"Suite function statistics index out of range"};
+
+		cppcapi_FunctionStats out{reg.names[index], 0, 0, 0, {}};
+		accumulate(out, reg.retired[index], 1);
+		for (auto const * thread : reg.threads) accumulate(out, (*thread)[index], 1);
+		accumulate(out, reg.baseline[index], -1);
+		return out;
+	}
+
+	/// Number of suite functions that have been called so far.
+	static std::size_t count()
+	{
+		Registry & reg = registry();
+		std::lock_guard lock{reg.mutex};
+		return reg.names.size();
+	}
+
+	/**
+	 * Reset all statistics to zero.
+	 *
+	 * Threads are not interrupted, rather a baseline is taken that is subtracted from subsequent
+	 * snapshots.
+	 */
+	static void reset()
+	{
+		Registry & reg = registry();
+		std::lock_guard lock{reg.mutex};
+		for (std::size_t index = 0; index < max_functions; ++index)
+		{
+			copy(reg.baseline[index], reg.retired[index]);
+			for (auto const * thread : reg.threads) add(reg.baseline[index], (*thread)[index]);
+		}
+	}
+
+	/**
+	 * Get the C suite exposing the statistics gathered by this policy.
+	 *
+	 * @return Constant-initialized function pointer suite, shared by all callers.
+	 */
+	static cppcapi_StatsSuite const * stats_suite() noexcept
+	{
+		static constexpr cppcapi_StatsSuite suite{
+			[]() -> std::size_t { return count(); },
+			[](cppcapi_ErrorMessage * err, cppcapi_FunctionStats * out, std::size_t index)
+			{ return ErrorMap<>::wrap_exception(*err, [&] { *out = stats(index); }); },
+			[] { reset(); }};
+		return &suite;
+	}
+
+private:
+	struct Counters
+	{
+		Counter calls{0};
+		Counter errors{0};
+		Counter total_ns{0};
+		std::array<Counter, num_buckets> buckets{};
+	};
+
+	using ThreadCounters = std::array<Counters, max_functions>;
+
+	/// Index of a suite function that has not yet been registered.
+	static constexpr std::size_t unregistered = std::numeric_limits<std::size_t>::max();
+
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<char const *> names;
+		std::vector<ThreadCounters const *> threads;
+		/// Counters of threads that have exited.
+		ThreadCounters retired;
+		/// Counters at the point of the last `reset`.
+		ThreadCounters baseline;
+	};
+
+	/// Registers this thread's counters for the lifetime of the thread.
+	struct ThreadRegistration
+	{
+		ThreadRegistration() : counters{std::make_unique<ThreadCounters>()}
+		{
+			Registry & reg = registry();
+			std::lock_guard lock{reg.mutex};
+			reg.threads.push_back(counters.get());
+		}
+
+		ThreadRegistration(ThreadRegistration const &) = delete;
+		ThreadRegistration(ThreadRegistration &&) = delete;
+		ThreadRegistration & operator=(ThreadRegistration const &) = delete;
+		ThreadRegistration & operator=(ThreadRegistration &&) = delete;
+
+		~ThreadRegistration()
+		{
+			Registry & reg = registry();
+			std::lock_guard lock{reg.mutex};
+			for (std::size_t index = 0; index < max_functions; ++index)
+				add(reg.retired[index], (*counters)[index]);
+			reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), counters.get()));
+		}
+
+		std::unique_ptr<ThreadCounters> counters;
+	};
+
+	static Registry & registry()
+	{
+		static Registry reg;
+		return reg;
+	}
+
+	static ThreadCounters & local_counters()
+	{
+		thread_local ThreadRegistration registration;
+		return *registration.counters;
+	}
+
+	/**
+	 * Get this thread's counters for a suite function, registering the function and the thread on
+	 * first use.
+	 *
+	 * @tparam fn Compile-time identifier of the suite function.
+	 * @return Counters, or `nullptr` if the sample should be dropped.
+	 */
+	template <auto fn>
+	static Counters * function_counters() noexcept
+	{
+		static std::atomic<std::size_t> index{unregistered};
+#if CPPCAPI_EXCEPTIONS
+		try
+		{
+#endif
+			std::size_t idx = index.load(std::memory_order_acquire);
+			if (idx == unregistered)
+			{
+				idx = register_function(detail::value_name<fn>());
+				index.store(idx, std::memory_order_release);
+			}
+			if (idx >= max_functions)
+				return nullptr;
+			return &local_counters()[idx];
+#if CPPCAPI_EXCEPTIONS
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
+#endif
+	}
+
+	/// Registering is idempotent, since threads may race to register the same function.
+	static std::size_t register_function(char const * name)
+	{
+		Registry & reg = registry();
+		std::lock_guard lock{reg.mutex};
+		auto const existing = std::find(reg.names.begin(), reg.names.end(), name);
+		if (existing != reg.names.end())
+			return static_cast<std::size_t>(existing - reg.names.begin());
+		if (reg.names.size() >= max_functions)
+			return max_functions;
+		reg.names.push_back(name);
+		return reg.names.size() - 1;
+	}
+
+	static std::size_t bucket(std::uint64_t nanoseconds) noexcept
+	{
+		std::size_t idx = 0;
+		while (nanoseconds != 0 && idx < num_buckets - 1)
+		{
+			nanoseconds >>= 1U;
+			++idx;
+		}
+		return idx;
+	}
+
+	/// Only the owning thread writes to its counters, so no read-modify-write is needed.
+	static void increment(Counter & counter, std::uint64_t const value) noexcept
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	static void add(Counters & to, Counters const & from) noexcept
+	{
+		increment(to.calls, from.calls.load(std::memory_order_relaxed));
+		increment(to.errors, from.errors.load(std::memory_order_relaxed));
+		increment(to.total_ns, from.total_ns.load(std::memory_order_relaxed));
+		for (std::size_t idx = 0; idx < num_buckets; ++idx)
+			increment(to.buckets[idx], from.buckets[idx].load(std::memory_order_relaxed));
+	}
+
+	static void copy(Counters & to, Counters const & from) noexcept
+	{
+		to.calls.store(from.calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		to.errors.store(from.errors.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		to.total_ns.store(from.total_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		for (std::size_t idx = 0; idx < num_buckets; ++idx)
+			to.buckets[idx].store(
+				from.buckets[idx].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	static void accumulate(cppcapi_FunctionStats & out, Counters const & from, int const sign)
+	{
+		auto const acc = [sign](unsigned long long & to, Counter const & counter)
+		{
+			auto const value = counter.load(std::memory_order_relaxed);
+			to = sign > 0 ? to + value : to - value;
+		};
+		acc(out.calls, from.calls);
+		acc(out.errors, from.errors);
+		acc(out.total_ns, from.total_ns);
+		for (std::size_t idx = 0; idx < num_buckets; ++idx)
+			acc(out.buckets[idx], from.buckets[idx]);
+	}
+};
+}  // namespace cppcapi
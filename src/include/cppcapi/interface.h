@@ -18,6 +18,21 @@ extern "C"
 	/**
 	 * Storage for error messages.
 	 *
+	 * A `capacity` of zero requests a status-only call, where the service doesn't copy the message.
+	 * Instead, on error, `data` is set to a NUL-terminated message owned by the service, valid on
+	 * the calling thread until the next failing call to the same service on that thread.
+	 *
+	 * If `size` is cppcapi_error_payload_requested when passed to a suite function, then the
+	 * `capacity` bytes of `data` are immediately followed by a cppcapi_ErrorPayload, with `type`
+	 * zeroed, which the service can fill on error. Services that predate payloads ignore it.
+	 *
+	 * If `size` is cppcapi_error_exception_requested, then a payload is likewise requested, but
+	 * the service may instead move the original `std::exception_ptr` into it, tagged as
+	 * CPPCAPI_ERROR_PAYLOAD_EXCEPTION, leaving the message empty. The payload's `data` holds a
+	 * pointer to the client's ABI fingerprint, with `size` set accordingly. The service only
+	 * passes the exception once a client has negotiated a matching ABI, see
+	 * cppcapi_NegotiateAbiFn, and if the requesting client's fingerprint matches its own.
+	 *
 	 * @warning This type should not be used for arguments other than the first argument of a suite
 	 * function, or template matches might fail.
 	 */
@@ -28,13 +43,283 @@ extern "C"
 		char * data;
 	} cppcapi_ErrorMessage;
 
+/// Maximum size of the data of a cppcapi_ErrorPayload.
+#define CPPCAPI_ERROR_PAYLOAD_CAPACITY 56
+
+	/**
+	 * Structured data describing an error, e.g. the key that wasn't found, complementing the
+	 * human-readable message.
+	 */
+	typedef struct
+	{
+		/**
+		 * Tag identifying the layout of `data`, or zero if there is no payload. Set to the error
+		 * code of the exception's `ErrorTraits` by `ErrorMap`.
+		 */
+		int type;
+		/// Number of bytes of `data` used.
+		unsigned int size;
+		/// Plain-old-data payload, packed.
+		unsigned char data[CPPCAPI_ERROR_PAYLOAD_CAPACITY];
+	} cppcapi_ErrorPayload;
+
+	/// Value of cppcapi_ErrorMessage::size requesting a cppcapi_ErrorPayload.
+	static const size_t cppcapi_error_payload_requested = (size_t)-1;
+	/// Value of cppcapi_ErrorMessage::size requesting the original exception, where supported.
+	static const size_t cppcapi_error_exception_requested = (size_t)-2;
+
+/// Value of cppcapi_ErrorPayload::type for a payload holding a `std::exception_ptr`.
+#define CPPCAPI_ERROR_PAYLOAD_EXCEPTION (-2147483647 - 1)
+
+/// Name of the optional symbol exported by a service to negotiate its ABI with clients.
+#define CPPCAPI_NEGOTIATE_ABI_SYMBOL "cppcapi_negotiate_abi"
+
+	/**
+	 * Function exported by a service as CPPCAPI_NEGOTIATE_ABI_SYMBOL, called at load time.
+	 *
+	 * If the client's ABI fingerprint matches the service's, i.e. both were built with the same
+	 * compiler and standard library, then exceptions can be passed across the boundary as-is, see
+	 * cppcapi_error_exception_requested.
+	 *
+	 * @param client_fingerprint NUL-terminated ABI fingerprint of the client.
+	 * @return Non-zero if exceptions will be passed as-is, zero otherwise.
+	 */
+	typedef int (*cppcapi_NegotiateAbiFn)(char const * client_fingerprint);
+
 #define CPPCAPI_ErrorCode_OK 0
 #define CPPCAPI_ErrorCode_ERROR 1
+#define CPPCAPI_ErrorCode_CANCELLED 2
+#define CPPCAPI_ErrorCode_DEADLINE_EXCEEDED 3
 
 	/// Error code signaling no error occurred.
 	static const cppcapi_ErrorCode cppcapi_ok = CPPCAPI_ErrorCode_OK;
 	/// Default error code signalling some error occurred. Expected to be extended by ErrorMap.
 	static const cppcapi_ErrorCode cppcapi_error = CPPCAPI_ErrorCode_ERROR;
+	/// Error code signalling the call was cancelled via its cppcapi_CallContext.
+	static const cppcapi_ErrorCode cppcapi_cancelled = CPPCAPI_ErrorCode_CANCELLED;
+	/// Error code signalling the deadline of the call's cppcapi_CallContext passed.
+	static const cppcapi_ErrorCode cppcapi_deadline_exceeded = CPPCAPI_ErrorCode_DEADLINE_EXCEEDED;
+
+	/// Value of cppcapi_CallContext::deadline_ns signalling no deadline.
+	static const long long cppcapi_no_deadline = 0;
+
+	/**
+	 * Deadline and cancellation state of a suite function call.
+	 *
+	 * Passed as the argument immediately following the handle of a suite function, i.e.
+	 * `(cppcapi_ErrorMessage *, [out,] handle, cppcapi_CallContext const *, args...)`. Can be NULL,
+	 * signalling no deadline and no cancellation.
+	 *
+	 * If the deadline has passed or the call has been cancelled before it starts, then the call
+	 * fails with cppcapi_deadline_exceeded or cppcapi_cancelled, respectively. Long-running
+	 * functions can also poll the context periodically.
+	 */
+	typedef struct
+	{
+		/**
+		 * Deadline in nanoseconds since the epoch of the monotonic clock, i.e.
+		 * `std::chrono::steady_clock` (`CLOCK_MONOTONIC` on Linux), or cppcapi_no_deadline.
+		 */
+		long long deadline_ns;
+		/// Returns non-zero if the call has been cancelled, callable from any thread. Can be NULL.
+		int (*is_cancelled)(void * data);
+		/// Arbitrary data to pass to `is_cancelled`.
+		void * data;
+	} cppcapi_CallContext;
+
+/**
+ * Get the function pointer suite of the dynamic type of an instance, given its handle.
+ *
+ * Only valid for handles whose instances carry the suite of their dynamic type, i.e. where the
+ * handle points to a pointer to the suite, as is the case for handles using
+ * `cppcapi::service::DynamicDispatch`. C++ callers should prefer `cppcapi::dynamic_suite`, which
+ * avoids the C-style cast.
+ */
+#define CPPCAPI_DYNAMIC_SUITE(Suite, handle) (*(Suite const * const *)(handle))
+
+	/// Unit of work to be run by an executor.
+	typedef void (*cppcapi_Task)(void * data);
+
+	/**
+	 * Executor used to run asynchronous suite functions.
+	 *
+	 * `submit` must (eventually) call `task(data)` exactly once, typically on another thread.
+	 */
+	typedef struct
+	{
+		void (*submit)(void * context, cppcapi_Task task, void * data);
+		void * context;
+	} cppcapi_Executor;
+
+	/**
+	 * Completion notification for asynchronous suite functions.
+	 *
+	 * Asynchronous suite functions have the signature `(cppcapi_Completion const *, [out,] handle,
+	 * args...) -> void` and return immediately. Once the work has finished, `err` has been
+	 * populated and any `out` parameter written, the service will write to `eventfd` (if not
+	 * negative) and then call `callback` (if not NULL), in that order.
+	 *
+	 * The struct itself is copied by the service, so can be discarded once the suite function
+	 * returns. However, `err`, any `out` parameter and any handles passed as arguments must remain
+	 * valid until completion is signalled.
+	 */
+	typedef struct
+	{
+		/// Called on completion with `user_data` and the resulting error code. Can be NULL.
+		void (*callback)(void * user_data, cppcapi_ErrorCode code);
+		/// Arbitrary data to pass to `callback`.
+		void * user_data;
+		/// Storage for error message.
+		cppcapi_ErrorMessage * err;
+		/// File descriptor (e.g. from `eventfd`) to signal on completion, or -1.
+		int eventfd;
+		/// Executor to run the work on, or NULL to use the service's default executor.
+		cppcapi_Executor const * executor;
+	} cppcapi_Completion;
+
+	/**
+	 * Header preceding each command recorded in a cppcapi_CommandBuffer.
+	 *
+	 * The `opcode` is the index of the suite function in the list of commands agreed between
+	 * client and service. The header is followed by `size` bytes of packed (unaligned) arguments,
+	 * i.e. the arguments of the suite function excluding any leading cppcapi_ErrorMessage.
+	 */
+	typedef struct
+	{
+		unsigned int opcode;
+		unsigned int size;
+	} cppcapi_CommandHeader;
+
+	/**
+	 * Buffer of suite function calls recorded by a client, to be replayed by a service in a single
+	 * `execute` call with signature `(cppcapi_ErrorMessage *, cppcapi_CommandResult *,
+	 * cppcapi_CommandBuffer const *) -> cppcapi_ErrorCode`.
+	 */
+	typedef struct
+	{
+		/// Sequence of `count` commands, each a cppcapi_CommandHeader followed by its arguments.
+		unsigned char const * data;
+		/// Total size of `data` in bytes.
+		size_t size;
+		/// Number of commands in `data`.
+		size_t count;
+	} cppcapi_CommandBuffer;
+
+	/**
+	 * Result of a single command replayed from a cppcapi_CommandBuffer.
+	 *
+	 * Error messages of all failed commands are packed into the error message storage given to
+	 * `execute`, and referenced by offset and size.
+	 */
+	typedef struct
+	{
+		cppcapi_ErrorCode code;
+		size_t message_offset;
+		size_t message_size;
+	} cppcapi_CommandResult;
+
+/// Number of latency buckets in cppcapi_FunctionStats.
+#define CPPCAPI_STATS_NUM_BUCKETS 40
+
+	/**
+	 * Call statistics of a single suite function, as gathered by an instrumented service.
+	 *
+	 * Latencies are bucketed by powers of two: bucket 0 counts calls taking less than 1ns, bucket
+	 * `i` counts calls taking `[2^(i-1), 2^i)` nanoseconds, and the final bucket counts all longer
+	 * calls.
+	 */
+	typedef struct
+	{
+		/// Human-readable name of the suite function. Owned by the service.
+		char const * name;
+		/// Number of calls made.
+		unsigned long long calls;
+		/// Number of calls returning a non-zero error code.
+		unsigned long long errors;
+		/// Sum of latencies of all calls, in nanoseconds.
+		unsigned long long total_ns;
+		/// Histogram of latencies.
+		unsigned long long buckets[CPPCAPI_STATS_NUM_BUCKETS];
+	} cppcapi_FunctionStats;
+
+	/**
+	 * Suite to query the call statistics of an instrumented service.
+	 *
+	 * Suite functions are numbered in order of their first call.
+	 */
+	typedef struct
+	{
+		/// Number of suite functions that have been called so far.
+		size_t (*count)(void);
+		/// Get a snapshot of statistics of the suite function at the given index.
+		cppcapi_ErrorCode (*get)(cppcapi_ErrorMessage *, cppcapi_FunctionStats *, size_t);
+		/// Reset all statistics to zero.
+		void (*reset)(void);
+	} cppcapi_StatsSuite;
+
+	/// Kind of signature of a suite function, determining how it is decorated.
+	typedef enum
+	{
+		/// fn(handle, args...) -> T
+		cppcapi_signature_cannot_output_cannot_error,
+		/// fn(err, handle, args...) -> code
+		cppcapi_signature_cannot_output_can_error,
+		/// fn(out, handle, args...) -> void
+		cppcapi_signature_can_output_cannot_error,
+		/// fn(err, out, handle, args...) -> code
+		cppcapi_signature_can_output_can_error,
+		/// fn(args...) -> handle
+		cppcapi_signature_factory_cannot_output_cannot_error,
+		/// fn(handle*, args...) -> void
+		cppcapi_signature_factory_can_output_cannot_error,
+		/// fn(err, handle*, args...) -> code
+		cppcapi_signature_factory_can_output_can_error,
+		/// Any other signature, e.g. a command buffer `execute`.
+		cppcapi_signature_other
+	} cppcapi_SignatureKind;
+
+	/// Ownership of a handle parameter of a suite function.
+	typedef enum
+	{
+		/// Not a handle (or pointer to handle).
+		cppcapi_ownership_none,
+		/// Reference-counted instance, see `HandleOwnershipTag::Shared`.
+		cppcapi_ownership_shared,
+		/// Instance owned by the client, see `HandleOwnershipTag::OwnedByClient`.
+		cppcapi_ownership_owned_by_client,
+		/// Instance owned by the service, see `HandleOwnershipTag::OwnedByService`.
+		cppcapi_ownership_owned_by_service,
+		/// Handle to a remote service, wrapped in a client adapter.
+		cppcapi_ownership_remote
+	} cppcapi_Ownership;
+
+	/// Metadata of a single parameter of a suite function.
+	typedef struct
+	{
+		/// Name of the C type, with typedefs resolved.
+		char const * type;
+		/// Ownership of the handle, if the parameter is a handle or pointer to a handle.
+		cppcapi_Ownership ownership;
+	} cppcapi_ParamMetadata;
+
+	/// Metadata of a single suite function.
+	typedef struct
+	{
+		/// Qualified name, e.g. `"MySuite_s::my_func"`.
+		char const * name;
+		cppcapi_SignatureKind kind;
+		cppcapi_ParamMetadata const * params;
+		size_t num_params;
+	} cppcapi_FunctionMetadata;
+
+	/// Metadata of a function pointer suite, with static storage duration.
+	typedef struct
+	{
+		/// Name of the suite type.
+		char const * name;
+		cppcapi_FunctionMetadata const * functions;
+		size_t num_functions;
+	} cppcapi_SuiteMetadata;
 #ifdef __cplusplus
 }
 #endif
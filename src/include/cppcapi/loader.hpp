@@ -6,8 +6,18 @@
 #pragma once
 #include <dlfcn.h>
 
+#include <cstddef>
+
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "abi.hpp"
+#include "error_map.hpp"
 
 namespace cppcapi
 {
@@ -16,6 +26,43 @@ using PluginHandle = decltype(dlopen("", 0));
 /// Result of calling `dlsym`.
 using SymHandle = decltype(dlsym(nullptr, ""));
 
+/// Whether `dlmopen` is available, allowing plugins to be loaded into isolated namespaces.
+#if defined(LM_ID_NEWLM)
+#define CPPCAPI_HAS_DLMOPEN 1
+#else
+#define CPPCAPI_HAS_DLMOPEN 0
+#endif
+
+/**
+ * Time taken to load a plugin, see Loader::timing.
+ */
+struct LoadTiming
+{
+	/// Time taken by `dlopen`, including binding all symbols if loaded eagerly.
+	std::chrono::nanoseconds open{};
+	/// Time taken resolving suite factories and their suites, see Loader::bind_suites.
+	std::chrono::nanoseconds bind{};
+	/// Number of suite factories bound.
+	std::size_t num_bound{};
+};
+
+namespace detail
+{
+inline std::size_t next_suite_slot() noexcept
+{
+	static std::atomic<std::size_t> next{0};
+	return next++;
+}
+
+/// Index into a Loader's table of bound suite factories, unique to each adapter type.
+template <class Adapter>
+std::size_t suite_slot() noexcept
+{
+	static std::size_t const slot = next_suite_slot();
+	return slot;
+}
+}  // namespace detail
+
 /**
  * RAII wrapper and utilities for loading a DSO and its symbols.
  */
@@ -25,17 +72,80 @@ public:
 	/**
 	 * Constructor - load the plugin and throw `filesystem_error` on failure.
 	 *
+	 * The DSO is loaded into the global namespace, so loading the same DSO again gives the same
+	 * instance, sharing its globals and static state.
+	 *
 	 * @param file_path Path to DSO file to load.
 	 * @param mode Mode to pass to `dlopen`.
 	 */
-	// TODO: dlmopen
 	explicit Loader(char const * file_path, int mode = RTLD_LAZY)
-		: file_path_{file_path}, handle_{dlopen(file_path, mode)}
+		: Loader{file_path, false, [&] { return dlopen(file_path, mode); }}
 	{
-		if (!handle_)
-			throw std::filesystem::filesystem_error{
-				std::string{"Failed to load '"} + file_path + "': " + dlerror(),
-				std::make_error_code(std::errc::io_error)};
+	}
+
+	/**
+	 * Load the plugin, binding all its symbols eagerly, and bind the suite factories of the given
+	 * adapters, see bind_suites.
+	 *
+	 * Moves the cost of lazy PLT fixups and symbol lookups from the first calls into the plugin to
+	 * load time, which is reported by timing.
+	 *
+	 * @tparam Adapters client::SuiteAdapter types whose suite factories to bind.
+	 * @param file_path Path to DSO file to load.
+	 * @param suite_factory_names Symbol names in DSO of suite factory functions, one per adapter.
+	 * @return Loader with the suite factories bound.
+	 */
+	template <class... Adapters, class... Names>
+	static Loader load_eager(char const * file_path, Names const... suite_factory_names)
+	{
+		Loader loader{file_path, RTLD_NOW};
+		loader.bind_suites<Adapters...>(suite_factory_names...);
+		return loader;
+	}
+
+#if CPPCAPI_HAS_DLMOPEN
+	/**
+	 * Load an independent instance of the plugin into a new namespace, via `dlmopen`, and throw
+	 * `filesystem_error` on failure.
+	 *
+	 * Each instance has its own copy of the DSO and its dependencies, including the C++ runtime,
+	 * so its own globals and static state. Instances can therefore be used concurrently, e.g. one
+	 * per core, with no shared mutable state between them. Suites must be resolved from the
+	 * instance they are used with, e.g. via load_adapter.
+	 *
+	 * Note that the number of namespaces is limited, e.g. to 16 by glibc, and `RTLD_GLOBAL` is
+	 * not supported.
+	 *
+	 * @param file_path Path to DSO file to load.
+	 * @param mode Mode to pass to `dlmopen`.
+	 * @return Loader of the new instance.
+	 */
+	static Loader load_isolated(char const * file_path, int mode = RTLD_LAZY)
+	{
+		return Loader{file_path, true, [&] { return dlmopen(LM_ID_NEWLM, file_path, mode); }};
+	}
+#endif
+
+	Loader(Loader const &) = delete;
+	Loader & operator=(Loader const &) = delete;
+
+	Loader(Loader && other) noexcept
+		: file_path_{std::move(other.file_path_)},
+		  handle_{std::exchange(other.handle_, nullptr)},
+		  isolated_{other.isolated_},
+		  bound_{std::move(other.bound_)},
+		  timing_{other.timing_}
+	{
+	}
+
+	Loader & operator=(Loader && other) noexcept
+	{
+		std::swap(file_path_, other.file_path_);
+		std::swap(handle_, other.handle_);
+		std::swap(isolated_, other.isolated_);
+		std::swap(bound_, other.bound_);
+		std::swap(timing_, other.timing_);
+		return *this;
 	}
 
 	/// Destructor - call `dlclose` on the handle.
@@ -46,6 +156,18 @@ public:
 		handle_ = nullptr;
 	}
 
+	/// Whether the plugin was loaded into its own namespace, see load_isolated.
+	[[nodiscard]] bool isolated() const noexcept
+	{
+		return isolated_;
+	}
+
+	/// Time taken to load the plugin and bind its suites.
+	[[nodiscard]] LoadTiming const & timing() const noexcept
+	{
+		return timing_;
+	}
+
 	/**
 	 * Load an arbitrary symbol from the plugin DSO.
 	 *
@@ -54,22 +176,57 @@ public:
 	 * @return Loaded symbol.
 	 */
 	template <typename Symbol>
-	Symbol load_symbol(char const * name)
+	Symbol load_symbol(char const * name) const
 	{
 		SymHandle sym = dlsym(handle_, name);
 		if (!sym)
-			throw std::filesystem::filesystem_error{
+			detail::raise<std::filesystem::filesystem_error>(
 				std::string{"Failed to find symbol '"} + name + "' in '" + file_path_ +
 					"': " + dlerror(),
-				std::make_error_code(std::errc::bad_address)};
+				std::make_error_code(std::errc::bad_address));
 
 		return reinterpret_cast<Symbol>(sym);
 	}
 
+	/**
+	 * Whether the plugin DSO exports a symbol.
+	 *
+	 * @param name Name of the symbol.
+	 * @return Whether the symbol was found.
+	 */
+	[[nodiscard]] bool has_symbol(char const * name) const noexcept
+	{
+		return dlsym(handle_, name) != nullptr;
+	}
+
+	/**
+	 * Negotiate the ABI with the plugin DSO, opting in to exceptions being passed as-is.
+	 *
+	 * Should be called straight after loading, before any suite functions are called. If the
+	 * plugin exports a CPPCAPI_NEGOTIATE_ABI_SYMBOL function and was built with the same compiler
+	 * and standard library, then exceptions are rethrown as the original exception object, rather
+	 * than converted to and from an error code and message, see client::negotiate_abi.
+	 *
+	 * Isolated plugins never pass exceptions as-is, since they have their own C++ runtime.
+	 *
+	 * @return Whether exceptions will be passed as-is by the plugin.
+	 */
+	bool negotiate_abi() noexcept
+	{
+		if (isolated_)
+			return false;
+		auto const negotiate =
+			reinterpret_cast<cppcapi_NegotiateAbiFn>(dlsym(handle_, CPPCAPI_NEGOTIATE_ABI_SYMBOL));
+		return client::negotiate_abi(negotiate);
+	}
+
 	/**
 	 * Load a function pointer suite factory from the plugin DSO and instantiate an adapter class
 	 * around it.
 	 *
+	 * If the suite factory was bound under the same name by bind_suites, then no symbol is looked
+	 * up.
+	 *
 	 * @tparam Adapter client::HandleAdapter type to instantiate.
 	 * @tparam Args Additional argument types to pass to Adapter constructor.
 	 * @param suite_factory_name Symbol name in DSO of suite factory function.
@@ -77,15 +234,121 @@ public:
 	 * @return Adapter instance.
 	 */
 	template <class Adapter, typename... Args>
-	Adapter load_adapter(char const * suite_factory_name, Args &&... args)
+	Adapter load_adapter(char const * suite_factory_name, Args &&... args) const
 	{
-		auto const suite_factory = load_symbol<typename Adapter::SuiteFactory>(suite_factory_name);
+		auto suite_factory = bound_factory<Adapter>(suite_factory_name);
+		if (suite_factory == nullptr)
+			suite_factory = load_symbol<typename Adapter::SuiteFactory>(suite_factory_name);
+
+		return Adapter{suite_factory, std::forward<Args>(args)...};
+	}
+
+	/**
+	 * Resolve the suite factories of the given adapters once, keeping them in a table owned by this
+	 * Loader.
+	 *
+	 * Each suite factory is called once here, to check it returns a suite. Adapters can then be
+	 * created by make_adapter, or load_adapter with the same symbol name, without looking up any
+	 * symbols. Note that adapters are still constructed from the suite factory, so each calls it
+	 * again to get its suite, which is typically just the address of a constant-initialized table.
+	 *
+	 * @tparam Adapters client::SuiteAdapter types whose suite factories to bind.
+	 * @param suite_factory_names Symbol names in DSO of suite factory functions, one per adapter.
+	 */
+	template <class... Adapters, class... Names>
+	void bind_suites(Names const... suite_factory_names)
+	{
+		static_assert(
+			sizeof...(Adapters) == sizeof...(Names), "Expected a suite factory name per adapter");
+
+		auto const start = Clock::now();
+		(bind_suite<Adapters>(suite_factory_names), ...);
+		timing_.bind += Clock::now() - start;
+		timing_.num_bound += sizeof...(Adapters);
+	}
+
+	/**
+	 * Instantiate an adapter class around its bound suite factory, see bind_suites.
+	 *
+	 * @tparam Adapter client::HandleAdapter type to instantiate.
+	 * @tparam Args Additional argument types to pass to Adapter constructor.
+	 * @param args Additional arguments to pass to Adapter constructor.
+	 * @throw std::logic_error if the adapter's suite factory has not been bound.
+	 * @return Adapter instance.
+	 */
+	template <class Adapter, typename... Args>
+	Adapter make_adapter(Args &&... args) const
+	{
+		auto const suite_factory = bound_factory<Adapter>(nullptr);
+		if (suite_factory == nullptr)
+			detail::raise<std::logic_error>(
+				std::string{"Suite factory of adapter not bound in '"} + file_path_ + "'");
 
 		return Adapter{suite_factory, std::forward<Args>(args)...};
 	}
 
 private:
+	using Clock = std::chrono::steady_clock;
+
+	/// Suite factory bound by bind_suites.
+	struct BoundSuite
+	{
+		std::string name;
+		void (*factory)();
+	};
+
+	template <class Open>
+	Loader(char const * file_path, bool const isolated, Open const & open)
+		: file_path_{file_path}, isolated_{isolated}
+	{
+		auto const start = Clock::now();
+		handle_ = open();
+		timing_.open = Clock::now() - start;
+
+		if (!handle_)
+			detail::raise<std::filesystem::filesystem_error>(
+				std::string{"Failed to load '"} + file_path + "': " + dlerror(),
+				std::make_error_code(std::errc::io_error));
+	}
+
+	template <class Adapter>
+	void bind_suite(char const * suite_factory_name)
+	{
+		auto const suite_factory = load_symbol<typename Adapter::SuiteFactory>(suite_factory_name);
+		if (suite_factory() == nullptr)
+			detail::raise<std::filesystem::filesystem_error>(
+				std::string{"Suite factory '"} + suite_factory_name + "' in '" + file_path_ +
+					"' returned no suite",
+				std::make_error_code(std::errc::bad_address));
+
+		std::size_t const slot = detail::suite_slot<Adapter>();
+		if (slot >= bound_.size())
+			bound_.resize(slot + 1);
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		bound_[slot] = {suite_factory_name, reinterpret_cast<void (*)()>(suite_factory)};
+	}
+
+	/**
+	 * Suite factory bound for the adapter, or `nullptr` if not bound, or bound under a different
+	 * name.
+	 */
+	template <class Adapter>
+	typename Adapter::SuiteFactory bound_factory(char const * suite_factory_name) const
+	{
+		std::size_t const slot = detail::suite_slot<Adapter>();
+		if (slot >= bound_.size() || bound_[slot].factory == nullptr)
+			return nullptr;
+		if (suite_factory_name != nullptr && bound_[slot].name != suite_factory_name)
+			return nullptr;
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		return reinterpret_cast<typename Adapter::SuiteFactory>(bound_[slot].factory);
+	}
+
 	std::string file_path_;
-	PluginHandle handle_;
+	PluginHandle handle_{nullptr};
+	bool isolated_;
+	/// Bound suite factories, indexed by detail::suite_slot.
+	std::vector<BoundSuite> bound_;
+	LoadTiming timing_;
 };
 }  // namespace cppcapi
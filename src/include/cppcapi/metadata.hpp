@@ -0,0 +1,101 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains compile-time utilities for naming types and functions, used to build suite metadata.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "interface.h"
+
+namespace cppcapi::detail
+{
+/**
+ * Extract the value of a template argument from a compiler-generated pretty function name.
+ *
+ * Supports GCC's `[with T = value; ...]` and Clang's `[T = value]` formats.
+ *
+ * @param pretty Pretty function name, i.e. `__PRETTY_FUNCTION__`.
+ * @param marker Prefix of template argument, e.g. `"T = "`.
+ * @return Template argument, or the full pretty function name if not found.
+ */
+constexpr std::string_view extract_template_arg(std::string_view pretty, std::string_view marker)
+{
+	auto const start = pretty.find(marker);
+	if (start == std::string_view::npos)
+		return pretty;
+	pretty.remove_prefix(start + marker.size());
+	auto const end = pretty.find(';');
+	pretty = pretty.substr(0, end == std::string_view::npos ? pretty.rfind(']') : end);
+	if (!pretty.empty() && pretty.front() == '&')
+		pretty.remove_prefix(1);
+	return pretty;
+}
+
+template <std::size_t N>
+constexpr std::array<char, N + 1> to_c_string(std::string_view const str)
+{
+	std::array<char, N + 1> out{};
+	for (std::size_t idx = 0; idx < N; ++idx) out[idx] = str[idx];
+	return out;
+}
+
+template <auto value>
+constexpr std::string_view pretty_value_name()
+{
+	return extract_template_arg(
+		static_cast<char const *>(__PRETTY_FUNCTION__), std::string_view{"value = "});
+}
+
+template <class T>
+constexpr std::string_view pretty_type_name()
+{
+	return extract_template_arg(
+		static_cast<char const *>(__PRETTY_FUNCTION__), std::string_view{"T = "});
+}
+
+template <auto value>
+struct value_name_t
+{
+	static constexpr std::string_view view = pretty_value_name<value>();
+	static constexpr auto storage = to_c_string<view.size()>(view);
+};
+
+template <class T>
+struct type_name_t
+{
+	static constexpr std::string_view view = pretty_type_name<T>();
+	static constexpr auto storage = to_c_string<view.size()>(view);
+};
+
+/**
+ * Get the name of a compile-time value, e.g. a function or member pointer.
+ *
+ * For example `&MySuite::my_func` gives `"MySuite::my_func"`.
+ *
+ * @tparam value Compile-time value.
+ * @return Null-terminated name with static storage duration.
+ */
+template <auto value>
+constexpr char const * value_name()
+{
+	return value_name_t<value>::storage.data();
+}
+
+/**
+ * Get the name of a type.
+ *
+ * Note that typedefs are resolved, e.g. a handle `MyHandle_h` gives `"MyHandle_t*"`.
+ *
+ * @tparam T Type.
+ * @return Null-terminated name with static storage duration.
+ */
+template <class T>
+constexpr char const * type_name()
+{
+	return type_name_t<T>::storage.data();
+}
+}  // namespace cppcapi::detail
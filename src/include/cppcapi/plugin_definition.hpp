@@ -8,6 +8,7 @@
 #include "client/handle_map.hpp"
 #include "client/suite_adaptor.hpp"
 #include "error_map.hpp"
+#include "instrumentation.hpp"
 #include "service/handle_map.hpp"
 #include "service/suite_decorator.hpp"
 
@@ -26,6 +27,7 @@ struct plugin_definition_args_t<>
 	using service_handle_map_t = service::HandleMap<>;
 	using client_handle_map_t = client::HandleMap<>;
 	using error_map_t = ErrorMap<>;
+	using instrumentation_t = NullInstrumentation;
 };
 
 template <typename... ArgArgs, class... OtherArgs>
@@ -49,6 +51,17 @@ struct plugin_definition_args_t<ErrorMap<ArgArgs...>, OtherArgs...>
 	using error_map_t = ErrorMap<ArgArgs...>;
 };
 
+/// Any other argument is assumed to be an instrumentation policy.
+template <class Arg, class... OtherArgs>
+struct plugin_definition_args_t<Arg, OtherArgs...> : plugin_definition_args_t<OtherArgs...>
+{
+	static_assert(
+		std::is_same_v<decltype(Arg::enabled), bool const>,
+		"Unrecognised PluginDefinition argument, expected a HandleMap, ErrorMap or "
+		"instrumentation policy");
+	using instrumentation_t = Arg;
+};
+
 }  // namespace detail
 
 /**
@@ -59,8 +72,9 @@ struct plugin_definition_args_t<ErrorMap<ArgArgs...>, OtherArgs...>
  * and client::SuiteAdapter and their common template parameters.
  *
  * @tparam Args service::HandleMap mapping handles to native classes, client::HandleMap mapping
- * handles to adapter classes, and ErrorMap mapping exceptions to error codes, in any order. If any
- * of those are missing, then an empty fallback is assumed.
+ * handles to adapter classes, ErrorMap mapping exceptions to error codes, and an instrumentation
+ * policy (e.g. HistogramInstrumentation) for decorated suite functions, in any order. If any of
+ * those are missing, then an empty fallback (or NullInstrumentation) is assumed.
  */
 template <class... Args>
 class PluginDefinition
@@ -71,9 +85,11 @@ class PluginDefinition
 	using ErrorMap = typename arg_parse_t::error_map_t;
 
 public:
+	using Instrumentation = typename arg_parse_t::instrumentation_t;
+
 	template <class Handle>
-	using SuiteDecorator =
-		service::SuiteDecorator<Handle, ServiceHandleMap, ClientHandleMap, ErrorMap>;
+	using SuiteDecorator = service::
+		SuiteDecorator<Handle, ServiceHandleMap, ClientHandleMap, ErrorMap, Instrumentation>;
 
 	template <class Handle>
 	using HandleManager =
@@ -81,5 +97,21 @@ public:
 
 	template <class Handle>
 	using SuiteAdapter = client::SuiteAdapter<Handle, ServiceHandleMap, ClientHandleMap, ErrorMap>;
+
+	/// SuiteAdapter holding only its handle, with the suite shared by all adapters of the type.
+	template <class Handle>
+	using CompactSuiteAdapter =
+		client::SuiteAdapter<Handle, ServiceHandleMap, ClientHandleMap, ErrorMap, true>;
+
+	/**
+	 * Compile-time metadata describing a function pointer suite.
+	 *
+	 * @see service::SuiteDecorator::metadata
+	 */
+	template <class Handle, auto... members>
+	static constexpr cppcapi_SuiteMetadata const & suite_metadata()
+	{
+		return SuiteDecorator<Handle>::template metadata<members...>();
+	}
 };
 }  // namespace cppcapi
\ No newline at end of file
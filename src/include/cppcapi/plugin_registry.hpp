@@ -0,0 +1,305 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the PluginRegistry used for discovering and loading many plugins at once.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "error_map.hpp"
+#include "loader.hpp"
+#include "thread_pool.hpp"
+
+namespace cppcapi
+{
+/**
+ * Collection of plugins discovered in directories and loaded in parallel.
+ *
+ * Each plugin is loaded by a Loader on a ThreadPool, along with binding the suite factories it
+ * exports, see Loader::bind_suites. A plugin failing to load doesn't prevent others loading, but
+ * is recorded along with its error. Plugins can then be looked up by name, or by the handle type
+ * whose suite they provide.
+ *
+ * Note that some dynamic loaders, e.g. glibc's, hold a global lock whilst loading a DSO, including
+ * relocation and static initialization, limiting the speedup from loading in parallel. Binding
+ * suites, i.e. symbol lookup and suite factory calls, happens outside of that lock.
+ *
+ * When building without exceptions, see CPPCAPI_EXCEPTIONS, a plugin failing to load aborts.
+ */
+class PluginRegistry
+{
+public:
+	/// A discovered plugin and the outcome of loading it.
+	struct Plugin
+	{
+		/// Name of the plugin, i.e. its file name without any `lib` prefix or extension.
+		std::string name;
+		/// Path to the plugin DSO.
+		std::filesystem::path path;
+		/// Loader of the plugin, unless it failed to load.
+		std::optional<Loader> loader;
+		/// Error message, if the plugin failed to load.
+		std::string error;
+		/// Time taken to load the plugin and bind its suites, on the thread that loaded it.
+		std::chrono::nanoseconds load_time{};
+		/// Slots, see detail::suite_slot, of handle types whose suites the plugin provides.
+		std::vector<std::size_t> provided;
+	};
+
+	/// Plugin allocated separately, so sorting or adding plugins doesn't move it.
+	using PluginPtr = std::unique_ptr<Plugin>;
+
+	/**
+	 * Constructor.
+	 *
+	 * @param mode Mode to pass to `dlopen`, e.g. `RTLD_NOW` to bind eagerly on the pool.
+	 * @param num_threads Maximum number of threads to load plugins on.
+	 */
+	explicit PluginRegistry(
+		int const mode = RTLD_LAZY,
+		std::size_t const num_threads = ThreadPool::default_num_threads())
+		: mode_{mode}, num_threads_{std::max(num_threads, std::size_t{1})}
+	{
+	}
+
+	/**
+	 * Find plugin DSOs in the given directories, non-recursively.
+	 *
+	 * Where several directories contain a plugin with the same name, the first takes precedence,
+	 * similar to a search path.
+	 *
+	 * @param directories Directories to search. Those that don't exist are skipped.
+	 * @return Paths to plugin DSOs, in order of directory then file name.
+	 */
+	static std::vector<std::filesystem::path> discover(
+		std::vector<std::filesystem::path> const & directories)
+	{
+		std::vector<std::filesystem::path> paths;
+		std::vector<std::string> names;
+		for (auto const & directory : directories)
+		{
+			std::error_code err;
+			std::vector<std::filesystem::path> found;
+			for (auto const & entry : std::filesystem::directory_iterator{directory, err})
+			{
+				auto const & path = entry.path();
+				if (entry.is_regular_file(err) && is_plugin_extension(path.extension().string()))
+					found.push_back(path);
+			}
+			std::sort(found.begin(), found.end());
+
+			for (auto & path : found)
+			{
+				std::string name = name_of(path);
+				if (std::find(names.begin(), names.end(), name) != names.end())
+					continue;
+				names.push_back(std::move(name));
+				paths.push_back(std::move(path));
+			}
+		}
+		return paths;
+	}
+
+	/**
+	 * Load plugins in parallel, binding the suite factories of the given adapters in each plugin
+	 * that exports them.
+	 *
+	 * Where several plugins provide a suite for the same handle type, the first by name takes
+	 * precedence.
+	 *
+	 * Plugins can be loaded in several batches. Each plugin is allocated separately, so Loaders
+	 * previously returned by find remain valid.
+	 *
+	 * @tparam Adapters client::SuiteAdapter types whose suite factories to bind.
+	 * @param paths Paths to plugin DSOs.
+	 * @param suite_factory_names Symbol names of suite factory functions, one per adapter.
+	 */
+	template <class... Adapters, class... Names>
+	void load(std::vector<std::filesystem::path> const & paths, Names const... suite_factory_names)
+	{
+		static_assert(
+			sizeof...(Adapters) == sizeof...(Names), "Expected a suite factory name per adapter");
+
+		std::vector<std::function<void()>> jobs;
+		jobs.reserve(paths.size());
+		for (auto const & path : paths)
+		{
+			Plugin & plugin = *plugins_.emplace_back(std::make_unique<Plugin>());
+			plugin.name = name_of(path);
+			plugin.path = path;
+			jobs.emplace_back([this, &plugin, suite_factory_names...]
+							  { load_plugin<Adapters...>(plugin, suite_factory_names...); });
+		}
+
+		{
+			// Destructor drains the queue and joins, so all plugins are loaded after this scope.
+			ThreadPool pool{std::min(num_threads_, jobs.size())};
+			for (auto & job : jobs)
+				pool.submit(
+					[](void * data) { (*static_cast<std::function<void()> *>(data))(); }, &job);
+		}
+
+		std::stable_sort(
+			plugins_.begin(),
+			plugins_.end(),
+			[](PluginPtr const & lhs, PluginPtr const & rhs) { return lhs->name < rhs->name; });
+		index_providers();
+	}
+
+	/**
+	 * Discover plugins in the given directories and load them in parallel, see discover and load.
+	 *
+	 * @tparam Adapters client::SuiteAdapter types whose suite factories to bind.
+	 * @param directories Directories to search.
+	 * @param suite_factory_names Symbol names of suite factory functions, one per adapter.
+	 */
+	template <class... Adapters, class... Names>
+	void load_directories(
+		std::vector<std::filesystem::path> const & directories,
+		Names const... suite_factory_names)
+	{
+		load<Adapters...>(discover(directories), suite_factory_names...);
+	}
+
+	/// All plugins, whether or not they loaded successfully, sorted by name.
+	[[nodiscard]] std::vector<PluginPtr> const & plugins() const noexcept
+	{
+		return plugins_;
+	}
+
+	/**
+	 * Find a successfully loaded plugin by name.
+	 *
+	 * @param name Name of the plugin, see Plugin::name.
+	 * @return Loader of the plugin, or `nullptr` if not found or it failed to load.
+	 */
+	[[nodiscard]] Loader const * find(std::string_view const name) const
+	{
+		auto const it = std::lower_bound(
+			plugins_.begin(),
+			plugins_.end(),
+			name,
+			[](PluginPtr const & plugin, std::string_view const key)
+			{ return plugin->name < key; });
+		if (it == plugins_.end() || (*it)->name != name || !(*it)->loader)
+			return nullptr;
+		return &*(*it)->loader;
+	}
+
+	/**
+	 * Find the plugin providing the suite for a handle type.
+	 *
+	 * @tparam Handle Opaque handle type.
+	 * @return Loader of the plugin, or `nullptr` if no plugin provides the suite.
+	 */
+	template <class Handle>
+	[[nodiscard]] Loader const * find() const
+	{
+		std::size_t const slot = detail::suite_slot<Handle>();
+		if (slot >= providers_.size() || providers_[slot] == knone)
+			return nullptr;
+		return &*plugins_[providers_[slot]]->loader;
+	}
+
+	/**
+	 * Instantiate an adapter class around the suite of the plugin providing its handle type.
+	 *
+	 * @tparam Adapter client::HandleAdapter type to instantiate.
+	 * @tparam Args Additional argument types to pass to Adapter constructor.
+	 * @param args Additional arguments to pass to Adapter constructor.
+	 * @throw std::out_of_range if no plugin provides the suite.
+	 * @return Adapter instance.
+	 */
+	template <class Adapter, typename... Args>
+	Adapter make_adapter(Args &&... args) const
+	{
+		Loader const * loader = find<typename Adapter::Handle>();
+		if (loader == nullptr)
+			detail::raise<std::out_of_range>("No plugin provides the suite of adapter");
+		return loader->make_adapter<Adapter>(std::forward<Args>(args)...);
+	}
+
+private:
+	static constexpr std::size_t knone = static_cast<std::size_t>(-1);
+
+	static bool is_plugin_extension(std::string const & extension)
+	{
+		return extension == ".so" || extension == ".dylib";
+	}
+
+	static std::string name_of(std::filesystem::path const & path)
+	{
+		std::string name = path.stem().string();
+		if (name.rfind("lib", 0) == 0)
+			name.erase(0, 3);
+		return name;
+	}
+
+	template <class... Adapters, class... Names>
+	void load_plugin(Plugin & plugin, Names const... suite_factory_names) const noexcept
+	{
+		using Clock = std::chrono::steady_clock;
+		auto const start = Clock::now();
+#if CPPCAPI_EXCEPTIONS
+		try
+		{
+#endif
+			Loader & loader = plugin.loader.emplace(plugin.path.c_str(), mode_);
+			(bind_if_exported<Adapters>(plugin, loader, suite_factory_names), ...);
+#if CPPCAPI_EXCEPTIONS
+		}
+		catch (std::exception const & ex)
+		{
+			plugin.loader.reset();
+			plugin.provided.clear();
+			plugin.error = ex.what();
+		}
+#endif
+		plugin.load_time = Clock::now() - start;
+	}
+
+	template <class Adapter>
+	static void bind_if_exported(Plugin & plugin, Loader & loader, char const * suite_factory_name)
+	{
+		if (!loader.has_symbol(suite_factory_name))
+			return;
+		loader.bind_suites<Adapter>(suite_factory_name);
+		plugin.provided.push_back(detail::suite_slot<typename Adapter::Handle>());
+	}
+
+	void index_providers()
+	{
+		providers_.clear();
+		for (std::size_t idx = 0; idx < plugins_.size(); ++idx)
+		{
+			for (std::size_t const slot : plugins_[idx]->provided)
+			{
+				if (slot >= providers_.size())
+					providers_.resize(slot + 1, knone);
+				if (providers_[slot] == knone)
+					providers_[slot] = idx;
+			}
+		}
+	}
+
+	int mode_;
+	std::size_t num_threads_;
+	std::vector<PluginPtr> plugins_;
+	/// Index into plugins_ of the plugin providing each handle type, by detail::suite_slot.
+	std::vector<std::size_t> providers_;
+};
+}  // namespace cppcapi
@@ -0,0 +1,362 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the Reloader used for swapping a plugin for a new build without restarting the host.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "loader.hpp"
+
+namespace cppcapi
+{
+/// Timing and outcome of a Reloader::reload.
+struct ReloadTiming
+{
+	/// Time during which callers creating adapters may retry, whilst the new plugin is published.
+	std::chrono::nanoseconds pause{};
+	/// Time waiting for adapters being created from the previous plugin to finish.
+	std::chrono::nanoseconds drain{};
+	/// Number of previous plugins still loaded, since adapters created from them are outstanding.
+	std::size_t num_retained{};
+};
+
+namespace detail
+{
+/// A plugin loaded by a Reloader, along with counts of its users.
+struct Generation
+{
+	Generation(Loader && loader_, std::uint64_t const epoch_)
+		: loader{std::move(loader_)}, epoch{epoch_}
+	{
+	}
+
+	/// Loader of the plugin, reset once retired and unused.
+	std::optional<Loader> loader;
+	/// Number of reloads before this plugin was loaded.
+	std::uint64_t const epoch;
+	/// Number of adapters currently being created from the plugin.
+	std::atomic<std::size_t> in_flight{0};
+	/// Number of outstanding adapters created from the plugin.
+	std::atomic<std::size_t> handles{0};
+	/// Whether the plugin has been replaced by a reload.
+	std::atomic<bool> retired{false};
+};
+
+/// Count of an adapter against its Generation, keeping the plugin loaded.
+class GenerationPin
+{
+public:
+	explicit GenerationPin(Generation & generation) noexcept : generation_{&generation}
+	{
+		generation_->handles.fetch_add(1);
+	}
+
+	GenerationPin(GenerationPin const &) = delete;
+	GenerationPin & operator=(GenerationPin const &) = delete;
+	GenerationPin & operator=(GenerationPin &&) = delete;
+
+	GenerationPin(GenerationPin && other) noexcept : generation_{other.generation_}
+	{
+		other.generation_ = nullptr;
+	}
+
+	~GenerationPin()
+	{
+		if (generation_ != nullptr)
+			generation_->handles.fetch_sub(1);
+	}
+
+	/// Generation counted against, or `nullptr` if moved from.
+	[[nodiscard]] Generation * generation() const noexcept
+	{
+		return generation_;
+	}
+
+private:
+	Generation * generation_;
+};
+}  // namespace detail
+
+/**
+ * Adapter created by a Reloader, keeping the plugin it was created from loaded until destroyed.
+ *
+ * The handle wrapped by the adapter belongs to the plugin that created it, so cannot move to a
+ * new build. Instead, once stale, callers can replace the adapter with one from the new build.
+ *
+ * Only the adapter created by the Reloader is counted. Other adapters wrapping handles from the
+ * same plugin, e.g. copies of the adapter or handles returned from its calls, are not, so the
+ * plugin may be unloaded whilst they remain. Use `adopt` to have them keep the plugin loaded too.
+ *
+ * A moved-from Reloadable no longer keeps a plugin loaded, so counts as stale.
+ *
+ * @tparam Adapter client::HandleAdapter type.
+ */
+template <class Adapter>
+class Reloadable
+{
+public:
+	Reloadable(Reloadable &&) = default;
+	Reloadable(Reloadable const &) = delete;
+	Reloadable & operator=(Reloadable const &) = delete;
+	Reloadable & operator=(Reloadable &&) = delete;
+	~Reloadable() = default;
+
+	Adapter * operator->() noexcept
+	{
+		return &adapter_;
+	}
+
+	Adapter const * operator->() const noexcept
+	{
+		return &adapter_;
+	}
+
+	Adapter & operator*() noexcept
+	{
+		return adapter_;
+	}
+
+	Adapter const & operator*() const noexcept
+	{
+		return adapter_;
+	}
+
+	/// Epoch of the plugin the adapter was created from, see Reloader::epoch.
+	[[nodiscard]] std::uint64_t epoch() const noexcept
+	{
+		return epoch_;
+	}
+
+	/// Whether the plugin the adapter was created from has since been replaced by a reload.
+	[[nodiscard]] bool stale() const noexcept
+	{
+		detail::Generation const * const generation = pin_.generation();
+		return generation == nullptr || generation->retired.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Count another adapter wrapping a handle from the same plugin as this one, so that it also
+	 * keeps the plugin loaded until destroyed.
+	 *
+	 * The plugin is kept loaded by this Reloadable in the meantime, so adopt the adapter before
+	 * this Reloadable is destroyed, e.g. immediately after the call that returned it.
+	 *
+	 * @tparam Child client::HandleAdapter type.
+	 * @param child Adapter created via this one, e.g. a copy or a handle returned from a call.
+	 * @throw std::logic_error if this Reloadable has been moved from.
+	 * @return Adapter keeping the plugin loaded independently of this one.
+	 */
+	template <class Child>
+	Reloadable<Child> adopt(Child child) const
+	{
+		detail::Generation * const generation = pin_.generation();
+		if (generation == nullptr)
+			detail::raise<std::logic_error>("Cannot adopt an adapter via a moved-from Reloadable");
+		return Reloadable<Child>{*generation, std::move(child)};
+	}
+
+private:
+	friend class Reloader;
+	template <class>
+	friend class Reloadable;
+
+	Reloadable(detail::Generation & generation, Adapter && adapter)
+		: pin_{generation}, epoch_{generation.epoch}, adapter_{std::move(adapter)}
+	{
+	}
+
+	// Declared first so destroyed last, after the adapter has released its handle.
+	detail::GenerationPin pin_;
+	// Copied, since a moved-from pin no longer refers to its Generation.
+	std::uint64_t epoch_;
+	Adapter adapter_;
+};
+
+/**
+ * Owner of a plugin that can be swapped for a new build whilst the host is running.
+ *
+ * Adapters are created from whichever plugin is current, and keep that plugin loaded until they
+ * are destroyed, see Reloadable. Adapters subsequently created via them must be adopted to do
+ * the same, see Reloadable::adopt. A reload publishes the new plugin with a single atomic swap, so
+ * never blocks callers, then waits for adapters still being created from the previous plugin to
+ * finish. Previous plugins are only unloaded once no adapters created from them are outstanding.
+ *
+ * Note that loading a DSO that is already loaded gives the same instance, so a new build must
+ * either be at a different path or loaded in isolation, see Loader::load_isolated.
+ */
+class Reloader
+{
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param loader Loader of the initial plugin, at epoch 0.
+	 */
+	explicit Reloader(Loader loader)
+	{
+		generations_.push_back(std::make_unique<detail::Generation>(std::move(loader), 0));
+		current_.store(generations_.back().get());
+	}
+
+	Reloader(Reloader const &) = delete;
+	Reloader(Reloader &&) = delete;
+	Reloader & operator=(Reloader const &) = delete;
+	Reloader & operator=(Reloader &&) = delete;
+
+	/// Unload all plugins, except those with outstanding adapters, which are leaked instead.
+	~Reloader()
+	{
+		for (auto & generation : generations_)
+			if (!is_unused(*generation))
+				static_cast<void>(generation.release());  // NOLINT(bugprone-unused-return-value)
+	}
+
+	/**
+	 * Load a suite factory from the current plugin and instantiate an adapter class around it,
+	 * see Loader::load_adapter.
+	 *
+	 * @tparam Adapter client::HandleAdapter type to instantiate.
+	 * @tparam Args Additional argument types to pass to Adapter constructor.
+	 * @param suite_factory_name Symbol name in DSO of suite factory function.
+	 * @param args Additional arguments to pass to Adapter constructor.
+	 * @return Adapter instance, keeping the current plugin loaded.
+	 */
+	template <class Adapter, typename... Args>
+	Reloadable<Adapter> make_adapter(char const * suite_factory_name, Args &&... args)
+	{
+		InFlight const in_flight{*this};
+		detail::Generation & generation = in_flight.generation();
+		return Reloadable<Adapter>{
+			generation,
+			generation.loader->load_adapter<Adapter>(
+				suite_factory_name, std::forward<Args>(args)...)};
+	}
+
+	/**
+	 * Replace the current plugin with a new build.
+	 *
+	 * Adapters created from the previous plugin remain usable, and keep it loaded until destroyed.
+	 *
+	 * @param loader Loader of the new build, e.g. loaded eagerly beforehand, so the cost of loading
+	 * doesn't delay the swap.
+	 * @return Timing of the swap and number of previous plugins still loaded.
+	 */
+	ReloadTiming reload(Loader loader)
+	{
+		using Clock = std::chrono::steady_clock;
+		std::lock_guard const lock{mutex_};
+		ReloadTiming timing;
+
+		detail::Generation * const previous = current_.load();
+		generations_.push_back(
+			std::make_unique<detail::Generation>(std::move(loader), previous->epoch + 1));
+
+		auto const start = Clock::now();
+		current_.store(generations_.back().get());
+		previous->retired.store(true, std::memory_order_release);
+		auto const published = Clock::now();
+
+		// Callers that entered the previous plugin before the swap finish creating their adapter.
+		while (previous->in_flight.load() != 0) std::this_thread::yield();
+		auto const drained = Clock::now();
+
+		timing.pause = published - start;
+		timing.drain = drained - published;
+		timing.num_retained = collect_locked();
+		return timing;
+	}
+
+	/**
+	 * Unload previous plugins that have no outstanding adapters.
+	 *
+	 * @return Number of previous plugins still loaded.
+	 */
+	std::size_t collect()
+	{
+		std::lock_guard const lock{mutex_};
+		return collect_locked();
+	}
+
+	/// Number of reloads, i.e. the epoch of the current plugin.
+	[[nodiscard]] std::uint64_t epoch() const noexcept
+	{
+		return current_.load()->epoch;
+	}
+
+private:
+	/// Count of a caller using the current plugin, retrying if it is concurrently replaced.
+	class InFlight
+	{
+	public:
+		explicit InFlight(Reloader const & reloader) noexcept
+		{
+			while (true)
+			{
+				generation_ = reloader.current_.load();
+				generation_->in_flight.fetch_add(1);
+				// If swapped before we were counted, the reload may not wait for us.
+				if (reloader.current_.load() == generation_)
+					return;
+				generation_->in_flight.fetch_sub(1);
+			}
+		}
+
+		InFlight(InFlight const &) = delete;
+		InFlight(InFlight &&) = delete;
+		InFlight & operator=(InFlight const &) = delete;
+		InFlight & operator=(InFlight &&) = delete;
+
+		~InFlight()
+		{
+			generation_->in_flight.fetch_sub(1);
+		}
+
+		[[nodiscard]] detail::Generation & generation() const noexcept
+		{
+			return *generation_;
+		}
+
+	private:
+		detail::Generation * generation_{};
+	};
+
+	static bool is_unused(detail::Generation const & generation) noexcept
+	{
+		// Adapters are counted before leaving flight, so check in this order.
+		return generation.in_flight.load() == 0 && generation.handles.load() == 0;
+	}
+
+	std::size_t collect_locked()
+	{
+		std::size_t num_retained = 0;
+		for (auto & generation : generations_)
+		{
+			if (!generation->retired.load() || !generation->loader)
+				continue;
+			if (is_unused(*generation))
+				generation->loader.reset();
+			else
+				++num_retained;
+		}
+		return num_retained;
+	}
+
+	/// All plugins loaded, kept (once unloaded, just their counts) so callers can't dangle.
+	std::vector<std::unique_ptr<detail::Generation>> generations_;
+	std::atomic<detail::Generation *> current_{nullptr};
+	std::mutex mutex_;
+};
+}  // namespace cppcapi
@@ -0,0 +1,79 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the CallContext used by services to check the deadline and cancellation of a call.
+ */
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include "../error_map.hpp"
+#include "../interface.h"
+
+namespace cppcapi::service
+{
+/**
+ * Non-owning view of a cppcapi_CallContext given to a suite function.
+ *
+ * Implicitly constructible from `cppcapi_CallContext const *`, so a decorated callable can simply
+ * take a `CallContext` parameter in place of the C context argument. The SuiteDecorator also checks
+ * the context before invoking the callable.
+ */
+class CallContext
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Construct wrapping a C call context.
+	 *
+	 * @param context C call context, or null for no deadline and no cancellation.
+	 */
+	// NOLINTNEXTLINE(google-explicit-constructor)
+	CallContext(cppcapi_CallContext const * context) noexcept
+		: context_{context}
+	{
+	}
+
+	/// Deadline of the call, if any.
+	[[nodiscard]] std::optional<Clock::time_point> deadline() const noexcept
+	{
+		if (context_ == nullptr || context_->deadline_ns == cppcapi_no_deadline)
+			return std::nullopt;
+		return Clock::time_point{std::chrono::duration_cast<Clock::duration>(
+			std::chrono::nanoseconds{context_->deadline_ns})};
+	}
+
+	/// Whether the deadline of the call has passed.
+	[[nodiscard]] bool expired() const noexcept
+	{
+		auto const call_deadline = deadline();
+		return call_deadline && Clock::now() >= *call_deadline;
+	}
+
+	/// Whether the call has been cancelled.
+	[[nodiscard]] bool cancelled() const noexcept
+	{
+		return context_ != nullptr && context_->is_cancelled != nullptr &&
+			context_->is_cancelled(context_->data) != 0;
+	}
+
+	/**
+	 * Throw if the call has been cancelled or its deadline has passed.
+	 *
+	 * The thrown Cancelled or DeadlineExceeded exception is converted to cppcapi_cancelled or
+	 * cppcapi_deadline_exceeded, respectively, by the ErrorMap.
+	 */
+	void throw_if_aborted() const
+	{
+		if (cancelled())
+			cppcapi::detail::raise<Cancelled>("Call cancelled");
+		if (expired())
+			cppcapi::detail::raise<DeadlineExceeded>("Call deadline exceeded");
+	}
+
+private:
+	cppcapi_CallContext const * context_;
+};
+}  // namespace cppcapi::service
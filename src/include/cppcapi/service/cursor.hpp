@@ -0,0 +1,74 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the state behind cursor handles used by services to expose ranges to clients.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace cppcapi::service::detail
+{
+/**
+ * Type-erased state of an open cursor, referenced by an opaque cursor handle.
+ *
+ * Erasing the range type allows the `next_chunk` and `close` suite functions to be shared by all
+ * cursors over the same element type.
+ */
+class CursorBase
+{
+public:
+	CursorBase() = default;
+	CursorBase(CursorBase const &) = delete;
+	CursorBase(CursorBase &&) = delete;
+	CursorBase & operator=(CursorBase const &) = delete;
+	CursorBase & operator=(CursorBase &&) = delete;
+	virtual ~CursorBase() = default;
+
+	/**
+	 * Copy the next elements of the range into the output array.
+	 *
+	 * @param out Pointer to array of C elements.
+	 * @param capacity Size of `out` array.
+	 * @return Number of elements written, which is less than `capacity` only if the end of the
+	 * range has been reached.
+	 */
+	virtual std::size_t fill(void * out, std::size_t capacity) = 0;
+};
+
+/**
+ * Cursor over a range returned by a decorated function.
+ *
+ * If the range was returned by reference then it is referenced by the cursor, so must outlive it
+ * and must not be modified while the cursor is open. Otherwise the range is moved into the cursor.
+ *
+ * @tparam Range Type returned by the decorated function, possibly a reference.
+ * @tparam Element C type of elements written to the output array.
+ * @tparam Projection Stateless callable converting an element of the range to an Element.
+ */
+template <class Range, class Element, class Projection>
+class RangeCursor final : public CursorBase
+{
+public:
+	explicit RangeCursor(Range && range)
+		: range_{std::forward<Range>(range)}, it_{std::begin(range_)}, end_{std::end(range_)}
+	{
+	}
+
+	std::size_t fill(void * out, std::size_t const capacity) override
+	{
+		auto * elements = static_cast<Element *>(out);
+		std::size_t count = 0;
+		for (; count < capacity && it_ != end_; ++count, ++it_)
+			elements[count] = Projection{}(*it_);
+		return count;
+	}
+
+private:
+	Range range_;
+	decltype(std::begin(std::declval<Range &>())) it_;
+	decltype(std::end(std::declval<Range &>())) end_;
+};
+}  // namespace cppcapi::service::detail
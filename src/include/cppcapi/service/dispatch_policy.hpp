@@ -0,0 +1,141 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains dispatch policies that services can associate with handles via HandleTraits.
+ */
+#pragma once
+
+#include <utility>
+
+namespace cppcapi::service
+{
+/**
+ * Dispatch policy where every instance associated with a handle type shares the same suite.
+ *
+ * This is the default policy, where the handle points directly at the instance.
+ */
+struct StaticDispatch
+{
+	static constexpr bool dynamic = false;
+	static constexpr bool is_subclass = false;
+
+	template <class Class>
+	using interface_t = Class;
+};
+
+/**
+ * Dispatch policy where each instance carries a pointer to the suite of its dynamic type.
+ *
+ * The native class associated with the handle is an interface (typically abstract) base class.
+ * Each concrete subclass gets its own function pointer suite, generated from a single suite
+ * definition via SuiteDecorator::Subclass. Functions in a subclass suite access the instance as
+ * its concrete type, so no C++ virtual call is needed on top of the C function pointer call.
+ *
+ * The handle points at a header whose first member is a pointer to the subclass suite, allowing
+ * clients to find the suite of any instance given only its handle, see `CPPCAPI_DYNAMIC_SUITE`
+ * and client::DynamicHandleTraits.
+ *
+ * Only supported for HandleOwnershipTag::OwnedByClient handles, since the header must be
+ * allocated along with the instance.
+ *
+ * @tparam TSuite Function pointer suite shared by all subclasses.
+ */
+template <class TSuite>
+struct DynamicDispatch
+{
+	using Suite = TSuite;
+	static constexpr bool dynamic = true;
+	/// Whether the concrete class, and hence its suite, is known. See SuiteDecorator::Subclass.
+	static constexpr bool is_subclass = false;
+
+	template <class Class>
+	using interface_t = Class;
+};
+
+namespace detail
+{
+/**
+ * DynamicDispatch policy as seen by the suite of a particular subclass.
+ *
+ * @tparam Suite Function pointer suite shared by all subclasses.
+ * @tparam Interface Native class associated with the handle in the HandleMap.
+ * @tparam Tsuite_factory Function returning a pointer to the suite of the subclass.
+ */
+template <class Suite, class Interface, auto Tsuite_factory>
+struct SubclassDispatch : DynamicDispatch<Suite>
+{
+	static constexpr bool is_subclass = true;
+	static constexpr auto suite_factory = Tsuite_factory;
+
+	template <class Class>
+	using interface_t = Interface;
+};
+
+/**
+ * Header of instances referenced by handles using DynamicDispatch.
+ *
+ * Only the first member forms part of the C interface.
+ *
+ * @tparam Suite Function pointer suite shared by all subclasses.
+ * @tparam Interface Native class associated with the handle in the HandleMap.
+ */
+template <class Suite, class Interface>
+struct DynamicHeader
+{
+	/// Suite of the dynamic type of the instance.
+	Suite const * suite;
+	/// Instance as its interface class, for conversions that do not know the dynamic type.
+	Interface * self;
+};
+
+/**
+ * Heap-allocated instance with a header, as referenced by handles using DynamicDispatch.
+ *
+ * @tparam Suite Function pointer suite shared by all subclasses.
+ * @tparam Interface Native class associated with the handle in the HandleMap.
+ * @tparam Class Concrete subclass.
+ */
+template <class Suite, class Interface, class Class>
+struct DynamicInstance
+{
+	template <typename... Args>
+	explicit DynamicInstance(Suite const * suite, Args &&... args)
+		: header{suite, nullptr}, instance{std::forward<Args>(args)...}
+	{
+		header.self = &instance;
+	}
+
+	/// Construct the instance from the value returned by a factory, without a copy or move.
+	template <typename Factory>
+	DynamicInstance(Suite const * suite, std::in_place_t, Factory & factory)
+		: header{suite, nullptr}, instance(factory())
+	{
+		header.self = &instance;
+	}
+
+	DynamicHeader<Suite, Interface> header;
+	Class instance;
+};
+}  // namespace detail
+}  // namespace cppcapi::service
+
+namespace cppcapi
+{
+/**
+ * Get the function pointer suite of the dynamic type of an instance, given its handle.
+ *
+ * C++ equivalent of `CPPCAPI_DYNAMIC_SUITE`, so only valid for handles whose instances carry the
+ * suite of their dynamic type, e.g. using service::DynamicDispatch.
+ *
+ * @tparam Suite Function pointer suite shared by all subclasses.
+ * @tparam Handle Opaque handle type.
+ * @param handle Opaque handle to an instance, which must not be null.
+ * @return Suite of the instance's dynamic type.
+ */
+template <class Suite, class Handle>
+Suite const * dynamic_suite(Handle const handle) noexcept
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	return *reinterpret_cast<Suite const * const *>(handle);
+}
+}  // namespace cppcapi
@@ -6,7 +6,13 @@
 
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
 
+#include "../client/borrowed.hpp"
 #include "../error_map.hpp"
 #include "../interface.h"
 #include "../pointers.hpp"
@@ -15,6 +21,68 @@
 namespace cppcapi::service
 {
 
+namespace detail
+{
+/**
+ * Storage for an instance constructed from the value returned by a factory, for construction
+ * sites that only accept constructor arguments, e.g. `make_shared`.
+ *
+ * The instance is a member initialized directly from the factory's prvalue result, so is
+ * constructed in place via guaranteed copy elision. A `shared_ptr` to the instance can then alias
+ * a `shared_ptr` to this storage.
+ *
+ * @tparam Class Type to construct.
+ */
+template <class Class>
+struct EmplacedInstance
+{
+	/// Construct the instance from the value returned by a factory, without a copy or move.
+	template <typename Factory>
+	EmplacedInstance(std::in_place_t, Factory & factory) : instance(factory())
+	{
+	}
+
+	Class instance;
+};
+
+/**
+ * Wrapper deferring construction of an instance to a factory, for construction sites that only
+ * accept constructor arguments, e.g. `make_shared`.
+ *
+ * Constructing a `Class` from an Emplacer selects the conversion operator, whose prvalue result
+ * then initializes the new object. Unlike EmplacedInstance, eliding the move is not guaranteed,
+ * though common compilers do so (CWG2327).
+ *
+ * @tparam Class Type to construct.
+ * @tparam Factory Callable returning a `Class` by value.
+ */
+template <class Class, class Factory>
+struct Emplacer
+{
+	operator Class() const	// NOLINT(google-explicit-constructor)
+	{
+		return factory();
+	}
+
+	Factory & factory;
+};
+
+/**
+ * Whether a class derives from `std::enable_shared_from_this`, so must be the object owned by its
+ * `shared_ptr` rather than aliased, for `shared_from_this` to work.
+ */
+template <class Class, typename = void>
+struct is_shared_from_this : std::false_type
+{
+};
+
+template <class Class>
+struct is_shared_from_this<Class, std::void_t<decltype(std::declval<Class &>().weak_from_this())>>
+	: std::true_type
+{
+};
+}  // namespace detail
+
 /**
  * Utility to static_assert that a given handle maps to either a native class or adapter.
  *
@@ -53,10 +121,32 @@ private:
 	using Adapter = typename TClientHandleMap::template class_from_handle<Handle>;
 	static constexpr HandleOwnershipTag ptr_type_tag =
 		TServiceHandleMap::template ownership_tag_from_handle<Handle>();
-
+	using Sync = typename TServiceHandleMap::template sync_from_handle<Handle>;
+	using Dispatch = typename TServiceHandleMap::template dispatch_from_handle<Handle>;
+
+	/// Heap-allocated storage type of instances with an embedded lock.
+	template <class TSync>
+	using synchronized_t = detail::SynchronizedInstance<Class, typename TSync::Mutex>;
+
+	/// Header of instances carrying the suite of their dynamic type.
+	template <class TDispatch>
+	using dynamic_header_t = detail::
+		DynamicHeader<typename TDispatch::Suite, typename TDispatch::template interface_t<Class>>;
+
+	/// Heap-allocated storage type of instances carrying the suite of their dynamic type.
+	template <class TDispatch>
+	using dynamic_t = detail::DynamicInstance<
+		typename TDispatch::Suite,
+		typename TDispatch::template interface_t<Class>,
+		Class>;
+
+	/// Manager of other handles, e.g. constructor arguments, so never bound to a subclass.
 	template <typename Handle>
-	using OtherHandleManager =
-		HandleManager<Handle, TServiceHandleMap, TClientHandleMap, TErrorMap>;
+	using OtherHandleManager = HandleManager<
+		Handle,
+		detail::interface_handle_map_t<TServiceHandleMap>,
+		TClientHandleMap,
+		TErrorMap>;
 
 public:
 	static constexpr bool is_for_service()
@@ -115,6 +205,11 @@ public:
 	 * If the handle is Shared ownership and the requested C++ type is a shared_ptr to the
 	 * underlying C++ object, a shared_ptr will be returned, rather than the underlying C++ object.
 	 *
+	 * If the handle is wrapped by a client adapter and the requested C++ type is an lvalue
+	 * reference, then the handle is only lent for the duration of the call, so a client::Borrowed
+	 * view is returned that never releases the handle. Otherwise ownership of the handle is
+	 * transferred to the returned adapter.
+	 *
 	 * If not given a handle, then the C and C++ types must be the same (or convertible).
 	 *
 	 * @tparam CppType
@@ -130,6 +225,10 @@ public:
 		{
 			return to_ptr(arg);
 		}
+		else if constexpr (is_for_client() && std::is_lvalue_reference_v<CppType>)
+		{
+			return client::Borrowed<Adapter>{arg};
+		}
 		else
 		{
 			static_assert(
@@ -161,7 +260,19 @@ public:
 
 		if constexpr (is_for_service())
 		{
-			if constexpr (
+			if constexpr (Dispatch::is_subclass)
+			{
+				return (reinterpret_cast<dynamic_t<Dispatch> *>(handle)->instance);
+			}
+			else if constexpr (Dispatch::dynamic)
+			{
+				return *reinterpret_cast<dynamic_header_t<Dispatch> *>(handle)->self;
+			}
+			else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient && Sync::embedded)
+			{
+				return (reinterpret_cast<synchronized_t<Sync> *>(handle)->instance);
+			}
+			else if constexpr (
 				ptr_type_tag == HandleOwnershipTag::OwnedByClient ||
 				ptr_type_tag == HandleOwnershipTag::OwnedByService)
 			{
@@ -207,6 +318,9 @@ public:
 	 * This function is not valid if the HandlePtrTag is `OwnedByService`, since that implies
 	 * a handle should be associated with an existing object rather than creating a new one.
 	 *
+	 * If the handle uses DynamicDispatch, then this is only valid for a subclass, i.e. within the
+	 * suite generated by SuiteDecorator::Subclass.
+	 *
 	 * @tparam Args Argument types to pass to the constructor.
 	 * @param args Arguments to pass to the constructor.
 	 * @return Newly minted opaque handle.
@@ -221,10 +335,20 @@ public:
 			"Cannot make a new instance for service-owned types. Service-owned types should be "
 			"pre-existing instances.");
 
-		if constexpr (ptr_type_tag == HandleOwnershipTag::Shared)
+		if constexpr (Dispatch::dynamic)
+		{
+			assert_is_subclass();
+			return reinterpret_cast<Handle>(
+				new dynamic_t<Dispatch>{Dispatch::suite_factory(), std::forward<Args>(args)...});
+		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::Shared)
 		{
 			return to_handle(cppcapi::make_shared<Class>(std::forward<Args>(args)...));
 		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient && Sync::embedded)
+		{
+			return reinterpret_cast<Handle>(new synchronized_t<Sync>{std::forward<Args>(args)...});
+		}
 		else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient)
 		{
 			return reinterpret_cast<Handle>(new Class{std::forward<Args>(args)...});
@@ -236,6 +360,67 @@ public:
 		}
 	}
 
+	/**
+	 * Construct a new instance of our Class type from the value returned by a factory, directly in
+	 * the storage associated with a new Handle.
+	 *
+	 * Unlike `make_to_handle(factory())`, which must materialize the returned value before moving
+	 * it into the handle's storage, the factory's return value is constructed in place via
+	 * guaranteed copy elision.
+	 *
+	 * Shared instances are held via an aliasing `shared_ptr`, except for classes deriving from
+	 * `std::enable_shared_from_this`, which must be the object owned by the `shared_ptr`. These are
+	 * constructed via a conversion, so the move is only elided where the compiler supports it.
+	 *
+	 * Ownership is determined as for `make_to_handle`.
+	 *
+	 * @tparam Factory Type of callable returning a `Class` by value.
+	 * @param factory Callable to invoke exactly once.
+	 * @return Newly minted opaque handle.
+	 */
+	template <typename Factory>
+	static Handle emplace_to_handle(Factory && factory)
+	{
+		static_assert(
+			!is_for_client(), "Cannot create a handle to a new instance from the client.");
+		static_assert(
+			!is_owned_by_service(),
+			"Cannot make a new instance for service-owned types. Service-owned types should be "
+			"pre-existing instances.");
+
+		if constexpr (Dispatch::dynamic)
+		{
+			assert_is_subclass();
+			return reinterpret_cast<Handle>(
+				new dynamic_t<Dispatch>{Dispatch::suite_factory(), std::in_place, factory});
+		}
+		else if constexpr (
+			ptr_type_tag == HandleOwnershipTag::Shared && detail::is_shared_from_this<Class>::value)
+		{
+			using Emplacer = detail::Emplacer<std::remove_const_t<Class>, Factory>;
+			return to_handle(cppcapi::make_shared<Class>(Emplacer{factory}));
+		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::Shared)
+		{
+			auto const emplaced = cppcapi::make_shared<
+				detail::EmplacedInstance<std::remove_const_t<Class>>>(std::in_place, factory);
+			return to_handle(SharedPtr<Class>{emplaced, &emplaced->instance});
+		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient && Sync::embedded)
+		{
+			return reinterpret_cast<Handle>(new synchronized_t<Sync>{std::in_place, factory});
+		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient)
+		{
+			return reinterpret_cast<Handle>(new Class(factory()));
+		}
+		// Native type.
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::Unrecognized)
+		{
+			return factory();
+		}
+	}
+
 	/**
 	 * Create a handle associated with a pre-existing instance.
 	 *
@@ -377,6 +562,9 @@ public:
 	 * If `OwnedByClient` then the object is destroyed. If `Shared` then the reference count is
 	 * decremented, potentially destroying the object.
 	 *
+	 * If the handle uses DynamicDispatch and the concrete class is not known, then the `release`
+	 * function of the instance's own suite is called.
+	 *
 	 * @param handle Handle to release.
 	 */
 	static void release(Handle handle)
@@ -390,14 +578,71 @@ public:
 			"Cannot release a handle aliasing a temporary. Are you missing an entry in your "
 			"HandleMaps?");
 
-		if constexpr (ptr_type_tag == HandleOwnershipTag::Shared)
+		if constexpr (Dispatch::is_subclass)
+		{
+			delete reinterpret_cast<dynamic_t<Dispatch> *>(handle);
+		}
+		else if constexpr (Dispatch::dynamic)
+		{
+			reinterpret_cast<dynamic_header_t<Dispatch> *>(handle)->suite->release(handle);
+		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::Shared)
 		{
 			delete reinterpret_cast<SharedPtr<Class> *>(handle);
 		}
+		else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient && Sync::embedded)
+		{
+			delete reinterpret_cast<synchronized_t<Sync> *>(handle);
+		}
 		else if constexpr (ptr_type_tag == HandleOwnershipTag::OwnedByClient)
 		{
 			delete reinterpret_cast<Class *>(handle);
 		}
 	}
+
+	/**
+	 * Lock the instance associated with a handle, according to the synchronization policy in our
+	 * HandleTraits.
+	 *
+	 * @tparam exclusive Whether to take an exclusive (write) lock rather than a shared (read) lock.
+	 * @param handle Handle to instance to lock.
+	 * @return Lock guard, or an empty guard if the handle has no synchronization policy.
+	 */
+	template <bool exclusive>
+	static auto lock(Handle handle)
+	{
+		if constexpr (!Sync::enabled)
+		{
+			return detail::NoLock{};
+		}
+		else
+		{
+			auto & mutex = [&]() -> typename Sync::Mutex &
+			{
+				if constexpr (Sync::embedded)
+					return reinterpret_cast<synchronized_t<Sync> *>(handle)->mutex;
+				else if constexpr (Dispatch::dynamic)
+					// Lock by interface address, so base and subclass suites agree.
+					return Sync::mutex_for(
+						reinterpret_cast<dynamic_header_t<Dispatch> *>(handle)->self);
+				else
+					return Sync::mutex_for(std::addressof(to_instance(handle)));
+			}();
+
+			if constexpr (exclusive)
+				return std::unique_lock{mutex};
+			else
+				return std::shared_lock{mutex};
+		}
+	}
+
+private:
+	static constexpr void assert_is_subclass()
+	{
+		static_assert(
+			Dispatch::is_subclass,
+			"Instances of handles using DynamicDispatch must be created by a subclass suite, see "
+			"SuiteDecorator::Subclass");
+	}
 };
 }  // namespace cppcapi::service
@@ -5,6 +5,11 @@
  */
 #pragma once
 
+#include <type_traits>
+
+#include "dispatch_policy.hpp"
+#include "sync_policy.hpp"
+
 namespace cppcapi::service
 {
 
@@ -23,13 +28,34 @@ enum class HandleOwnershipTag
  * @tparam THandle Type of opaque handle.
  * @tparam TClass Native class associated with handle.
  * @tparam Townership_tag Ownership model tag.
+ * @tparam TSync Synchronization policy for calls to decorated suite functions, e.g. EmbeddedLock
+ * or StripedLock. Defaults to NoSync.
+ * @tparam TDispatch Dispatch policy, i.e. DynamicDispatch if instances of subclasses of TClass
+ * carry the suite of their dynamic type. Defaults to StaticDispatch.
  */
-template <class THandle, class TClass, HandleOwnershipTag Townership_tag>
+template <
+	class THandle,
+	class TClass,
+	HandleOwnershipTag Townership_tag,
+	class TSync = NoSync,
+	class TDispatch = StaticDispatch>
 struct HandleTraits
 {
 	using Handle = THandle;
 	using Class = TClass;
 	static constexpr HandleOwnershipTag ownership_tag = Townership_tag;
+	using Sync = TSync;
+	using Dispatch = TDispatch;
+
+	static_assert(
+		!TSync::embedded || Townership_tag == HandleOwnershipTag::OwnedByClient,
+		"Embedded locks are only supported for OwnedByClient handles, use StripedLock instead");
+	static_assert(
+		!TDispatch::dynamic || Townership_tag == HandleOwnershipTag::OwnedByClient,
+		"Dynamic dispatch is only supported for OwnedByClient handles");
+	static_assert(
+		!TDispatch::dynamic || !TSync::embedded,
+		"Dynamic dispatch cannot be combined with embedded locks, use StripedLock instead");
 };
 
 /**
@@ -54,6 +80,28 @@ struct fallback_ownership_tag_t : std::false_type
 	static constexpr auto type = HandleOwnershipTag::Unrecognized;
 };
 
+/**
+ * Fallback default to no synchronization.
+ *
+ * @tparam HandleToLookup Ignored.
+ */
+template <class HandleToLookup>
+struct fallback_sync_t : std::false_type
+{
+	using type = NoSync;
+};
+
+/**
+ * Fallback default to static dispatch.
+ *
+ * @tparam HandleToLookup Ignored.
+ */
+template <class HandleToLookup>
+struct fallback_dispatch_t : std::false_type
+{
+	using type = StaticDispatch;
+};
+
 /**
  * Utility to look up the traits of a given opaque handle.
  *
@@ -72,6 +120,14 @@ struct HandleMap
 	using class_from_handle_t = typename std::disjunction<
 		typename HandleMap<Rest>::template class_from_handle_t<HandleToLookup>...>;
 
+	template <class HandleToLookup>
+	using sync_from_handle_t = typename std::disjunction<
+		typename HandleMap<Rest>::template sync_from_handle_t<HandleToLookup>...>;
+
+	template <class HandleToLookup>
+	using dispatch_from_handle_t = typename std::disjunction<
+		typename HandleMap<Rest>::template dispatch_from_handle_t<HandleToLookup>...>;
+
 	/**
 	 * Find the ownership model for the given handle type.
 	 *
@@ -90,6 +146,22 @@ struct HandleMap
 	 */
 	template <class HandleToLookup>
 	using class_from_handle = typename class_from_handle_t<HandleToLookup>::type;
+
+	/**
+	 * Find the synchronization policy associated with the given handle type.
+	 *
+	 * @tparam HandleToLookup Handle type to look up in traits list.
+	 */
+	template <class HandleToLookup>
+	using sync_from_handle = typename sync_from_handle_t<HandleToLookup>::type;
+
+	/**
+	 * Find the dispatch policy associated with the given handle type.
+	 *
+	 * @tparam HandleToLookup Handle type to look up in traits list.
+	 */
+	template <class HandleToLookup>
+	using dispatch_from_handle = typename dispatch_from_handle_t<HandleToLookup>::type;
 };
 
 /**
@@ -108,6 +180,10 @@ struct HandleMap<Traits>
 	using Class = typename Traits::Class;
 	/// Hoist ownership tag from traits.
 	static constexpr HandleOwnershipTag ownership_tag = Traits::ownership_tag;
+	/// Hoist synchronization policy from traits.
+	using Sync = typename Traits::Sync;
+	/// Hoist dispatch policy from traits.
+	using Dispatch = typename Traits::Dispatch;
 
 private:
 	template <class Other>
@@ -122,6 +198,18 @@ private:
 		using type = Class;
 	};
 
+	template <class Other>
+	struct this_sync_from_handle_t : std::is_same<Handle, Other>
+	{
+		using type = Sync;
+	};
+
+	template <class Other>
+	struct this_dispatch_from_handle_t : std::is_same<Handle, Other>
+	{
+		using type = Dispatch;
+	};
+
 public:
 	template <class HandleToLookup>
 	using ownership_tag_from_handle_t = typename std::disjunction<
@@ -132,6 +220,15 @@ public:
 	using class_from_handle_t = typename std::
 		disjunction<this_class_from_handle_t<HandleToLookup>, fallback_class_t<HandleToLookup>>;
 
+	template <class HandleToLookup>
+	using sync_from_handle_t = typename std::
+		disjunction<this_sync_from_handle_t<HandleToLookup>, fallback_sync_t<HandleToLookup>>;
+
+	template <class HandleToLookup>
+	using dispatch_from_handle_t = typename std::disjunction<
+		this_dispatch_from_handle_t<HandleToLookup>,
+		fallback_dispatch_t<HandleToLookup>>;
+
 	/**
 	 * Get the ownership tag associated with our Handle if HandleToLookup matches, otherwise
 	 * HandleOwnershipTag::Unrecognized.
@@ -152,6 +249,24 @@ public:
 	 */
 	template <class HandleToLookup>
 	using class_from_handle = typename class_from_handle_t<HandleToLookup>::type;
+
+	/**
+	 * Get the synchronization policy associated with our Handle if HandleToLookup matches,
+	 * otherwise NoSync.
+	 *
+	 * @tparam HandleToLookup Handle type to compare with ours.
+	 */
+	template <class HandleToLookup>
+	using sync_from_handle = typename sync_from_handle_t<HandleToLookup>::type;
+
+	/**
+	 * Get the dispatch policy associated with our Handle if HandleToLookup matches, otherwise
+	 * StaticDispatch.
+	 *
+	 * @tparam HandleToLookup Handle type to compare with ours.
+	 */
+	template <class HandleToLookup>
+	using dispatch_from_handle = typename dispatch_from_handle_t<HandleToLookup>::type;
 };
 
 /**
@@ -181,5 +296,98 @@ struct HandleMap<>
 	 */
 	template <class HandleToLookup>
 	using class_from_handle = typename fallback_class_t<HandleToLookup>::type;
+
+	/**
+	 * Always NoSync.
+	 *
+	 * @tparam HandleToLookup Ignored.
+	 */
+	template <class HandleToLookup>
+	using sync_from_handle = typename fallback_sync_t<HandleToLookup>::type;
+
+	/**
+	 * Always StaticDispatch.
+	 *
+	 * @tparam HandleToLookup Ignored.
+	 */
+	template <class HandleToLookup>
+	using dispatch_from_handle = typename fallback_dispatch_t<HandleToLookup>::type;
+};
+
+namespace detail
+{
+/**
+ * HandleMap overriding the native class of a handle using DynamicDispatch with a concrete
+ * subclass, as used by SuiteDecorator::Subclass.
+ *
+ * All other lookups are forwarded to the original HandleMap.
+ *
+ * @tparam TServiceHandleMap Original HandleMap.
+ * @tparam THandle Handle type using DynamicDispatch.
+ * @tparam TClass Concrete subclass of the native class associated with THandle.
+ * @tparam Tsuite_factory Function returning a pointer to the suite of the subclass.
+ */
+template <class TServiceHandleMap, class THandle, class TClass, auto Tsuite_factory>
+class SubclassHandleMap
+{
+	using Interface = typename TServiceHandleMap::template class_from_handle<THandle>;
+	using BaseDispatch = typename TServiceHandleMap::template dispatch_from_handle<THandle>;
+
+	static_assert(
+		BaseDispatch::dynamic && !BaseDispatch::is_subclass,
+		"Subclass suites can only be generated for handles using DynamicDispatch");
+	static_assert(
+		std::is_base_of_v<Interface, TClass>,
+		"Subclass must derive from the native class associated with the handle");
+
+	template <class HandleToLookup>
+	static constexpr bool is_this = std::is_same_v<HandleToLookup, THandle>;
+
+public:
+	template <class HandleToLookup>
+	static constexpr auto ownership_tag_from_handle()
+	{
+		return TServiceHandleMap::template ownership_tag_from_handle<HandleToLookup>();
+	}
+
+	template <class HandleToLookup>
+	using class_from_handle = std::conditional_t<
+		is_this<HandleToLookup>,
+		TClass,
+		typename TServiceHandleMap::template class_from_handle<HandleToLookup>>;
+
+	template <class HandleToLookup>
+	using sync_from_handle = typename TServiceHandleMap::template sync_from_handle<HandleToLookup>;
+
+	template <class HandleToLookup>
+	using dispatch_from_handle = std::conditional_t<
+		is_this<HandleToLookup>,
+		SubclassDispatch<typename BaseDispatch::Suite, Interface, Tsuite_factory>,
+		typename TServiceHandleMap::template dispatch_from_handle<HandleToLookup>>;
 };
+
+/**
+ * HandleMap to use for handles other than the instance a suite function is bound to.
+ *
+ * A SubclassHandleMap only holds for the instance a subclass suite function is bound to. Other
+ * handles of the same type may refer to instances of any subclass, so must be converted via the
+ * original HandleMap, i.e. to the interface class.
+ *
+ * @tparam TServiceHandleMap HandleMap, possibly a SubclassHandleMap.
+ */
+template <class TServiceHandleMap>
+struct interface_handle_map
+{
+	using type = TServiceHandleMap;
+};
+
+template <class TServiceHandleMap, class THandle, class TClass, auto Tsuite_factory>
+struct interface_handle_map<SubclassHandleMap<TServiceHandleMap, THandle, TClass, Tsuite_factory>>
+{
+	using type = TServiceHandleMap;
+};
+
+template <class TServiceHandleMap>
+using interface_handle_map_t = typename interface_handle_map<TServiceHandleMap>::type;
+}  // namespace detail
 }  // namespace cppcapi::service
\ No newline at end of file
@@ -6,11 +6,24 @@
  */
 #pragma once
 
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
 
+#include "../commands.hpp"
 #include "../error_map.hpp"
+#include "../instrumentation.hpp"
 #include "../interface.h"
+#include "../metadata.hpp"
+#include "../thread_pool.hpp"
+#include "call_context.hpp"
+#include "cursor.hpp"
 #include "handle_manager.hpp"
 #include "handle_map.hpp"
 
@@ -23,14 +36,29 @@ namespace cppcapi::service
  * @tparam TServiceHandleMap service::HandleMap for mapping handles to native classes.
  * @tparam TClientHandleMap client::HandleMap for mapping handles to client adapter classes.
  * @tparam TErrorMap ErrorMap for mapping exceptions to error codes.
+ * @tparam TInstrumentation Policy for gathering call statistics of decorated functions, e.g.
+ * HistogramInstrumentation. Defaults to NullInstrumentation, which gathers nothing.
  */
-template <class THandle, class TServiceHandleMap, class TClientHandleMap, class TErrorMap>
+template <
+	class THandle,
+	class TServiceHandleMap,
+	class TClientHandleMap,
+	class TErrorMap,
+	class TInstrumentation = NullInstrumentation>
 struct SuiteDecorator
 {
 private:
 	template <class Handle>
 	using HandleManager = HandleManager<Handle, TServiceHandleMap, TClientHandleMap, TErrorMap>;
 
+	/// Manager of handles other than the instance a suite function is bound to.
+	template <class Handle>
+	using ArgHandleManager = cppcapi::service::HandleManager<
+		Handle,
+		detail::interface_handle_map_t<TServiceHandleMap>,
+		TClientHandleMap,
+		TErrorMap>;
+
 	using Handle = THandle;
 	using Class = typename TServiceHandleMap::template class_from_handle<Handle>;
 	using Adapter = typename TClientHandleMap::template class_from_handle<Handle>;
@@ -64,6 +92,37 @@ public:
 	template <auto fn>
 	static constexpr free_fn_ptr_t<fn> free_fn_ptr{};
 
+	/**
+	 * Decorator generating the function pointer suite of a concrete subclass, for handles using
+	 * DynamicDispatch.
+	 *
+	 * Handles are converted to the subclass directly, so decorated member functions of the
+	 * subclass are called without a C++ virtual call (provided they are non-virtual or the
+	 * subclass is `final`). Instances created via the subclass suite carry a pointer to that
+	 * suite, so a single suite definition templated on the subclass serves all subclasses, e.g.
+	 *
+	 *     template <class Derived>
+	 *     MySuite const * my_suite()
+	 *     {
+	 *         using Decorator = SuiteDecorator<MyHandle>::Subclass<Derived, &my_suite<Derived>>;
+	 *         static constexpr MySuite suite{
+	 *             &Decorator::create,
+	 *             &Decorator::release,
+	 *             Decorator::decorate(Decorator::mem_fn_ptr<&Derived::my_method>)};
+	 *         return &suite;
+	 *     }
+	 *
+	 * @tparam Derived Concrete subclass of the native class associated with the handle.
+	 * @tparam suite_factory Function returning a pointer to the suite of the subclass.
+	 */
+	template <class Derived, auto suite_factory>
+	using Subclass = SuiteDecorator<
+		Handle,
+		detail::SubclassHandleMap<TServiceHandleMap, Handle, Derived, suite_factory>,
+		TClientHandleMap,
+		TErrorMap,
+		TInstrumentation>;
+
 	/**
 	 * Create a new instance, where the constructor can throw, storing associated handle in
 	 * out-parameter.
@@ -96,6 +155,63 @@ public:
 		HandleManager<Handle>::release(handle);
 	}
 
+	/**
+	 * Mint a new handle to the instance associated with a Shared ownership handle, storing it in
+	 * the out-parameter.
+	 *
+	 * The new handle holds an additional reference to the instance, and must be released
+	 * independently. A suite with a `clone` function allows client adapters to be copied, see
+	 * client::SuiteAdapter.
+	 */
+	static cppcapi_ErrorCode clone(cppcapi_ErrorMessage * err, Handle * out, Handle handle)
+	{
+		static_assert(
+			HandleManager<Handle>::is_shared_ownership(),
+			"Only handles with Shared ownership can be cloned");
+		using Manager = HandleManager<Handle>;
+		return TErrorMap::wrap_exception(
+			*err, [&] { *out = Manager::to_handle(Manager::to_ptr(handle)); });
+	}
+
+	/**
+	 * Adapt a particular constructor of the class associated with the handle to be a factory
+	 * suite function, allowing a suite to expose several named constructors, e.g. `create_from_*`.
+	 *
+	 * Unlike `create`, which forwards the C arguments to whichever constructor accepts them, the
+	 * C arguments are converted to the given C++ parameter types, selecting a single constructor
+	 * overload. Handles are converted to their associated instances as with `decorate`. A C++
+	 * parameter constructible from a `(pointer, size)` pair of C arguments, e.g.
+	 * `std::string_view`, consumes both, but only if there are more C arguments than C++
+	 * parameters remaining.
+	 *
+	 * The instance is constructed directly in the storage associated with the new handle. The
+	 * resulting C function can have any of the factory signatures, i.e. `(cppcapi_ErrorMessage *,
+	 * Handle *, args...) -> cppcapi_ErrorCode`, `(Handle *, args...) -> void` or `(args...) ->
+	 * Handle`.
+	 *
+	 * @tparam CppArgs Parameter types of the constructor overload.
+	 * @return Non-capturing lambda satisfying C function signature.
+	 */
+	template <typename... CppArgs>
+	static constexpr auto decorate_constructor()
+	{
+		assert_is_valid_handle_type<Handle, Class, Adapter>();
+
+		if constexpr (TInstrumentation::enabled)
+		{
+			return [](auto... args)
+			{
+				constexpr auto fn = &call_constructor<std::tuple<CppArgs...>, decltype(args)...>;
+				return call_instrumented<fn>(fn, args...);
+			};
+		}
+		else
+		{
+			return [](auto... args)
+			{ return call_constructor<std::tuple<CppArgs...>, decltype(args)...>(args...); };
+		}
+	}
+
 	/**
 	 * Adapt a suite function to have a more C++-like interface, automatically converting
 	 * handles.
@@ -118,7 +234,7 @@ public:
 	 * @return Non-capturing lambda satisfying C function signature.
 	 */
 	template <typename ReturnHandle = void, auto fn = nullptr>
-	static auto decorate([[maybe_unused]] free_fn_ptr_t<fn> free_fn_ptr_const)
+	static constexpr auto decorate([[maybe_unused]] free_fn_ptr_t<fn> free_fn_ptr_const)
 	{
 		return decorate<fn, ReturnHandle>();
 	}
@@ -142,7 +258,7 @@ public:
 	 * @return Non-capturing lambda satisfying C function signature.
 	 */
 	template <typename ReturnHandle = void, typename Callable = void>
-	static auto decorate([[maybe_unused]] Callable && lambda)
+	static constexpr auto decorate([[maybe_unused]] Callable && lambda)
 	{
 		assert_is_valid_handle_type<Handle, Class, Adapter>();
 
@@ -177,13 +293,13 @@ public:
 	 * @return Non-capturing lambda satisfying C function signature.
 	 */
 	template <typename ReturnHandle = void, auto fn = nullptr>
-	static auto decorate([[maybe_unused]] mem_fn_ptr_t<fn> mem_fn_ptr_const)
+	static constexpr auto decorate([[maybe_unused]] mem_fn_ptr_t<fn> mem_fn_ptr_const)
 	{
 		return decorate<fn, ReturnHandle>();
 	}
 
 	template <auto fn, typename ReturnHandle = void>
-	static auto decorate()
+	static constexpr auto decorate()
 	{
 		assert_is_valid_handle_type<Handle, Class, Adapter>();
 		static_assert(
@@ -192,80 +308,297 @@ public:
 				 std::is_function_v<std::remove_pointer_t<decltype(fn)>>),
 			"Can only decorate function pointers");
 
-		return [](auto... args)
+		if constexpr (TInstrumentation::enabled)
 		{
-			static constexpr out_param_sig sig_type =
-				suite_func_sig_type<ReturnHandle, decltype(args)...>();
-			static_assert(sig_type != out_param_sig::unrecognised, "Ill-formed C suite function");
-
-			if constexpr (sig_type == out_param_sig::cannot_output_cannot_error)
-			{
-				return [](Handle handle, auto &&... rest)
-				{
-					// Although `cannot_output_cannot_error`, this refers to out-parameter, the
-					// function may still return a value.
-					return convert_and_call<ReturnHandle>(
-						fn, handle, std::forward<decltype(rest)>(rest)...);
-				}(std::forward<decltype(args)>(args)...);
-			}
-			else if constexpr (sig_type == out_param_sig::cannot_output_can_error)
-			{
-				return [](cppcapi_ErrorMessage * err, Handle handle, auto &&... rest)
-				{
-					return TErrorMap::wrap_exception(
-						*err,
-						[&]
-						{ convert_and_call(fn, handle, std::forward<decltype(rest)>(rest)...); });
-				}(std::forward<decltype(args)>(args)...);
-			}
-			else if constexpr (sig_type == out_param_sig::can_output_cannot_error)
+			return [](auto... args)
 			{
-				return [](auto * out, Handle handle, auto &&... rest)
-				{
-					using Out = std::remove_pointer_t<decltype(out)>;
+				return call_instrumented<fn>(
+					&call_decorated<fn, ReturnHandle, decltype(args)...>, args...);
+			};
+		}
+		else
+		{
+			return [](auto... args) { return call_decorated<fn, ReturnHandle>(args...); };
+		}
+	}
 
-					*out = convert_and_call<Out>(fn, handle, std::forward<decltype(rest)>(rest)...);
-				}(std::forward<decltype(args)>(args)...);
-			}
-			else if constexpr (sig_type == out_param_sig::can_output_can_error)
-			{
-				return [](cppcapi_ErrorMessage * err, auto * out, Handle handle, auto &&... rest)
-				{
-					using Out = std::remove_pointer_t<decltype(out)>;
-
-					return TErrorMap::wrap_exception(
-						*err,
-						[&] {
-							*out = convert_and_call<Out>(
-								fn, handle, std::forward<decltype(rest)>(rest)...);
-						});
-				}(std::forward<decltype(args)>(args)...);
-			}
-			else if constexpr (sig_type == out_param_sig::factory_cannot_output_cannot_error)
+	/**
+	 * Adapt a free function to be an asynchronous suite function.
+	 *
+	 * @see decorate_async<fn, ReturnHandle>()
+	 *
+	 * @tparam ReturnHandle Type of handle of return value, void (default) for non-handle return
+	 * type.
+	 * @tparam fn Free function pointer, deduced from `free_fn_ptr_const` function parameter.
+	 * @param free_fn_ptr_const Not used directly, used instead to deduce the `fn` template
+	 * parameter.
+	 * @return Non-capturing lambda satisfying asynchronous C function signature.
+	 */
+	template <typename ReturnHandle = void, auto fn = nullptr>
+	static constexpr auto decorate_async([[maybe_unused]] free_fn_ptr_t<fn> free_fn_ptr_const)
+	{
+		return decorate_async<fn, ReturnHandle>();
+	}
+
+	/**
+	 * Adapt a non-capturing lambda to be an asynchronous suite function.
+	 *
+	 * @see decorate_async<fn, ReturnHandle>()
+	 *
+	 * @tparam ReturnHandle Type of handle of return value, void (default) for non-handle return
+	 * type.
+	 * @tparam Callable Stateless callable type to decorate.
+	 * @param lambda Stateless callable to decorate.
+	 * @return Non-capturing lambda satisfying asynchronous C function signature.
+	 */
+	template <typename ReturnHandle = void, typename Callable = void>
+	static constexpr auto decorate_async([[maybe_unused]] Callable && lambda)
+	{
+		static_assert(
+			std::is_empty_v<Callable>,
+			"Only stateless callable objects (i.e. non-capturing lambdas) can be passed directly");
+
+		return decorate_async<
+			lambda_wrapper_t<Callable, decltype(std::function{lambda})>::call,
+			ReturnHandle>();
+	}
+
+	/**
+	 * Adapt a member function to be an asynchronous suite function.
+	 *
+	 * @see decorate_async<fn, ReturnHandle>()
+	 *
+	 * @tparam ReturnHandle Type of handle of return value, void (default) for non-handle return
+	 * type.
+	 * @tparam fn Member function pointer, deduced from `mem_fn_ptr_const` function parameter.
+	 * @param mem_fn_ptr_const Not used directly, used instead to deduce the `fn` template
+	 * parameter.
+	 * @return Non-capturing lambda satisfying asynchronous C function signature.
+	 */
+	template <typename ReturnHandle = void, auto fn = nullptr>
+	static constexpr auto decorate_async([[maybe_unused]] mem_fn_ptr_t<fn> mem_fn_ptr_const)
+	{
+		return decorate_async<fn, ReturnHandle>();
+	}
+
+	/**
+	 * Adapt a function to be an asynchronous suite function, run on an executor.
+	 *
+	 * The resulting C function has the signature `(cppcapi_Completion const *, [out,] handle,
+	 * args...) -> void`, i.e. the same as a `decorate`d function that can error, but with the
+	 * error message storage replaced by a completion struct.
+	 *
+	 * The arguments are copied and the call returns immediately. The decorated function is then
+	 * run on the executor given in the completion struct, or the default ThreadPool if none is
+	 * given. Handle conversion and exception handling are the same as for `decorate`. Once
+	 * complete, the caller is notified as detailed in cppcapi_Completion.
+	 *
+	 * @tparam fn Function pointer to decorate.
+	 * @tparam ReturnHandle Type of handle of return value, void (default) for non-handle return
+	 * type.
+	 * @return Non-capturing lambda satisfying asynchronous C function signature.
+	 */
+	template <auto fn, typename ReturnHandle = void>
+	static constexpr auto decorate_async()
+	{
+		return [](cppcapi_Completion const * completion, auto... args)
+		{ submit_async<fn, ReturnHandle>(*completion, args...); };
+	}
+
+	/**
+	 * Default projection used by `decorate_range`, converting an element of a C++ range to a C
+	 * element.
+	 *
+	 * Elements of a type associated with a service handle are converted to handles, otherwise they
+	 * are `static_cast` to the C element type.
+	 *
+	 * @tparam Element C element type.
+	 */
+	template <typename Element>
+	struct to_element_t
+	{
+		template <typename Value>
+		Element operator()(Value && value) const
+		{
+			if constexpr (HandleManager<Element>::is_for_service())
 			{
-				return [](auto &&... rest) {
-					return convert_and_call<Handle>(fn, std::forward<decltype(rest)>(rest)...);
-				}(std::forward<decltype(args)>(args)...);
+				return HandleManager<Element>::to_handle(std::forward<Value>(value));
 			}
-			else if constexpr (sig_type == out_param_sig::factory_can_output_cannot_error)
+			else
 			{
-				return [](Handle * out, auto &&... rest) {
-					*out = convert_and_call<Handle>(fn, std::forward<decltype(rest)>(rest)...);
-				}(std::forward<decltype(args)>(args)...);
+				return static_cast<Element>(std::forward<Value>(value));
 			}
-			else if constexpr (sig_type == out_param_sig::factory_can_output_can_error)
+		}
+	};
+
+	/**
+	 * Adapt a free function returning a range to be the `open` function of a cursor suite.
+	 *
+	 * @see decorate_range<Cursor, Element, fn, Projection>()
+	 *
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @tparam Element C type of elements.
+	 * @tparam fn Free function pointer, deduced from `free_fn_ptr_const` function parameter.
+	 * @tparam Projection Stateless callable converting range elements to C elements.
+	 * @param free_fn_ptr_const Not used directly, used instead to deduce the `fn` template
+	 * parameter.
+	 * @return Non-capturing lambda satisfying cursor `open` C function signature.
+	 */
+	template <
+		typename Cursor,
+		typename Element,
+		auto fn = nullptr,
+		typename Projection = to_element_t<Element>>
+	static constexpr auto decorate_range(
+		[[maybe_unused]] free_fn_ptr_t<fn> free_fn_ptr_const,
+		[[maybe_unused]] Projection projection = {})
+	{
+		return decorate_range<Cursor, Element, fn, projection_wrapper_t<Projection>>();
+	}
+
+	/**
+	 * Adapt a non-capturing lambda returning a range to be the `open` function of a cursor suite.
+	 *
+	 * @see decorate_range<Cursor, Element, fn, Projection>()
+	 *
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @tparam Element C type of elements.
+	 * @tparam Callable Stateless callable type to decorate.
+	 * @tparam Projection Stateless callable converting range elements to C elements.
+	 * @param lambda Stateless callable to decorate.
+	 * @return Non-capturing lambda satisfying cursor `open` C function signature.
+	 */
+	template <
+		typename Cursor,
+		typename Element,
+		typename Callable = void,
+		typename Projection = to_element_t<Element>>
+	static constexpr auto decorate_range(
+		[[maybe_unused]] Callable && lambda, [[maybe_unused]] Projection projection = {})
+	{
+		static_assert(
+			std::is_empty_v<Callable> && std::is_empty_v<Projection>,
+			"Only stateless callable objects (i.e. non-capturing lambdas) can be passed directly");
+
+		return decorate_range<
+			Cursor,
+			Element,
+			lambda_wrapper_t<Callable, decltype(std::function{lambda})>::call,
+			projection_wrapper_t<Projection>>();
+	}
+
+	/**
+	 * Adapt a member function returning a range to be the `open` function of a cursor suite.
+	 *
+	 * @see decorate_range<Cursor, Element, fn, Projection>()
+	 *
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @tparam Element C type of elements.
+	 * @tparam fn Member function pointer, deduced from `mem_fn_ptr_const` function parameter.
+	 * @tparam Projection Stateless callable converting range elements to C elements.
+	 * @param mem_fn_ptr_const Not used directly, used instead to deduce the `fn` template
+	 * parameter.
+	 * @return Non-capturing lambda satisfying cursor `open` C function signature.
+	 */
+	template <
+		typename Cursor,
+		typename Element,
+		auto fn = nullptr,
+		typename Projection = to_element_t<Element>>
+	static constexpr auto decorate_range(
+		[[maybe_unused]] mem_fn_ptr_t<fn> mem_fn_ptr_const,
+		[[maybe_unused]] Projection projection = {})
+	{
+		return decorate_range<Cursor, Element, fn, projection_wrapper_t<Projection>>();
+	}
+
+	/**
+	 * Adapt a function returning a range to be the `open` function of a cursor suite, allowing
+	 * clients to iterate the range in chunks.
+	 *
+	 * A cursor suite consists of three functions:
+	 * - `open` with signature `(cppcapi_ErrorMessage *, Cursor *, handle, args...) ->
+	 *   cppcapi_ErrorCode`, as returned by this function.
+	 * - `next_chunk` with signature `(cppcapi_ErrorMessage *, size_t * count, Cursor, Element *
+	 *   out, size_t capacity) -> cppcapi_ErrorCode`, see `next_chunk`.
+	 * - `close` with signature `(Cursor) -> void`, see `close_cursor`.
+	 *
+	 * The range is fetched (under any lock of the handle) when the cursor is opened. If the range
+	 * is returned by reference, then it must not be modified until the cursor is closed. Otherwise
+	 * it is owned by the cursor.
+	 *
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @tparam Element C type of elements.
+	 * @tparam fn Function pointer returning a range.
+	 * @tparam Projection Stateless callable converting range elements to C elements.
+	 * @return Non-capturing lambda satisfying cursor `open` C function signature.
+	 */
+	template <
+		typename Cursor,
+		typename Element,
+		auto fn,
+		typename Projection = to_element_t<Element>>
+	static constexpr auto decorate_range()
+	{
+		assert_is_valid_handle_type<Handle, Class, Adapter>();
+
+		if constexpr (TInstrumentation::enabled)
+		{
+			return [](cppcapi_ErrorMessage * err, Cursor * out, Handle handle, auto... rest)
 			{
-				return [](cppcapi_ErrorMessage * err, Handle * out, auto &&... rest)
-				{
-					return TErrorMap::wrap_exception(
-						*err,
-						[&] {
-							*out =
-								convert_and_call<Handle>(fn, std::forward<decltype(rest)>(rest)...);
-						});
-				}(std::forward<decltype(args)>(args)...);
-			}
-		};
+				return call_instrumented<fn>(
+					&open_cursor<Cursor, Element, fn, Projection, decltype(rest)...>,
+					err,
+					out,
+					handle,
+					rest...);
+			};
+		}
+		else
+		{
+			return [](cppcapi_ErrorMessage * err, Cursor * out, Handle handle, auto... rest) {
+				return open_cursor<Cursor, Element, fn, Projection>(err, out, handle, rest...);
+			};
+		}
+	}
+
+	/**
+	 * Cursor suite function to fetch the next chunk of elements from a cursor.
+	 *
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @tparam Element C type of elements.
+	 * @param err Storage for error message.
+	 * @param count Storage for number of elements written, which is less than `capacity` only if
+	 * the end of the range has been reached.
+	 * @param cursor Cursor opened by a `decorate_range` function.
+	 * @param out Array to write elements into.
+	 * @param capacity Size of `out` array.
+	 * @return Error code, e.g. if converting an element threw.
+	 */
+	template <typename Cursor, typename Element>
+	static cppcapi_ErrorCode next_chunk(
+		cppcapi_ErrorMessage * err,
+		std::size_t * count,
+		Cursor cursor,
+		Element * out,
+		std::size_t const capacity)
+	{
+		*count = 0;
+		return TErrorMap::wrap_exception(
+			*err,
+			[&] { *count = reinterpret_cast<detail::CursorBase *>(cursor)->fill(out, capacity); });
+	}
+
+	/**
+	 * Cursor suite function to close a cursor, releasing any range it owns.
+	 *
+	 * @tparam Cursor Opaque cursor handle type.
+	 * @param cursor Cursor opened by a `decorate_range` function.
+	 */
+	template <typename Cursor>
+	static void close_cursor(Cursor cursor)
+	{
+		delete reinterpret_cast<detail::CursorBase *>(cursor);
 	}
 
 	/**
@@ -295,7 +628,366 @@ public:
 			*err, [&] { *out = HandleManager<ServiceHandle>::decay(handle); });
 	}
 
+	/**
+	 * Suite function to replay a client's command buffer in a single call.
+	 *
+	 * Each command is dispatched to the corresponding function in the function pointer suite, as
+	 * detailed in Commands::execute.
+	 *
+	 * @tparam Commands Commands list agreed between client and service.
+	 * @tparam suite_factory Function returning a pointer to the function pointer suite to dispatch
+	 * to.
+	 * @param err Storage for error messages of failed commands.
+	 * @param results Storage for result of each command.
+	 * @param buffer Recorded commands.
+	 * @return Error code of first failed command, or cppcapi_ok.
+	 */
+	template <class Commands, auto suite_factory>
+	static cppcapi_ErrorCode execute(
+		cppcapi_ErrorMessage * err,
+		cppcapi_CommandResult * results,
+		cppcapi_CommandBuffer const * buffer)
+	{
+		return Commands::execute(*suite_factory(), *err, results, *buffer);
+	}
+
+	/**
+	 * Compile-time metadata describing a function pointer suite, for use by tooling.
+	 *
+	 * Includes the name and signature kind of each suite function, along with the type and handle
+	 * ownership of each of its parameters. The metadata has static storage duration, so can be
+	 * exported via a C symbol for use by profilers, tracers, etc.
+	 *
+	 * @tparam members Pointers to members of the function pointer suite, e.g. `&MySuite::my_func`.
+	 * @return Suite metadata.
+	 */
+	template <auto... members>
+	static constexpr cppcapi_SuiteMetadata const & metadata()
+	{
+		return suite_metadata_t<members...>::value;
+	}
+
 private:
+	/**
+	 * Implementation of a decorated suite function, dispatching on the kind of C signature.
+	 *
+	 * @tparam fn C++ function to call.
+	 * @tparam ReturnHandle Type of handle of return value, or void.
+	 * @param args C arguments.
+	 * @return Result of suite function.
+	 */
+	template <auto fn, typename ReturnHandle, typename... Args>
+	static auto call_decorated(Args... args)
+	{
+		static constexpr out_param_sig sig_type =
+			suite_func_sig_type<ReturnHandle, decltype(args)...>();
+		static_assert(sig_type != out_param_sig::unrecognised, "Ill-formed C suite function");
+
+		if constexpr (sig_type == out_param_sig::cannot_output_cannot_error)
+		{
+			return [](Handle handle, auto &&... rest)
+			{
+				// Although `cannot_output_cannot_error`, this refers to out-parameter, the
+				// function may still return a value.
+				return convert_and_call_locked<ReturnHandle>(
+					fn, handle, std::forward<decltype(rest)>(rest)...);
+			}(std::forward<decltype(args)>(args)...);
+		}
+		else if constexpr (sig_type == out_param_sig::cannot_output_can_error)
+		{
+			return [](cppcapi_ErrorMessage * err, Handle handle, auto &&... rest)
+			{
+				return TErrorMap::wrap_exception(
+					*err,
+					[&]
+					{
+						throw_if_aborted(rest...);
+						convert_and_call_locked(
+							fn, handle, std::forward<decltype(rest)>(rest)...);
+					});
+			}(std::forward<decltype(args)>(args)...);
+		}
+		else if constexpr (sig_type == out_param_sig::can_output_cannot_error)
+		{
+			return [](auto * out, Handle handle, auto &&... rest)
+			{
+				using Out = std::remove_pointer_t<decltype(out)>;
+
+				*out = convert_and_call_locked<Out>(
+					fn, handle, std::forward<decltype(rest)>(rest)...);
+			}(std::forward<decltype(args)>(args)...);
+		}
+		else if constexpr (sig_type == out_param_sig::can_output_can_error)
+		{
+			return [](cppcapi_ErrorMessage * err, auto * out, Handle handle, auto &&... rest)
+			{
+				using Out = std::remove_pointer_t<decltype(out)>;
+
+				return TErrorMap::wrap_exception(
+					*err,
+					[&]
+					{
+						throw_if_aborted(rest...);
+						*out = convert_and_call_locked<Out>(
+							fn, handle, std::forward<decltype(rest)>(rest)...);
+					});
+			}(std::forward<decltype(args)>(args)...);
+		}
+		else if constexpr (sig_type == out_param_sig::factory_cannot_output_cannot_error)
+		{
+			return [](auto &&... rest) {
+				return convert_and_call<Handle>(fn, std::forward<decltype(rest)>(rest)...);
+			}(std::forward<decltype(args)>(args)...);
+		}
+		else if constexpr (sig_type == out_param_sig::factory_can_output_cannot_error)
+		{
+			return [](Handle * out, auto &&... rest) {
+				*out = convert_and_call<Handle>(fn, std::forward<decltype(rest)>(rest)...);
+			}(std::forward<decltype(args)>(args)...);
+		}
+		else if constexpr (sig_type == out_param_sig::factory_can_output_can_error)
+		{
+			return [](cppcapi_ErrorMessage * err, Handle * out, auto &&... rest)
+			{
+				return TErrorMap::wrap_exception(
+					*err,
+					[&] {
+						*out =
+							convert_and_call<Handle>(fn, std::forward<decltype(rest)>(rest)...);
+					});
+			}(std::forward<decltype(args)>(args)...);
+		}
+	}
+
+	/**
+	 * Implementation of a decorated constructor, dispatching on the kind of factory signature.
+	 *
+	 * @tparam CppArgs Tuple of parameter types of the constructor overload.
+	 * @param args C arguments.
+	 * @return Result of suite function.
+	 */
+	template <typename CppArgs, typename... Args>
+	static auto call_constructor(Args... args)
+	{
+		if constexpr (is_0th_arg_error_v<Args...> && is_nth_arg_handle_ptr_v<1, Args...>)
+		{
+			return [](cppcapi_ErrorMessage * err, Handle * out, auto... rest)
+			{
+				return TErrorMap::wrap_exception(
+					*err, [&] { *out = construct_to_handle<CppArgs>(rest...); });
+			}(args...);
+		}
+		else if constexpr (is_nth_arg_handle_ptr_v<0, Args...>)
+		{
+			return [](Handle * out, auto... rest)
+			{ *out = construct_to_handle<CppArgs>(rest...); }(args...);
+		}
+		else
+		{
+			return construct_to_handle<CppArgs>(args...);
+		}
+	}
+
+	/// Construct a new instance from C arguments, selecting the constructor by C++ parameter types.
+	template <typename CppArgs, typename... CArgs>
+	static Handle construct_to_handle(CArgs... c_args)
+	{
+		return HandleManager<Handle>::emplace_to_handle(
+			[&]
+			{
+				return convert_args<CppArgs>(
+					[](auto &&... cpp_args)
+					{
+						return std::remove_const_t<Class>(
+							std::forward<decltype(cpp_args)>(cpp_args)...);
+					},
+					c_args...);
+			});
+	}
+
+	/**
+	 * Whether the next C++ parameter should be constructed from a `(pointer, size)` pair of C
+	 * arguments.
+	 */
+	template <typename CppArg, std::size_t num_cpp_args, typename... CArgs>
+	static constexpr bool is_span_arg()
+	{
+		if constexpr (sizeof...(CArgs) < 2 || sizeof...(CArgs) <= num_cpp_args)
+		{
+			return false;
+		}
+		else
+		{
+			using Data = std::tuple_element_t<0, std::tuple<CArgs...>>;
+			using Size = std::tuple_element_t<1, std::tuple<CArgs...>>;
+			return std::is_pointer_v<Data> && std::is_same_v<Size, std::size_t> &&
+				std::is_constructible_v<std::decay_t<CppArg>, Data, Size>;
+		}
+	}
+
+	/**
+	 * Convert C arguments to the given C++ parameter types and pass them to a callable.
+	 *
+	 * @tparam CppArgs Tuple of remaining C++ parameter types.
+	 * @param fn Callable to pass converted arguments to.
+	 * @param c_args Remaining C arguments.
+	 * @return Result of callable.
+	 */
+	template <typename CppArgs, typename Fn, typename... CArgs>
+	static decltype(auto) convert_args(Fn && fn, CArgs... c_args)
+	{
+		if constexpr (std::tuple_size_v<CppArgs> == 0)
+		{
+			static_assert(sizeof...(CArgs) == 0, "Too many C arguments for constructor");
+			return fn();
+		}
+		else
+		{
+			return convert_first_arg<CppArgs>(std::forward<Fn>(fn), c_args...);
+		}
+	}
+
+	template <typename CppArgs, typename Fn, typename CArg, typename... CArgs>
+	static decltype(auto) convert_first_arg(Fn && fn, CArg c_arg, CArgs... c_args)
+	{
+		using CppArg = std::tuple_element_t<0, CppArgs>;
+		using CppRest = decltype(tuple_tail(std::declval<CppArgs>()));
+
+		if constexpr (is_span_arg<CppArg, std::tuple_size_v<CppArgs>, CArg, CArgs...>())
+		{
+			return [&](auto size, auto... rest) -> decltype(auto)
+			{
+				std::decay_t<CppArg> span(c_arg, size);
+				return convert_args<CppRest>(
+					[&](auto &&... cpp_rest) -> decltype(auto)
+					{ return fn(span, std::forward<decltype(cpp_rest)>(cpp_rest)...); },
+					rest...);
+			}(c_args...);
+		}
+		else
+		{
+			decltype(auto) cpp_arg =
+				ArgHandleManager<CArg>::template to_instance_or_ptr<CppArg>(c_arg);
+			return convert_args<CppRest>(
+				[&](auto &&... cpp_rest) -> decltype(auto)
+				{
+					return fn(
+						std::forward<decltype(cpp_arg)>(cpp_arg),
+						std::forward<decltype(cpp_rest)>(cpp_rest)...);
+				},
+				c_args...);
+		}
+	}
+
+	template <typename T, typename... Ts>
+	static std::tuple<Ts...> tuple_tail(std::tuple<T, Ts...> const &);
+
+	/**
+	 * Implementation of a decorated cursor `open` suite function.
+	 *
+	 * @see decorate_range<Cursor, Element, fn, Projection>()
+	 */
+	template <typename Cursor, typename Element, auto fn, typename Projection, typename... Rest>
+	static cppcapi_ErrorCode open_cursor(
+		cppcapi_ErrorMessage * err, Cursor * out, Handle handle, Rest... rest)
+	{
+		return TErrorMap::wrap_exception(
+			*err,
+			[&]
+			{
+				throw_if_aborted(rest...);
+				using Range = decltype(convert_and_call_locked(fn, handle, rest...));
+				*out = reinterpret_cast<Cursor>(static_cast<detail::CursorBase *>(
+					new detail::RangeCursor<Range, Element, Projection>{
+						convert_and_call_locked(fn, handle, rest...)}));
+			});
+	}
+
+	/**
+	 * Call a decorated suite function, recording its latency and resulting error code.
+	 *
+	 * @tparam fn Function pointer identifying the suite function to the instrumentation policy.
+	 * @param decorated Decorated suite function.
+	 * @param args C arguments.
+	 * @return Result of decorated suite function.
+	 */
+	template <auto fn, typename Decorated, typename... Args>
+	static auto call_instrumented(Decorated const & decorated, Args... args)
+	{
+		auto const token = TInstrumentation::template begin<fn>();
+		if constexpr (is_0th_arg_error_v<Args...>)
+		{
+			cppcapi_ErrorCode const code = decorated(args...);
+			TInstrumentation::template end<fn>(token, code);
+			return code;
+		}
+		else if constexpr (std::is_void_v<decltype(decorated(args...))>)
+		{
+			decorated(args...);
+			TInstrumentation::template end<fn>(token, cppcapi_ok);
+		}
+		else
+		{
+			auto ret = decorated(args...);
+			TInstrumentation::template end<fn>(token, cppcapi_ok);
+			return ret;
+		}
+	}
+
+	/**
+	 * Copy the arguments of an asynchronous call and submit it to an executor.
+	 *
+	 * Any failure to submit is signalled immediately through the completion.
+	 */
+	template <auto fn, typename ReturnHandle, typename... Args>
+	static void submit_async(cppcapi_Completion const & completion, Args... args)
+	{
+		struct Task
+		{
+			cppcapi_Completion completion;
+			std::tuple<Args...> args;
+
+			static void run(void * data)
+			{
+				std::unique_ptr<Task> const task{static_cast<Task *>(data)};
+				cppcapi_ErrorCode const code = std::apply(
+					[&task](auto... task_args)
+					{ return decorate<fn, ReturnHandle>()(task->completion.err, task_args...); },
+					task->args);
+				complete(task->completion, code);
+			}
+		};
+
+		Task * task = nullptr;
+		cppcapi_Executor executor;
+
+		cppcapi_ErrorCode const code = TErrorMap::wrap_exception(
+			*completion.err,
+			[&]
+			{
+				executor = completion.executor ? *completion.executor : default_executor();
+				task = new Task{completion, {args...}};
+			});
+
+		if (code != cppcapi_ok)
+			return complete(completion, code);
+
+		executor.submit(executor.context, &Task::run, task);
+	}
+
+	/// Signal completion of an asynchronous call.
+	static void complete(cppcapi_Completion const & completion, cppcapi_ErrorCode const code)
+	{
+		// Signal eventfd first, since the callback may trigger the client to close it.
+		if (completion.eventfd >= 0)
+		{
+			std::uint64_t const one = 1;
+			[[maybe_unused]] auto const written = ::write(completion.eventfd, &one, sizeof(one));
+		}
+		if (completion.callback)
+			completion.callback(completion.user_data, code);
+	}
+
 	template <typename T, std::size_t N, std::size_t CurrN, typename... Args>
 	struct is_nth_arg_T_impl;
 
@@ -314,6 +1006,11 @@ private:
 	{
 	};
 
+	template <typename T, std::size_t N, std::size_t CurrN>
+	struct is_nth_arg_T_impl<T, N, CurrN> : std::false_type
+	{
+	};
+
 	template <typename T, std::size_t N, typename... Args>
 	struct is_nth_arg_T : is_nth_arg_T_impl<T, N, 0, Args...>
 	{
@@ -398,21 +1095,207 @@ private:
 		return out_param_sig::unrecognised;
 	}
 
-	/// Call a C++ function after converting C handles to their C++ types.
+	static constexpr cppcapi_SignatureKind signature_kind(out_param_sig const sig_type)
+	{
+		switch (sig_type)
+		{
+			case out_param_sig::cannot_output_cannot_error:
+				return cppcapi_signature_cannot_output_cannot_error;
+			case out_param_sig::cannot_output_can_error:
+				return cppcapi_signature_cannot_output_can_error;
+			case out_param_sig::can_output_cannot_error:
+				return cppcapi_signature_can_output_cannot_error;
+			case out_param_sig::can_output_can_error:
+				return cppcapi_signature_can_output_can_error;
+			case out_param_sig::factory_cannot_output_cannot_error:
+				return cppcapi_signature_factory_cannot_output_cannot_error;
+			case out_param_sig::factory_can_output_cannot_error:
+				return cppcapi_signature_factory_can_output_cannot_error;
+			case out_param_sig::factory_can_output_can_error:
+				return cppcapi_signature_factory_can_output_can_error;
+			case out_param_sig::unrecognised:
+				break;
+		}
+		return cppcapi_signature_other;
+	}
+
+	/// Metadata of a suite function parameter, looking through pointers to handles.
+	template <typename Param>
+	static constexpr cppcapi_ParamMetadata param_metadata()
+	{
+		using Manager = std::conditional_t<
+			HandleManager<Param>::is_for_service() || HandleManager<Param>::is_for_client(),
+			HandleManager<Param>,
+			HandleManager<std::remove_pointer_t<Param>>>;
+
+		cppcapi_Ownership ownership = cppcapi_ownership_none;
+		if constexpr (Manager::is_for_client())
+			ownership = cppcapi_ownership_remote;
+		else if constexpr (Manager::is_shared_ownership())
+			ownership = cppcapi_ownership_shared;
+		else if constexpr (Manager::is_owned_by_client())
+			ownership = cppcapi_ownership_owned_by_client;
+		else if constexpr (Manager::is_owned_by_service())
+			ownership = cppcapi_ownership_owned_by_service;
+
+		return {cppcapi::detail::type_name<Param>(), ownership};
+	}
+
+	template <auto member, typename = decltype(member)>
+	struct function_metadata_t
+	{
+		static_assert(
+			!std::is_same_v<decltype(member), decltype(member)>,
+			"Suite metadata requires pointers to function pointer members of a suite");
+	};
+
+	template <auto member, typename TSuite, typename Ret, typename... Params>
+	struct function_metadata_t<member, Ret (*TSuite::*)(Params...)>
+	{
+		using Suite = TSuite;
+
+		static constexpr std::array<cppcapi_ParamMetadata, sizeof...(Params)> params{
+			param_metadata<Params>()...};
+
+		static constexpr cppcapi_FunctionMetadata value{
+			cppcapi::detail::value_name<member>(),
+			signature_kind(suite_func_sig_type<Ret, Params...>()),
+			params.empty() ? nullptr : params.data(),
+			params.size()};
+	};
+
+	template <auto... members>
+	struct suite_metadata_t
+	{
+		using Suite = std::
+			tuple_element_t<0, std::tuple<typename function_metadata_t<members>::Suite...>>;
+
+		static_assert(
+			(std::is_same_v<Suite, typename function_metadata_t<members>::Suite> && ...),
+			"All functions must belong to the same function pointer suite");
+
+		static constexpr std::array<cppcapi_FunctionMetadata, sizeof...(members)> functions{
+			function_metadata_t<members>::value...};
+
+		static constexpr cppcapi_SuiteMetadata value{
+			cppcapi::detail::type_name<Suite>(), functions.data(), functions.size()};
+	};
+
+	/**
+	 * Throw if any call context among the C arguments has been cancelled or its deadline passed.
+	 *
+	 * @param args C arguments to a suite function.
+	 */
+	template <typename... CArg>
+	static void throw_if_aborted([[maybe_unused]] CArg const &... args)
+	{
+		(
+			[&args]
+			{
+				if constexpr (std::is_same_v<CArg, cppcapi_CallContext const *>)
+					CallContext{args}.throw_if_aborted();
+			}(),
+			...);
+	}
+
+	template <typename Param>
+	struct is_shared_ptr_param : std::false_type
+	{
+	};
+
+	template <typename Pointee>
+	struct is_shared_ptr_param<SharedPtr<Pointee>> : std::true_type
+	{
+		static constexpr bool is_const_pointee = std::is_const_v<Pointee>;
+	};
+
+	/**
+	 * Whether a parameter bound to a handle only gives read access to the instance, i.e. is a
+	 * const reference or by value, and if a SharedPtr then only to a const instance.
+	 */
+	template <typename Instance>
+	static constexpr bool is_read_only_param()
+	{
+		using Value = std::remove_cv_t<std::remove_reference_t<Instance>>;
+		constexpr bool is_const_or_value =
+			!std::is_reference_v<Instance> || std::is_const_v<std::remove_reference_t<Instance>>;
+		if constexpr (is_shared_ptr_param<Value>::value)
+			return is_const_or_value && is_shared_ptr_param<Value>::is_const_pointee;
+		else
+			return is_const_or_value;
+	}
+
+	/**
+	 * Whether a C++ function bound to a handle only reads the instance, i.e. is a const member
+	 * function or takes the instance as a read-only parameter, see is_read_only_param.
+	 */
+	template <typename Fn>
+	struct is_const_call : std::false_type
+	{
+	};
+
+	template <typename Ret, typename Class, typename... Args>
+	struct is_const_call<Ret (Class::*)(Args...) const> : std::true_type
+	{
+	};
+
+	template <typename Ret, typename Class, typename... Args>
+	struct is_const_call<Ret (Class::*)(Args...) const noexcept> : std::true_type
+	{
+	};
+
+	template <typename Ret, typename Instance, typename... Args>
+	struct is_const_call<Ret (*)(Instance, Args...)>
+		: std::bool_constant<is_read_only_param<Instance>()>
+	{
+	};
+
+	template <typename Ret, typename Instance, typename... Args>
+	struct is_const_call<Ret (*)(Instance, Args...) noexcept>
+		: is_const_call<Ret (*)(Instance, Args...)>
+	{
+	};
+
+	/**
+	 * Call a C++ function bound to a handle, holding a lock on the instance according to the
+	 * synchronization policy of the handle.
+	 *
+	 * A shared lock is taken for const calls, otherwise an exclusive lock.
+	 */
 	template <typename ReturnHandle = void, typename Fn = void, typename... CArg>
+	static decltype(auto) convert_and_call_locked(Fn && fn, Handle handle, CArg &&... arg)
+	{
+		constexpr bool exclusive = !is_const_call<std::decay_t<Fn>>::value;
+		[[maybe_unused]] auto const lock = HandleManager<Handle>::template lock<exclusive>(handle);
+		return convert_and_call<ReturnHandle, true>(
+			std::forward<Fn>(fn), handle, std::forward<CArg>(arg)...);
+	}
+
+	/**
+	 * Call a C++ function after converting C handles to their C++ types.
+	 *
+	 * @tparam ReturnHandle Type of handle of return value, or void.
+	 * @tparam has_self Whether the first argument is the handle the function is bound to, rather
+	 * than e.g. an argument of a factory.
+	 */
+	template <
+		typename ReturnHandle = void,
+		bool has_self = false,
+		typename Fn = void,
+		typename... CArg>
 	static decltype(auto) convert_and_call(Fn && fn, CArg &&... arg)
 	{
 		auto const call = [&]() -> decltype(auto)
 		{
 			if constexpr (std::is_member_function_pointer_v<Fn>)
 			{
-				return convert_and_call_helper_t<Fn>::call(
+				return convert_and_call_helper_t<Fn>::template call<has_self>(
 					std::forward<Fn>(fn), std::forward<CArg>(arg)...);
 			}
 			else
 			{
-				return convert_and_call_helper_t<decltype(std::function{fn})>::call(
-					std::forward<Fn>(fn), std::forward<CArg>(arg)...);
+				return convert_and_call_helper_t<decltype(std::function{fn})>::template call<
+					has_self>(std::forward<Fn>(fn), std::forward<CArg>(arg)...);
 			}
 		};
 
@@ -425,8 +1308,17 @@ private:
 			// Return handle type specified in optional template param, so convert.
 
 			using ReturnType = decltype(call());
+			using ReturnClass =
+				typename TServiceHandleMap::template class_from_handle<ReturnHandle>;
+			// Returned by value, so can be constructed directly in the handle's storage.
+			constexpr bool is_emplaceable =
+				std::is_same_v<ReturnType, std::remove_const_t<ReturnClass>>;
 
-			if constexpr (HandleManager<ReturnHandle>::is_owned_by_client())
+			if constexpr (HandleManager<ReturnHandle>::is_owned_by_client() && is_emplaceable)
+			{
+				return HandleManager<ReturnHandle>::emplace_to_handle(call);
+			}
+			else if constexpr (HandleManager<ReturnHandle>::is_owned_by_client())
 			{
 				return HandleManager<ReturnHandle>::make_to_handle(call());
 			}
@@ -444,6 +1336,10 @@ private:
 				{
 					return HandleManager<ReturnHandle>::to_handle(call());
 				}
+				else if constexpr (is_emplaceable)
+				{
+					return HandleManager<ReturnHandle>::emplace_to_handle(call);
+				}
 				else
 				{
 					return HandleManager<ReturnHandle>::make_to_handle(call());
@@ -457,6 +1353,29 @@ private:
 		}
 	}
 
+	/**
+	 * Convert a C argument to a C++ parameter type.
+	 *
+	 * Only the handle a suite function is bound to is converted via our HandleMap, which for a
+	 * Subclass suite maps it to the subclass. Other handles, even of the same type, may refer to
+	 * instances of any subclass, so are converted via the original HandleMap.
+	 *
+	 * @tparam CppArg C++ parameter type.
+	 * @tparam is_self Whether the argument is the handle the suite function is bound to.
+	 * @param arg C argument.
+	 * @return C++ argument.
+	 */
+	template <typename CppArg, bool is_self, typename CArg>
+	static decltype(auto) convert_arg(CArg && arg)
+	{
+		if constexpr (is_self)
+			return HandleManager<std::decay_t<CArg>>::template to_instance_or_ptr<CppArg>(
+				std::forward<CArg>(arg));
+		else
+			return ArgHandleManager<std::decay_t<CArg>>::template to_instance_or_ptr<CppArg>(
+				std::forward<CArg>(arg));
+	}
+
 	template <typename>
 	struct convert_and_call_helper_t;
 
@@ -464,25 +1383,32 @@ private:
 	template <typename Ret, typename... CppArg>
 	struct convert_and_call_helper_t<std::function<Ret(CppArg...)>>
 	{
-		template <typename Fn, typename... CArg>
+		template <bool has_self, typename Fn, typename... CArg>
 		static decltype(auto) call(Fn && fn, CArg &&... arg)
 		{
-			return fn(HandleManager<std::decay_t<CArg>>::template to_instance_or_ptr<CppArg>(
-				std::forward<CArg>(arg))...);
+			return call_indexed<has_self>(
+				std::forward<Fn>(fn),
+				std::index_sequence_for<CArg...>{},
+				std::forward<CArg>(arg)...);
+		}
+
+		template <bool has_self, typename Fn, std::size_t... idx, typename... CArg>
+		static decltype(auto) call_indexed(Fn && fn, std::index_sequence<idx...>, CArg &&... arg)
+		{
+			return fn(convert_arg<CppArg, has_self && idx == 0>(std::forward<CArg>(arg))...);
 		}
 	};
 
-	/// Helper for member function.
+	/// Helper for member function, always bound to the handle of its instance.
 	template <typename Ret, typename Class, typename... CppArg>
 	struct convert_and_call_helper_t<Ret (Class::*)(CppArg...)>
 	{
-		template <typename Fn, typename Handle, typename... CArg>
+		template <bool, typename Fn, typename Handle, typename... CArg>
 		static decltype(auto) call(Fn && fn, Handle handle, CArg &&... arg)
 		{
 			return std::mem_fn(fn)(
 				HandleManager<Handle>::template to_instance(std::forward<Handle>(handle)),
-				HandleManager<std::decay_t<CArg>>::template to_instance_or_ptr<CppArg>(
-					std::forward<CArg>(arg))...);
+				convert_arg<CppArg, false>(std::forward<CArg>(arg))...);
 		}
 	};
 
@@ -510,6 +1436,25 @@ private:
 	template <class Lambda, class Sig>
 	struct lambda_wrapper_t;
 
+	/**
+	 * Default-constructible wrapper around a stateless projection, since lambdas are not
+	 * default-constructible.
+	 *
+	 * As with lambda_wrapper_t, the projection _must_ be stateless for this to work.
+	 */
+	template <class Projection>
+	struct projection_wrapper_t
+	{
+		static_assert(
+			std::is_empty_v<Projection>, "Cannot wrap a stateful (i.e. capturing) projection");
+
+		template <typename Value>
+		decltype(auto) operator()(Value && value) const
+		{
+			return reinterpret_cast<const Projection &>(*this)(std::forward<Value>(value));
+		}
+	};
+
 	/**
 	 * Compile-time lambda helper.
 	 *
@@ -0,0 +1,177 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains synchronization policies that services can associate with handles via HandleTraits.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+
+namespace cppcapi::service
+{
+/**
+ * Synchronization policy that performs no locking.
+ *
+ * This is the default policy, leaving synchronization to the native class (if required).
+ */
+struct NoSync
+{
+	static constexpr bool enabled = false;
+	static constexpr bool embedded = false;
+};
+
+/**
+ * Synchronization policy that embeds a lock next to each instance.
+ *
+ * Decorated suite functions bound to a const member function, or a callable taking the instance
+ * by const reference or by value, take a shared lock, otherwise an exclusive lock is taken. Locks
+ * are not recursive, so a decorated function must not call back into the same instance via its
+ * handle.
+ *
+ * Only supported for HandleOwnershipTag::OwnedByClient handles, since the lock must be allocated
+ * along with the instance. See StripedLock for other ownership models.
+ *
+ * @tparam TMutex Shared mutex type, e.g. std::shared_mutex or SpinSharedMutex.
+ */
+template <class TMutex = std::shared_mutex>
+struct EmbeddedLock
+{
+	using Mutex = TMutex;
+	static constexpr bool enabled = true;
+	static constexpr bool embedded = true;
+};
+
+/**
+ * Synchronization policy that shares a fixed table of locks between all instances, chosen by
+ * address.
+ *
+ * Locking semantics are the same as EmbeddedLock, but no additional storage is required per
+ * instance, so is supported for all ownership models. For Shared handles, a callable taking a
+ * SharedPtr to a non-const instance can mutate it, so takes an exclusive lock even if the
+ * SharedPtr is taken by value. Unrelated instances may share a lock, so the number of stripes
+ * should be chosen to reduce false contention.
+ *
+ * @tparam num_stripes Number of locks in the table.
+ * @tparam TMutex Shared mutex type, e.g. std::shared_mutex or SpinSharedMutex.
+ */
+template <std::size_t num_stripes = 64, class TMutex = std::shared_mutex>
+struct StripedLock
+{
+	using Mutex = TMutex;
+	static constexpr bool enabled = true;
+	static constexpr bool embedded = false;
+
+	/**
+	 * Get the lock associated with an instance.
+	 *
+	 * @param address Address of instance.
+	 * @return Lock shared by all instances hashing to the same stripe.
+	 */
+	static Mutex & mutex_for(void const * address)
+	{
+		static std::array<Mutex, num_stripes> stripes;
+		// Fibonacci hash, discarding low bits that are likely zero due to alignment.
+		auto const hash =
+			(reinterpret_cast<std::uintptr_t>(address) >> 4U) * 11400714819323198485ULL;
+		return stripes[static_cast<std::size_t>(hash >> 32U) % num_stripes];
+	}
+};
+
+/**
+ * Lightweight reader-writer spin lock, for use with EmbeddedLock or StripedLock under low
+ * contention.
+ *
+ * Does not block in the kernel and is only the size of an int, but offers no fairness so writers
+ * can be starved by a steady stream of readers.
+ */
+class SpinSharedMutex
+{
+public:
+	void lock() noexcept
+	{
+		int expected = 0;
+		while (!state_.compare_exchange_weak(
+			expected, kwriter, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			expected = 0;
+			std::this_thread::yield();
+		}
+	}
+
+	bool try_lock() noexcept
+	{
+		int expected = 0;
+		return state_.compare_exchange_strong(
+			expected, kwriter, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	void unlock() noexcept
+	{
+		state_.store(0, std::memory_order_release);
+	}
+
+	void lock_shared() noexcept
+	{
+		while (!try_lock_shared()) std::this_thread::yield();
+	}
+
+	bool try_lock_shared() noexcept
+	{
+		int readers = state_.load(std::memory_order_relaxed);
+		while (readers != kwriter)
+		{
+			if (state_.compare_exchange_weak(
+					readers, readers + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+		}
+		return false;
+	}
+
+	void unlock_shared() noexcept
+	{
+		state_.fetch_sub(1, std::memory_order_release);
+	}
+
+private:
+	static constexpr int kwriter = -1;
+	/// Number of readers, or `kwriter` if exclusively locked.
+	std::atomic<int> state_{0};
+};
+
+namespace detail
+{
+/**
+ * Heap-allocated instance with an embedded lock, as referenced by handles using EmbeddedLock.
+ *
+ * @tparam Class Native class.
+ * @tparam Mutex Lock type.
+ */
+template <class Class, class Mutex>
+struct SynchronizedInstance
+{
+	template <typename... Args>
+	explicit SynchronizedInstance(Args &&... args) : instance{std::forward<Args>(args)...}
+	{
+	}
+
+	/// Construct the instance from the value returned by a factory, without a copy or move.
+	template <typename Factory>
+	SynchronizedInstance(std::in_place_t, Factory & factory) : instance(factory())
+	{
+	}
+
+	Mutex mutex;
+	Class instance;
+};
+
+/// Guard returned when locking a handle that has no synchronization policy.
+struct NoLock
+{
+};
+}  // namespace detail
+}  // namespace cppcapi::service
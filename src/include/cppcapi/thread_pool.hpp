@@ -0,0 +1,129 @@
+// Copyright 2022 David Feltell
+// SPDX-License-Identifier: MIT
+/**
+ * Contains the ThreadPool used as the default executor for asynchronous suite functions.
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "interface.h"
+
+namespace cppcapi
+{
+/**
+ * Simple fixed-size FIFO thread pool, exposable as a C cppcapi_Executor.
+ *
+ * Tasks are plain C function pointer + data pairs, so that executors can be injected across the C
+ * wall, e.g. a host can provide its own executor for a plugin's asynchronous suite functions.
+ */
+class ThreadPool
+{
+public:
+	/**
+	 * Constructor - start worker threads.
+	 *
+	 * @param num_threads Number of worker threads. Defaults to the hardware concurrency.
+	 */
+	explicit ThreadPool(std::size_t num_threads = default_num_threads())
+	{
+		threads_.reserve(num_threads);
+		for (std::size_t idx = 0; idx < num_threads; ++idx) threads_.emplace_back([this] { run(); });
+	}
+
+	ThreadPool(ThreadPool const &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool & operator=(ThreadPool const &) = delete;
+	ThreadPool & operator=(ThreadPool &&) = delete;
+
+	/// Destructor - drain remaining tasks then join worker threads.
+	~ThreadPool()
+	{
+		{
+			std::lock_guard lock{mutex_};
+			stopping_ = true;
+		}
+		cv_.notify_all();
+		for (auto & thread : threads_) thread.join();
+	}
+
+	/**
+	 * Queue a task for execution on a worker thread.
+	 *
+	 * @param task Function to execute.
+	 * @param data Argument to pass to `task`.
+	 */
+	void submit(cppcapi_Task task, void * data)
+	{
+		{
+			std::lock_guard lock{mutex_};
+			tasks_.emplace_back(task, data);
+		}
+		cv_.notify_one();
+	}
+
+	/**
+	 * Get a C executor that submits tasks to this pool.
+	 *
+	 * The returned executor is only valid for the lifetime of this pool.
+	 *
+	 * @return C executor struct.
+	 */
+	cppcapi_Executor executor()
+	{
+		return {
+			[](void * context, cppcapi_Task task, void * data)
+			{ static_cast<ThreadPool *>(context)->submit(task, data); },
+			this};
+	}
+
+	/// Number of threads to use if unspecified.
+	static std::size_t default_num_threads()
+	{
+		return std::max(std::thread::hardware_concurrency(), 1U);
+	}
+
+private:
+	void run()
+	{
+		while (true)
+		{
+			std::pair<cppcapi_Task, void *> task;
+			{
+				std::unique_lock lock{mutex_};
+				cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+				if (tasks_.empty())
+					return;	 // Stopping and drained.
+				task = tasks_.front();
+				tasks_.pop_front();
+			}
+			task.first(task.second);
+		}
+	}
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::deque<std::pair<cppcapi_Task, void *>> tasks_;
+	bool stopping_{false};
+	std::vector<std::thread> threads_;
+};
+
+/**
+ * Get the executor to use when a caller doesn't inject one.
+ *
+ * Lazily constructs a process-wide (or rather DSO-wide, given hidden visibility) ThreadPool.
+ *
+ * @return Executor wrapping the default ThreadPool.
+ */
+inline cppcapi_Executor default_executor()
+{
+	static ThreadPool pool;
+	return pool.executor();
+}
+}  // namespace cppcapi
@@ -1,5 +1,6 @@
 // Copyright 2022 David Feltell
 // SPDX-License-Identifier: MIT
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
@@ -39,10 +40,16 @@ int main()
 	plugin_path /= "libcppcapi-demo-hello_plugin-plugin.so";
 	std::cout << "Loading plugin at " << plugin_path << std::endl;
 
-	// Load the plugin DSO.
-	cppcapi::Loader loader{plugin_path.c_str()};
+	// Load the plugin DSO, resolving its symbols and suites up front.
+	auto const loader =
+		cppcapi::Loader::load_eager<Worker>(plugin_path.c_str(), "cppcapidemo_Worker_suite");
+	std::cout << "Loaded plugin in "
+			  << std::chrono::duration_cast<std::chrono::microseconds>(
+					 loader.timing().open + loader.timing().bind)
+					 .count()
+			  << "us" << std::endl;
 
-	auto worker = loader.load_adapter<Worker>("cppcapidemo_Worker_suite");
+	auto worker = loader.make_adapter<Worker>();
 
 	std::cout << "Host client telling plugin service to do work..." << std::endl;
 
@@ -19,7 +19,7 @@ extern "C"
 	} cppcapidemo_Worker_s;
 
 	// Host will expect plugin to define:
-	// cppcapidemo_Worker_s cppcapidemo_Worker_suite();
+	// cppcapidemo_Worker_s const * cppcapidemo_Worker_suite();
 
 #ifdef __cplusplus
 }
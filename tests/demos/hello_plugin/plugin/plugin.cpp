@@ -38,15 +38,16 @@ extern "C"
 
 	// Plugin
 
-	CPPCAPI_DEMO_PLUGIN_EXPORT cppcapidemo_Worker_s cppcapidemo_Worker_suite()
+	CPPCAPI_DEMO_PLUGIN_EXPORT cppcapidemo_Worker_s const * cppcapidemo_Worker_suite()
 	{
 		using Decorator = Plugin::SuiteDecorator<cppcapidemo_Worker_h>;
 
-		return {
+		static constexpr cppcapidemo_Worker_s suite{
 			.create = &Decorator::create,
 
 			.release = &Decorator::release,
 
 			.work = Decorator::decorate(Decorator::mem_fn_ptr<&Worker::work>)};
+		return &suite;
 	}
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ void execute()
 
 	// Load the plugin DSO.
 	cppcapi::Loader loader{plugin_path.c_str()};
+	// Rethrow the plugin's exceptions as-is, if it was built with the same toolchain.
+	loader.negotiate_abi();
 
 	// Create a shared StringDict to be used by both host and plugin.
 	auto dict = cppcapi::make_shared<service::StringDict>(
@@ -56,6 +58,15 @@ void execute()
 
 	std::cout << "Dict contents:" << std::endl;
 	for (auto [k, v] : *dict) std::cout << "  " << k << " = " << v << std::endl;
+
+	std::cout << "Try again, asynchronously:" << std::endl;
+
+	auto future = worker.update_dict_async("third key from host");
+	// ... do something else whilst the plugin is working ...
+	future.get();
+
+	std::cout << "Dict contents:" << std::endl;
+	for (auto [k, v] : *dict) std::cout << "  " << k << " = " << v << std::endl;
 }
 }  // namespace cppcapidemohost
 
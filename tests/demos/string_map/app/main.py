@@ -34,25 +34,29 @@ class cppcapidemo_String_s(ctypes.Structure):
         ("assign_StringView", CFUNCTYPE(c_int, cppcapi_ErrorMessage_p, c_void_p, c_void_p)),
         ("c_str", CFUNCTYPE(cppcapi_ErrorMessage_p, c_void_p)),
         ("at", CFUNCTYPE(c_int, cppcapi_ErrorMessage_p, c_char_p, c_void_p, c_int)),
+        ("create_from_cstr", CFUNCTYPE(c_int, cppcapi_ErrorMessage_p, c_void_p, c_char_p)),
+        ("create_from_chars",
+         CFUNCTYPE(c_int, cppcapi_ErrorMessage_p, c_void_p, c_char_p, ctypes.c_size_t)),
+        ("create_from_StringView", CFUNCTYPE(c_int, cppcapi_ErrorMessage_p, c_void_p, c_void_p)),
     ]
 
 
 class CString:
     def __init__(self, s: str):
         self.__chandle = c_void_p()
-        self.__csuite = host.cppcapidemo_String_suite()
+        self.__csuite = host.cppcapidemo_String_suite().contents
 
         self.__cerr_buffer = ctypes.create_string_buffer(500)
         self.__cerr = cppcapi_ErrorMessage(
             len(self.__cerr_buffer), 0, ctypes.addressof(self.__cerr_buffer))
 
-        code = self.__csuite.create(ctypes.byref(self.__cerr), ctypes.byref(self.__chandle))
+        data = s.encode()
+        code = self.__csuite.create_from_chars(
+            ctypes.byref(self.__cerr), ctypes.byref(self.__chandle), data, len(data))
         if code != 0:
             raise RuntimeError(
                 "Error code '%s' from C with message: '%s'" % (code, self.__cerr_buffer))
 
-        self.__csuite.assign_cstr(ctypes.byref(self.__cerr), self.__chandle, s.encode())
-
     def __del__(self):
         if self.__chandle.value:
             self.__csuite.release(self.__chandle)
@@ -71,7 +75,7 @@ class CString:
 
 if __name__ == "__main__":
     host = ctypes.CDLL(lib_path)
-    host.cppcapidemo_String_suite.restype = cppcapidemo_String_s
+    host.cppcapidemo_String_suite.restype = ctypes.POINTER(cppcapidemo_String_s)
 
     cstr = CString("some data")
 
@@ -16,4 +16,9 @@ void Worker::update_dict(service::StringView key)
 {
 	call(suite_.update_dict, key);
 }
+
+Worker::Future<void> Worker::update_dict_async(service::StringView key)
+{
+	return call_async(suite_.update_dict_async, key);
+}
 }  // namespace cppcapidemohost::client
@@ -12,6 +12,8 @@ struct CPPCAPI_DEMO_HOST_EXPORT Worker : Plugin::SuiteAdapter<cppcapidemo_Worker
 	Worker(SuiteFactory suite_factory, cppcapi::SharedPtr<service::StringDict> dict);
 
 	void update_dict(service::StringView key);
+
+	Future<void> update_dict_async(service::StringView key);
 };
 
 }  // namespace cppcapidemohost::client
@@ -3,6 +3,7 @@
 #pragma once
 #include <stdexcept>
 
+#include <cppcapi/commands.hpp>
 #include <cppcapi/plugin_definition.hpp>
 
 #include <cppcapi-demo-string_map/interface.h>
@@ -36,11 +37,12 @@ using Plugin = cppcapi::PluginDefinition<
 			service::String,
 			cppcapi::service::HandleOwnershipTag::OwnedByClient>,
 
-		// StringDict
+		// StringDict - shared between host and plugin threads, so lock on access.
 		cppcapi::service::HandleTraits<
 			cppcapidemo_StringDict_h,
 			service::StringDict,
-			cppcapi::service::HandleOwnershipTag::Shared>>,
+			cppcapi::service::HandleOwnershipTag::Shared,
+			cppcapi::service::StripedLock<>>>,
 
 	// Client
 	cppcapi::client::HandleMap<
@@ -55,4 +57,8 @@ using Plugin = cppcapi::PluginDefinition<
 		// Invalid argument.
 		cppcapi::ErrorTraits<std::invalid_argument, 101>>>;
 
+
+// Commands that can be batched into a single call to StringDict's `execute`.
+using StringDictCommands =
+	cppcapi::Commands<&cppcapidemo_StringDict_s::insert, &cppcapidemo_StringDict_s::at>;
 }  // namespace cppcapidemohost
\ No newline at end of file
@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: MIT
 #include "service.hpp"
 
+#include <utility>
+#include <vector>
+
 #include <cppcapi-demo-string_map/interface.h>
 
 #include "host_export.h"
@@ -15,11 +18,11 @@ extern "C"
 {
 	// String
 
-	CPPCAPI_DEMO_HOST_EXPORT cppcapidemo_String_s cppcapidemo_String_suite()
+	CPPCAPI_DEMO_HOST_EXPORT cppcapidemo_String_s const * cppcapidemo_String_suite()
 	{
 		using SuiteDecorator = Plugin::SuiteDecorator<cppcapidemo_String_h>;
 
-		return {
+		static constexpr cppcapidemo_String_s suite{
 			.create = &SuiteDecorator::create,
 
 			.release = &SuiteDecorator::release,
@@ -44,27 +47,36 @@ extern "C"
 			// clang-format on
 			// Lambda is more concise in this case due to overloaded `at`.
 			.at =
-				SuiteDecorator::decorate([](String const & self, size_t n) { return self.at(n); })};
+				SuiteDecorator::decorate([](String const & self, size_t n) { return self.at(n); }),
+
+			.create_from_cstr = SuiteDecorator::decorate_constructor<char const *>(),
+
+			.create_from_chars = SuiteDecorator::decorate_constructor<std::string_view>(),
+
+			.create_from_StringView =
+				SuiteDecorator::decorate_constructor<StringView const &>()};
+		return &suite;
 	}
 
 	// StringView
 
-	CPPCAPI_DEMO_HOST_EXPORT cppcapidemo_StringView_s cppcapidemo_StringView_suite()
+	CPPCAPI_DEMO_HOST_EXPORT cppcapidemo_StringView_s const * cppcapidemo_StringView_suite()
 	{
 		using Decorator = Plugin::SuiteDecorator<cppcapidemo_StringView_h>;
-		return {
+		static constexpr cppcapidemo_StringView_s suite{
 			.data = Decorator::decorate(Decorator::mem_fn_ptr<&StringView::data>),
 
 			.size = Decorator::decorate(Decorator::mem_fn_ptr<&StringView::size>)};
+		return &suite;
 	}
 
 	// StringDict
 
-	CPPCAPI_DEMO_HOST_EXPORT cppcapidemo_StringDict_s cppcapidemo_StringDict_suite()
+	CPPCAPI_DEMO_HOST_EXPORT cppcapidemo_StringDict_s const * cppcapidemo_StringDict_suite()
 	{
 		using Decorator = Plugin::SuiteDecorator<cppcapidemo_StringDict_h>;
 
-		return {
+		static constexpr cppcapidemo_StringDict_s suite{
 			.create = &Decorator::create,
 
 			.release = &Decorator::release,
@@ -74,9 +86,42 @@ extern "C"
 									{ self.insert_or_assign(std::move(key), std::move(value)); }),
 
 			.at = Decorator::decorate([](StringDict const & self, String const & key)
-									  { return self.at(key); })
+									  { return self.at(key); }),
+
+			.execute = &Decorator::execute<StringDictCommands, &cppcapidemo_StringDict_suite>,
+
+			// Snapshot taken under the dict's shared lock and owned by the cursor, so the dict can
+			// be modified, or released, whilst the cursor is open.
+			.open_entries = Decorator::decorate_range<
+				cppcapidemo_StringDictCursor_h,
+				cppcapidemo_StringDictEntry>(
+				[](StringDict const & self)
+				{ return std::vector<std::pair<String, String>>{self.begin(), self.end()}; },
+				[](std::pair<String, String> const & entry)
+				{
+					return cppcapidemo_StringDictEntry{entry.first.c_str(), entry.second.c_str()};
+				}),
+
+			.next_entries = &Decorator::next_chunk<
+				cppcapidemo_StringDictCursor_h,
+				cppcapidemo_StringDictEntry>,
+
+			.close_entries = &Decorator::close_cursor<cppcapidemo_StringDictCursor_h>};
+		return &suite;
+	}
 
-		};
+	CPPCAPI_DEMO_HOST_EXPORT cppcapi_SuiteMetadata const * cppcapidemo_StringDict_metadata()
+	{
+		return &Plugin::suite_metadata<
+			cppcapidemo_StringDict_h,
+			&cppcapidemo_StringDict_s::create,
+			&cppcapidemo_StringDict_s::release,
+			&cppcapidemo_StringDict_s::insert,
+			&cppcapidemo_StringDict_s::at,
+			&cppcapidemo_StringDict_s::execute,
+			&cppcapidemo_StringDict_s::open_entries,
+			&cppcapidemo_StringDict_s::next_entries,
+			&cppcapidemo_StringDict_s::close_entries>();
 	}
 }
 }  // namespace cppcapidemohost::service
\ No newline at end of file
@@ -23,7 +23,7 @@ extern "C"
 		size_t (*size)(cppcapidemo_StringView_h);		 // noexcept
 	} cppcapidemo_StringView_s;
 
-	cppcapidemo_StringView_s cppcapidemo_StringView_suite();
+	cppcapidemo_StringView_s const * cppcapidemo_StringView_suite();
 
 	// String
 
@@ -39,14 +39,32 @@ extern "C"
 			cppcapi_ErrorMessage *, cppcapidemo_String_h, cppcapidemo_StringView_h);
 		char const * (*c_str)(cppcapidemo_String_h);  // noexcept
 		cppcapi_ErrorCode (*at)(cppcapi_ErrorMessage *, char *, cppcapidemo_String_h, size_t);
+
+		// Named constructors, creating a fully-formed String in a single call.
+		cppcapi_ErrorCode (*create_from_cstr)(
+			cppcapi_ErrorMessage *, cppcapidemo_String_h *, char const *);
+		cppcapi_ErrorCode (*create_from_chars)(
+			cppcapi_ErrorMessage *, cppcapidemo_String_h *, char const *, size_t);
+		cppcapi_ErrorCode (*create_from_StringView)(
+			cppcapi_ErrorMessage *, cppcapidemo_String_h *, cppcapidemo_StringView_h);
 	} cppcapidemo_String_s;
 
-	cppcapidemo_String_s cppcapidemo_String_suite();
+	cppcapidemo_String_s const * cppcapidemo_String_suite();
 
 	// StringDict
 
 	typedef struct cppcapidemo_StringDict_t * cppcapidemo_StringDict_h;
 
+	// Cursor over the entries of a StringDict.
+	typedef struct cppcapidemo_StringDictCursor_t * cppcapidemo_StringDictCursor_h;
+
+	// Entry of a StringDict, valid until the dict is next modified.
+	typedef struct
+	{
+		char const * key;
+		char const * value;
+	} cppcapidemo_StringDictEntry;
+
 	typedef struct
 	{
 		cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, cppcapidemo_StringDict_h *);
@@ -64,9 +82,30 @@ extern "C"
 			cppcapidemo_String_h *,
 			cppcapidemo_StringDict_h,
 			cppcapidemo_String_h);
+
+		// Replay a buffer of commands, where opcode 0 is `insert` and opcode 1 is `at`.
+		cppcapi_ErrorCode (*execute)(
+			cppcapi_ErrorMessage *, cppcapi_CommandResult *, cppcapi_CommandBuffer const *);
+
+		// Iterate over a snapshot of the entries in chunks. Keys and values remain valid until the
+		// cursor is closed, even if the dict is modified.
+		cppcapi_ErrorCode (*open_entries)(
+			cppcapi_ErrorMessage *, cppcapidemo_StringDictCursor_h *, cppcapidemo_StringDict_h);
+
+		cppcapi_ErrorCode (*next_entries)(
+			cppcapi_ErrorMessage *,
+			size_t *,
+			cppcapidemo_StringDictCursor_h,
+			cppcapidemo_StringDictEntry *,
+			size_t);
+
+		void (*close_entries)(cppcapidemo_StringDictCursor_h);
 	} cppcapidemo_StringDict_s;
 
-	cppcapidemo_StringDict_s cppcapidemo_StringDict_suite();
+	cppcapidemo_StringDict_s const * cppcapidemo_StringDict_suite();
+
+	// Metadata describing the StringDict suite, for use by profilers, tracers, etc.
+	cppcapi_SuiteMetadata const * cppcapidemo_StringDict_metadata();
 
 	// Worker
 
@@ -82,10 +121,13 @@ extern "C"
 		cppcapi_ErrorCode (*update_dict)(
 			cppcapi_ErrorMessage *, cppcapidemo_Worker_h, cppcapidemo_StringView_h);
 
+		void (*update_dict_async)(
+			cppcapi_Completion const *, cppcapidemo_Worker_h, cppcapidemo_StringView_h);
+
 	} cppcapidemo_Worker_s;
 
 	// Defined within plugin.
-	//	cppcapidemo_Worker_s cppcapidemo_Worker_suite();
+	//	cppcapidemo_Worker_s const * cppcapidemo_Worker_suite();
 
 #ifdef __cplusplus
 }
@@ -9,20 +9,17 @@ namespace cppcapidemoplugin::client
 
 String::String(client::StringView const & str)
 {
-	Base::create();
-	call(suite_.assign_StringView, str);
+	create_with(suite_.create_from_StringView, str);
 }
 
 String::String(char const * str)
 {
-	Base::create();
-	call(suite_.assign_cstr, str);
+	create_with(suite_.create_from_cstr, str);
 }
 
 String::String(std::string const & str)
 {
-	Base::create();
-	call(suite_.assign_cstr, str.c_str());
+	create_with(suite_.create_from_chars, str.data(), str.size());
 }
 
 char const * String::c_str() const
@@ -69,4 +66,24 @@ void StringDict::insert(String const & key, String const & value)
 {
 	call(suite_.insert, key, value);
 }
+
+StringDict::Entries StringDict::entries() const
+{
+	return range(suite_.open_entries, suite_.next_entries, suite_.close_entries);
+}
+
+StringDict::Batch::Result<cppcapidemo_String_h> StringDict::at(Batch & batch, String key) const
+{
+	return record<&cppcapidemo_StringDict_s::at>(batch, std::move(key));
+}
+
+void StringDict::insert(Batch & batch, String key, String value) const
+{
+	record<&cppcapidemo_StringDict_s::insert>(batch, std::move(key), std::move(value));
+}
+
+void StringDict::execute(Batch & batch) const
+{
+	Base::execute(batch);
+}
 }  // namespace cppcapidemoplugin::client
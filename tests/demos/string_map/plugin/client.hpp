@@ -39,11 +39,24 @@ struct String : Plugin::SuiteAdapter<cppcapidemo_String_h>
 struct StringDict : Plugin::SuiteAdapter<cppcapidemo_StringDict_h>
 {
 	using Base::SuiteAdapter;
+	using Batch = CommandBuffer<StringDictCommands>;
+	using Entries = Range<cppcapidemo_StringDictCursor_h, cppcapidemo_StringDictEntry>;
 
 	StringDict();
 
 	[[nodiscard]] String at(String const & key);
 
 	void insert(String const & key, String const & value);
+
+	// Iterate entries, fetched from the service in chunks.
+	[[nodiscard]] Entries entries() const;
+
+	// Batched versions, deferred until `execute`.
+
+	[[nodiscard]] Batch::Result<cppcapidemo_String_h> at(Batch & batch, String key) const;
+
+	void insert(Batch & batch, String key, String value) const;
+
+	void execute(Batch & batch) const;
 };
 }  // namespace cppcapidemoplugin::client
@@ -3,6 +3,7 @@
 #pragma once
 #include <stdexcept>
 
+#include <cppcapi/commands.hpp>
 #include <cppcapi/plugin_definition.hpp>
 
 #include <cppcapi-demo-string_map/interface.h>
@@ -32,19 +33,22 @@ using Plugin = cppcapi::PluginDefinition<
 
 	// Client
 	cppcapi::client::HandleMap<
-		// String.
+		// String, immutable so `c_str` can be cached.
 		cppcapi::client::HandleTraits<
 			cppcapidemo_String_h,
 			cppcapidemo_String_s,
 			cppcapidemoplugin::client::String,
-			&cppcapidemo_String_suite>,
+			&cppcapidemo_String_suite,
+			&cppcapidemo_String_s::c_str>,
 
-		// StringView.
+		// StringView, immutable so `data` and `size` can be cached.
 		cppcapi::client::HandleTraits<
 			cppcapidemo_StringView_h,
 			cppcapidemo_StringView_s,
 			cppcapidemoplugin::client::StringView,
-			&cppcapidemo_StringView_suite>,
+			&cppcapidemo_StringView_suite,
+			&cppcapidemo_StringView_s::data,
+			&cppcapidemo_StringView_s::size>,
 
 		// StringDict
 		cppcapi::client::HandleTraits<
@@ -60,4 +64,8 @@ using Plugin = cppcapi::PluginDefinition<
 
 		// Out of range - e.g. map.at(...).
 		cppcapi::ErrorTraits<std::out_of_range, 100>>>;
+
+// Commands that can be batched into a single call to StringDict's `execute`.
+using StringDictCommands =
+	cppcapi::Commands<&cppcapidemo_StringDict_s::insert, &cppcapidemo_StringDict_s::at>;
 }  // namespace cppcapidemoplugin
\ No newline at end of file
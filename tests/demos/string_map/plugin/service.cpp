@@ -21,8 +21,18 @@ Worker::Worker(client::StringDict service_dict) : service_dict_{std::move(servic
  */
 void Worker::update_dict(client::String const & key)
 {
-	client_dict_.insert(client::String{"plugin client key"}, client::String{"plugin client value"});
-	client::String client_value = client_dict_.at(client::String{"plugin client key"});
+	// Batch up calls to the host to reduce overhead.
+	client::StringDict::Batch batch;
+	client_dict_.insert(
+		batch, client::String{"plugin client key"}, client::String{"plugin client value"});
+	auto const client_value_result = client_dict_.at(batch, client::String{"plugin client key"});
+	client_dict_.execute(batch);
+	client::String client_value{client_value_result.get()};
+
+	std::size_t num_entries = 0;
+	for ([[maybe_unused]] auto const & entry : service_dict_.entries()) ++num_entries;
+	std::cout << "Plugin sees " << num_entries << " entries in host dict" << std::endl;
+
 	try
 	{
 		auto const & value = service_dict_.at(client::String{"plugin expects to exist"});
@@ -50,14 +60,24 @@ extern "C"
 
 	// Plugin
 
-	CPPCAPI_DEMO_PLUGIN_EXPORT cppcapidemo_Worker_s cppcapidemo_Worker_suite()
+	CPPCAPI_DEMO_PLUGIN_EXPORT cppcapidemo_Worker_s const * cppcapidemo_Worker_suite()
 	{
-		return {
+		static constexpr cppcapidemo_Worker_s suite{
 			.create = &SuiteDecorator::create,
 
 			.release = &SuiteDecorator::release,
 
-			.update_dict = SuiteDecorator::decorate<&update_dict>()};
+			.update_dict = SuiteDecorator::decorate<&update_dict>(),
+
+			.update_dict_async = SuiteDecorator::decorate_async<&update_dict>()};
+		return &suite;
+	}
+
+	// ABI
+
+	CPPCAPI_DEMO_PLUGIN_EXPORT int cppcapi_negotiate_abi(char const * client_fingerprint)
+	{
+		return cppcapi::service::negotiate_abi(client_fingerprint);
 	}
 }
 }  // namespace cppcapidemoplugin::service
\ No newline at end of file
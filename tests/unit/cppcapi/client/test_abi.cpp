@@ -0,0 +1,173 @@
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/abi.hpp>
+#include <cppcapi/client/error_buffer.hpp>
+#include <cppcapi/interface.h>
+#include <cppcapi/loader.hpp>
+#include <cppcapi/plugin_definition.hpp>
+
+#include "../../plugins/counter/client.hpp"
+
+namespace
+{
+using ParserHandle = struct Parser_t *;
+
+struct ParserSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, ParserHandle *);
+	void (*release)(ParserHandle);
+	cppcapi_ErrorCode (*parse)(cppcapi_ErrorMessage *, int *, ParserHandle, char const *);
+};
+
+/// Exception not mapped by the ErrorMap, carrying more than its message.
+struct ParseError : std::runtime_error
+{
+	ParseError(std::string const & message, std::size_t position_)
+		: runtime_error{message}, position{position_}
+	{
+	}
+
+	std::size_t position;
+};
+
+struct Parser
+{
+	[[nodiscard]] int parse(char const * text) const
+	{
+		std::string const str{text};
+		std::size_t const position = str.find_first_not_of("0123456789");
+		if (position != std::string::npos)
+			throw ParseError{"Unexpected character", position};
+		return std::stoi(str);
+	}
+};
+
+using ErrorMap = cppcapi::ErrorMap<cppcapi::ErrorTraits<std::out_of_range, 101>>;
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		ParserHandle,
+		Parser,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	ErrorMap>;
+
+ParserSuite const * parser_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<ParserHandle>;
+	static constexpr ParserSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::mem_fn_ptr<&Parser::parse>)};
+	return &suite;
+}
+
+/// Stand-in for the function a service DSO exports as CPPCAPI_NEGOTIATE_ABI_SYMBOL.
+int negotiate_abi(char const * client_fingerprint)
+{
+	return cppcapi::service::negotiate_abi(client_fingerprint);
+}
+
+struct ParserAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<ParserHandle, ParserSuite, ParserAdapter, &parser_suite>>,
+	ErrorMap>;
+
+struct ParserAdapter : ClientPlugin::SuiteAdapter<ParserHandle>
+{
+	ParserAdapter() : Base{ksuite_factory}
+	{
+		create();
+	}
+
+	[[nodiscard]] int parse(char const * text) const
+	{
+		return call(suite_.parse, text);
+	}
+
+	[[nodiscard]] cppcapi::client::Result<int> try_parse(char const * text) const
+	{
+		return try_call(suite_.parse, text);
+	}
+};
+}  // namespace
+
+// Negotiation is process-wide and a mismatch is permanent, so sections must form a single path.
+SCENARIO("Passing exceptions as-is between matching ABIs")
+{
+	GIVEN("an adapter for a service built with the same toolchain")
+	{
+		ParserAdapter const parser;
+		CHECK_THROWS_AS(parser.parse("12x"), cppcapi::UnknownError);
+
+		WHEN("the ABI is negotiated")
+		{
+			REQUIRE(cppcapi::client::negotiate_abi(&negotiate_abi));
+
+			THEN("the original exception is rethrown, unless calling without throwing")
+			{
+				CHECK(parser.parse("12") == 12);
+				CHECK_THROWS_MATCHES(
+					parser.parse("12x"),
+					ParseError,
+					Catch::Predicate<ParseError>(
+						[](ParseError const & thrown) { return thrown.position == 2; }));
+				CHECK_THROWS_AS(parser.parse("99999999999999999999"), std::out_of_range);
+
+				auto const parsed = parser.try_parse("12x");
+				REQUIRE_FALSE(parsed);
+				CHECK(parsed.error().code == cppcapi_error);
+				CHECK(parsed.error().message == "Unexpected character");
+
+				// A client with a different ABI requesting the original exception gets a message.
+				cppcapi::client::detail::ErrorBuffer buffer{};
+				char const * const other_fingerprint = "other-compiler;other-stdlib";
+				std::memcpy(buffer.payload.data, &other_fingerprint, sizeof(other_fingerprint));
+				buffer.payload.size = sizeof(other_fingerprint);
+				cppcapi_ErrorMessage err{
+					cppcapi::client::detail::error_buffer_capacity,
+					cppcapi_error_exception_requested,
+					buffer.message};
+				int out = 0;
+
+				CHECK(
+					parser_suite()->parse(&err, &out, static_cast<ParserHandle>(parser), "12x") ==
+					cppcapi_error);
+				CHECK(buffer.payload.type != CPPCAPI_ERROR_PAYLOAD_EXCEPTION);
+				CHECK(std::string_view{err.data, err.size} == "Unexpected character");
+
+				// A second service, in its own DSO, that this client hasn't negotiated with.
+				cppcapi::Loader const loader{CPPCAPI_TEST_COUNTER_PLUGIN_PATH, RTLD_NOW};
+				auto const counter =
+					loader.load_adapter<cppcapitest::Counter>(cppcapitest::kcounter_suite_name);
+				counter.add(1);
+				CHECK_THROWS_MATCHES(
+					counter.add(std::numeric_limits<std::uint64_t>::max()),
+					cppcapi::UnknownError,
+					Catch::Message("Counter overflow"));
+
+				AND_WHEN("a client with a different ABI negotiates")
+				{
+					CHECK_FALSE(cppcapi::client::negotiate_abi(
+						[](char const *) { return negotiate_abi("other-compiler;other-stdlib"); }));
+
+					THEN("exceptions are converted via the error map again")
+					{
+						CHECK_THROWS_MATCHES(
+							parser.parse("12x"),
+							cppcapi::UnknownError,
+							Catch::Message("Unexpected character"));
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,169 @@
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+#include "../../fixtures/live_counter.hpp"
+
+namespace
+{
+using CounterHandle = struct Counter_t *;
+using ObserverHandle = struct Observer_t *;
+
+struct CounterSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, CounterHandle *, int);
+	void (*release)(CounterHandle);
+	int (*get)(CounterHandle);
+};
+
+struct ObserverSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, ObserverHandle *);
+	void (*release)(ObserverHandle);
+	cppcapi_ErrorCode (*read)(cppcapi_ErrorMessage *, int *, ObserverHandle, CounterHandle);
+	cppcapi_ErrorCode (*adopt)(cppcapi_ErrorMessage *, ObserverHandle, CounterHandle);
+};
+
+using Counter = cppcapitest::LiveCounter;
+
+using CounterPlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		CounterHandle,
+		Counter,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+CounterSuite const * counter_suite()
+{
+	using Decorator = CounterPlugin::SuiteDecorator<CounterHandle>;
+	static constexpr CounterSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::mem_fn_ptr<&Counter::get>)};
+	return &suite;
+}
+
+struct CounterAdapter;
+struct Observer;
+
+using ObserverPlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		ObserverHandle,
+		Observer,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<CounterHandle, CounterSuite, CounterAdapter, &counter_suite>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+struct CounterAdapter : ObserverPlugin::SuiteAdapter<CounterHandle>
+{
+	using Base::Base;
+
+	[[nodiscard]] int get() const
+	{
+		return call(suite_.get);
+	}
+};
+
+/// Service in another plugin, given handles to counters by its clients.
+struct Observer
+{
+	[[nodiscard]] static int read(CounterAdapter const & counter)
+	{
+		return counter.get();
+	}
+
+	void adopt(CounterAdapter counter)
+	{
+		counters.push_back(std::move(counter));
+	}
+
+	std::vector<CounterAdapter> counters;
+};
+
+ObserverSuite const * observer_suite()
+{
+	using Decorator = ObserverPlugin::SuiteDecorator<ObserverHandle>;
+	static constexpr ObserverSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(
+			[](Observer const &, CounterAdapter const & counter)
+			{ return Observer::read(counter); }),
+		Decorator::decorate(Decorator::mem_fn_ptr<&Observer::adopt>)};
+	return &suite;
+}
+}  // namespace
+
+SCENARIO("Passing client adapters to service functions")
+{
+	GIVEN("a counter and an observer in another plugin")
+	{
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		CounterHandle counter = nullptr;
+		ObserverHandle observer = nullptr;
+		REQUIRE(counter_suite()->create(&err, &counter, 7) == cppcapi_ok);
+		REQUIRE(observer_suite()->create(&err, &observer) == cppcapi_ok);
+
+		WHEN("the counter is lent to a function taking an adapter by reference")
+		{
+			int value = 0;
+			REQUIRE(observer_suite()->read(&err, &value, observer, counter) == cppcapi_ok);
+			observer_suite()->release(observer);
+
+			THEN("the counter is accessed via a borrowed adapter")
+			{
+				CHECK(value == 7);
+			}
+
+			THEN("the counter is not released")
+			{
+				CHECK(Counter::num_alive == 1);
+				CHECK(counter_suite()->get(counter) == 7);
+			}
+
+			counter_suite()->release(counter);
+		}
+
+		WHEN("the counter is given to a function taking an adapter by value")
+		{
+			REQUIRE(observer_suite()->adopt(&err, observer, counter) == cppcapi_ok);
+
+			THEN("ownership of the counter is transferred")
+			{
+				CHECK(Counter::num_alive == 1);
+				observer_suite()->release(observer);
+				CHECK(Counter::num_alive == 0);
+			}
+		}
+	}
+}
+
+SCENARIO("Borrowing a handle on the client")
+{
+	GIVEN("a handle owned elsewhere")
+	{
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		CounterHandle handle = nullptr;
+		REQUIRE(counter_suite()->create(&err, &handle, 3) == cppcapi_ok);
+
+		WHEN("the handle is wrapped in a borrowed adapter that goes out of scope")
+		{
+			{
+				cppcapi::client::Borrowed<CounterAdapter> const counter{handle};
+				CHECK(counter->get() == 3);
+			}
+
+			THEN("the handle is still valid")
+			{
+				CHECK(counter_suite()->get(handle) == 3);
+				counter_suite()->release(handle);
+				CHECK(Counter::num_alive == 0);
+			}
+		}
+	}
+}
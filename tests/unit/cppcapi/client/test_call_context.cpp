@@ -0,0 +1,167 @@
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+#include <cppcapi/service/call_context.hpp>
+
+namespace
+{
+using WorkerHandle = struct Worker_t *;
+
+struct WorkerSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, WorkerHandle *);
+	void (*release)(WorkerHandle);
+	cppcapi_ErrorCode (*work)(
+		cppcapi_ErrorMessage *, int *, WorkerHandle, cppcapi_CallContext const *, int);
+};
+
+struct Worker
+{
+	/// Count up to `iterations`, stopping early if cancelled.
+	int work(cppcapi::service::CallContext const & context, int const iterations)
+	{
+		for (int idx = 0; idx < iterations; ++idx)
+		{
+			context.throw_if_aborted();
+			++calls;
+		}
+		return calls;
+	}
+
+	int calls{0};
+};
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		WorkerHandle,
+		Worker,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+WorkerSuite const * worker_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<WorkerHandle>;
+	static constexpr WorkerSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::mem_fn_ptr<&Worker::work>)};
+	return &suite;
+}
+
+struct WorkerAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<WorkerHandle, WorkerSuite, WorkerAdapter, &worker_suite>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+struct WorkerAdapter : ClientPlugin::SuiteAdapter<WorkerHandle>
+{
+	WorkerAdapter() : Base{ksuite_factory}
+	{
+		create();
+	}
+
+	int work(int const iterations)
+	{
+		return call(suite_.work, iterations);
+	}
+
+	int work(cppcapi::client::CallContext const & context, int const iterations)
+	{
+		return call(suite_.work, context, iterations);
+	}
+};
+}  // namespace
+
+SCENARIO("Attaching deadlines and cancellation to calls")
+{
+	using cppcapi::client::CallContext;
+
+	GIVEN("an adapter wrapping a service that takes a call context")
+	{
+		WorkerAdapter worker;
+
+		WHEN("no context is given")
+		{
+			THEN("the call runs to completion")
+			{
+				CHECK(worker.work(3) == 3);
+			}
+		}
+
+		WHEN("a context with a future deadline is given")
+		{
+			CallContext const context{std::chrono::hours{1}};
+
+			THEN("the call runs to completion")
+			{
+				CHECK(worker.work(context, 3) == 3);
+			}
+		}
+
+		WHEN("a context with a passed deadline is given")
+		{
+			CallContext const context{CallContext::Clock::now() - std::chrono::seconds{1}};
+
+			THEN("the call fails without starting")
+			{
+				// DeadlineExceeded derives from std::runtime_error, but the reserved code takes
+				// precedence over the ErrorMap.
+				CHECK_THROWS_AS(worker.work(context, 3), cppcapi::DeadlineExceeded);
+				CHECK(worker.work(0) == 0);
+			}
+		}
+
+		WHEN("a context is cancelled")
+		{
+			CallContext context;
+			context.cancel();
+
+			THEN("the call fails with a cancellation error")
+			{
+				CHECK_THROWS_AS(worker.work(context, 3), cppcapi::Cancelled);
+			}
+		}
+
+		WHEN("a context is cancelled from another thread mid-call")
+		{
+			CallContext context;
+			std::thread canceller{[&context]
+								  {
+									  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+									  context.cancel();
+								  }};
+
+			THEN("the callable can observe the cancellation")
+			{
+				CHECK_THROWS_AS(worker.work(context, 1'000'000'000), cppcapi::Cancelled);
+			}
+			canceller.join();
+		}
+
+		WHEN("a cancelled context is made current on this thread")
+		{
+			CallContext context;
+			context.cancel();
+
+			THEN("calls not given an explicit context use it")
+			{
+				CallContext::Scope const scope{context};
+				CHECK_THROWS_AS(worker.work(3), cppcapi::Cancelled);
+			}
+
+			THEN("the context is no longer used once the scope ends")
+			{
+				{
+					CallContext::Scope const scope{context};
+				}
+				CHECK(worker.work(3) == 3);
+			}
+		}
+	}
+}
@@ -0,0 +1,176 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/commands.hpp>
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using ListHandle = struct List_t *;
+
+struct ListSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, ListHandle *);
+	void (*release)(ListHandle);
+	cppcapi_ErrorCode (*push)(cppcapi_ErrorMessage *, ListHandle, int);
+	cppcapi_ErrorCode (*at)(cppcapi_ErrorMessage *, int *, ListHandle, std::size_t);
+	void (*clear)(ListHandle);
+	cppcapi_ErrorCode (*execute)(
+		cppcapi_ErrorMessage *, cppcapi_CommandResult *, cppcapi_CommandBuffer const *);
+};
+
+using ListCommands = cppcapi::Commands<&ListSuite::push, &ListSuite::at, &ListSuite::clear>;
+
+using ErrorMap = cppcapi::ErrorMap<
+	cppcapi::ErrorTraits<std::invalid_argument, 101>,
+	cppcapi::ErrorTraits<std::out_of_range, 102>>;
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		ListHandle,
+		std::vector<int>,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	ErrorMap>;
+
+ListSuite const * list_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<ListHandle>;
+	static constexpr ListSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(
+			[](std::vector<int> & self, int value)
+			{
+				if (value < 0)
+					throw std::invalid_argument{"Negative value"};
+				self.push_back(value);
+			}),
+		Decorator::decorate(
+			[](std::vector<int> const & self, std::size_t idx) { return self.at(idx); }),
+		Decorator::decorate([](std::vector<int> & self) { self.clear(); }),
+		&Decorator::execute<ListCommands, &list_suite>};
+	return &suite;
+}
+
+struct ListAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<ListHandle, ListSuite, ListAdapter, &list_suite>>,
+	ErrorMap>;
+
+struct ListAdapter : ClientPlugin::SuiteAdapter<ListHandle>
+{
+	using Batch = CommandBuffer<ListCommands>;
+
+	ListAdapter() : Base{ksuite_factory}
+	{
+		create();
+	}
+
+	std::size_t push(Batch & batch, int value) const
+	{
+		return record<&ListSuite::push>(batch, value);
+	}
+
+	Batch::Result<int> at(Batch & batch, std::size_t idx) const
+	{
+		return record<&ListSuite::at>(batch, idx);
+	}
+
+	void clear(Batch & batch) const
+	{
+		record<&ListSuite::clear>(batch);
+	}
+
+	cppcapi_ErrorCode execute(Batch & batch) const
+	{
+		return Base::execute(batch);
+	}
+};
+}  // namespace
+
+SCENARIO("Recording and replaying suite function calls")
+{
+	GIVEN("an adapter and a command buffer")
+	{
+		ListAdapter list;
+		ListAdapter::Batch batch;
+
+		WHEN("successful commands are recorded and executed")
+		{
+			list.push(batch, 1);
+			list.push(batch, 2);
+			auto const second = list.at(batch, 1);
+
+			CHECK(batch.size() == 3);
+			CHECK(list.execute(batch) == cppcapi_ok);
+
+			THEN("out-parameters are available")
+			{
+				CHECK(second.get() == 2);
+				CHECK(second.index() == 2);
+			}
+		}
+
+		WHEN("some commands fail")
+		{
+			list.push(batch, 1);
+			auto const failed_push = list.push(batch, -1);
+			auto const failed_at = list.at(batch, 5);
+			auto const first = list.at(batch, 0);
+
+			CHECK(list.execute(batch) == 101);
+
+			THEN("each command's error is reported independently")
+			{
+				CHECK(batch.code(0) == cppcapi_ok);
+				CHECK_THROWS_WITH(batch.throw_on_error(failed_push), "Negative value");
+				CHECK_THROWS_AS(failed_at.get(), std::out_of_range);
+				CHECK(first.get() == 1);
+			}
+		}
+
+		WHEN("the buffer is cleared and re-used")
+		{
+			list.push(batch, 1);
+			list.execute(batch);
+			batch.clear();
+			list.clear(batch);
+			auto const after_clear = list.at(batch, 0);
+			list.execute(batch);
+
+			THEN("commands from the previous execution are not replayed")
+			{
+				CHECK(batch.size() == 2);
+				CHECK_THROWS_AS(after_clear.get(), std::out_of_range);
+			}
+		}
+	}
+
+	GIVEN("a malformed buffer")
+	{
+		std::vector<unsigned char> data;
+		ListCommands::encode<&ListSuite::clear>(data, ListHandle{});
+		std::vector<cppcapi_CommandResult> results(2);
+		char storage[100];
+		cppcapi_ErrorMessage err{sizeof(storage), 0, storage};
+		cppcapi_CommandBuffer const buffer{data.data(), data.size() - 1, 1};
+
+		WHEN("it is executed")
+		{
+			cppcapi_ErrorCode const code = list_suite()->execute(&err, results.data(), &buffer);
+
+			THEN("an error is returned")
+			{
+				CHECK(code == cppcapi_error);
+				CHECK(std::string_view(err.data, err.size) == "Malformed command buffer");
+			}
+		}
+	}
+}
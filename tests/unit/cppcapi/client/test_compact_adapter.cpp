@@ -0,0 +1,198 @@
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+#include "../../fixtures/live_counter.hpp"
+
+namespace
+{
+using CounterHandle = struct Counter_t *;
+using LoadedCounterHandle = struct LoadedCounter_t *;
+
+template <class Handle>
+struct CounterSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, Handle *, int);
+	void (*release)(Handle);
+	int (*get)(Handle);
+	cppcapi_ErrorCode (*increment)(cppcapi_ErrorMessage *, Handle);
+};
+
+using Counter = cppcapitest::LiveCounter;
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<
+		cppcapi::service::HandleTraits<
+			CounterHandle,
+			Counter,
+			cppcapi::service::HandleOwnershipTag::OwnedByClient>,
+		cppcapi::service::HandleTraits<
+			LoadedCounterHandle,
+			Counter,
+			cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::out_of_range, 100>>>;
+
+template <class Handle>
+CounterSuite<Handle> const * counter_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<Handle>;
+	static constexpr CounterSuite<Handle> suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::template mem_fn_ptr<&Counter::get>),
+		Decorator::decorate(Decorator::template mem_fn_ptr<&Counter::increment>)};
+	return &suite;
+}
+
+/// Alternative suite for the same handle type, e.g. as if from another plugin.
+CounterSuite<LoadedCounterHandle> const * other_counter_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<LoadedCounterHandle>;
+	static constexpr CounterSuite<LoadedCounterHandle> suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::mem_fn_ptr<&Counter::get>),
+		Decorator::decorate(Decorator::mem_fn_ptr<&Counter::increment>)};
+	return &suite;
+}
+
+template <class Handle>
+struct CounterAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<
+			CounterHandle,
+			CounterSuite<CounterHandle>,
+			CounterAdapter<CounterHandle>,
+			&counter_suite<CounterHandle>>,
+		cppcapi::client::HandleTraits<
+			LoadedCounterHandle,
+			CounterSuite<LoadedCounterHandle>,
+			CounterAdapter<LoadedCounterHandle>>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::out_of_range, 100>>>;
+
+template <class Handle>
+struct CounterAdapter : ClientPlugin::CompactSuiteAdapter<Handle>
+{
+	using Base = ClientPlugin::CompactSuiteAdapter<Handle>;
+	using Base::Base;
+
+	CounterAdapter(typename Base::SuiteFactory suite_factory, int const start)
+		: Base{suite_factory}
+	{
+		this->create(start);
+	}
+
+	[[nodiscard]] int get() const
+	{
+		return this->call(this->suite().get);
+	}
+
+	void increment()
+	{
+		this->call(this->suite().increment);
+	}
+};
+}  // namespace
+
+SCENARIO("Compact adapters sharing a single suite")
+{
+	static_assert(sizeof(CounterAdapter<CounterHandle>) == sizeof(CounterHandle));
+	static_assert(!std::is_polymorphic_v<CounterAdapter<CounterHandle>>);
+
+	GIVEN("a handle type with a compile-time known suite factory")
+	{
+		using Adapter = CounterAdapter<CounterHandle>;
+
+		WHEN("adapters are constructed and stored contiguously")
+		{
+			std::vector<Adapter> counters;
+			counters.reserve(3);
+			for (int start = 0; start < 3; ++start)
+				counters.emplace_back(&counter_suite<CounterHandle>, start);
+			counters[1].increment();
+
+			THEN("each adapter wraps its own instance")
+			{
+				CHECK(counters[0].get() == 0);
+				CHECK(counters[1].get() == 2);
+				CHECK(counters[2].get() == 2);
+				CHECK(Counter::num_alive == 3);
+			}
+
+			THEN("the adapters are laid out as raw handles")
+			{
+				auto const * handles = reinterpret_cast<CounterHandle const *>(counters.data());
+				for (std::size_t idx = 0; idx < counters.size(); ++idx)
+					CHECK(handles[idx] == static_cast<CounterHandle>(counters[idx]));
+			}
+
+			THEN("errors are propagated")
+			{
+				Adapter counter{&counter_suite<CounterHandle>, 9};
+				CHECK_THROWS_AS(counter.increment(), std::out_of_range);
+			}
+		}
+
+		WHEN("a handle created elsewhere is wrapped")
+		{
+			cppcapi_ErrorMessage err{0, 0, nullptr};
+			CounterHandle handle = nullptr;
+			REQUIRE(counter_suite<CounterHandle>()->create(&err, &handle, 5) == cppcapi_ok);
+			{
+				Adapter const counter{handle};
+
+				THEN("the suite from the compile-time factory is used")
+				{
+					CHECK(counter.get() == 5);
+				}
+			}
+
+			THEN("the instance is released along with the adapter")
+			{
+				CHECK(Counter::num_alive == 0);
+			}
+		}
+	}
+
+	GIVEN("a handle type whose suite must be provided at runtime")
+	{
+		using Adapter = CounterAdapter<LoadedCounterHandle>;
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		LoadedCounterHandle handle = nullptr;
+		REQUIRE(counter_suite<LoadedCounterHandle>()->create(&err, &handle, 3) == cppcapi_ok);
+
+		WHEN("a handle is wrapped before any adapter has resolved the suite")
+		{
+			THEN("construction fails")
+			{
+				CHECK_THROWS_AS(Adapter{handle}, std::logic_error);
+				counter_suite<LoadedCounterHandle>()->release(handle);
+			}
+		}
+
+		WHEN("an adapter is constructed with the suite, as if via Loader::load_adapter")
+		{
+			Adapter const loaded{&counter_suite<LoadedCounterHandle>, 1};
+
+			THEN("subsequent adapters wrapping a handle use the resolved suite")
+			{
+				Adapter const counter{handle};
+				CHECK(counter.get() == 3);
+				CHECK(loaded.get() == 1);
+			}
+
+			THEN("adapters cannot be constructed with a different suite")
+			{
+				CHECK_THROWS_AS((Adapter{&other_counter_suite, 1}), std::logic_error);
+				counter_suite<LoadedCounterHandle>()->release(handle);
+			}
+		}
+	}
+}
@@ -0,0 +1,191 @@
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+#include "../../fixtures/live_counter.hpp"
+
+namespace
+{
+using SharedCounterHandle = struct SharedCounter_t *;
+using IntrusiveCounterHandle = struct IntrusiveCounter_t *;
+using UniqueCounterHandle = struct UniqueCounter_t *;
+
+using Counter = cppcapitest::LiveCounter;
+
+struct SharedCounterSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, SharedCounterHandle *);
+	void (*release)(SharedCounterHandle);
+	cppcapi_ErrorCode (*clone)(
+		cppcapi_ErrorMessage *, SharedCounterHandle *, SharedCounterHandle);
+	int (*increment)(SharedCounterHandle);
+};
+
+struct IntrusiveCounterSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, IntrusiveCounterHandle *);
+	void (*release)(IntrusiveCounterHandle);
+	void (*retain)(IntrusiveCounterHandle);
+	int (*increment)(IntrusiveCounterHandle);
+};
+
+struct UniqueCounterSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, UniqueCounterHandle *);
+	void (*release)(UniqueCounterHandle);
+	int (*increment)(UniqueCounterHandle);
+};
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<
+		cppcapi::service::HandleTraits<
+			SharedCounterHandle,
+			Counter,
+			cppcapi::service::HandleOwnershipTag::Shared>,
+		cppcapi::service::HandleTraits<
+			IntrusiveCounterHandle,
+			Counter,
+			cppcapi::service::HandleOwnershipTag::OwnedByClient>,
+		cppcapi::service::HandleTraits<
+			UniqueCounterHandle,
+			Counter,
+			cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+int increment(Counter & self)
+{
+	return ++self.value;
+}
+
+SharedCounterSuite const * shared_counter_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<SharedCounterHandle>;
+	static constexpr SharedCounterSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		&Decorator::clone,
+		Decorator::decorate(Decorator::free_fn_ptr<&increment>)};
+	return &suite;
+}
+
+IntrusiveCounterSuite const * intrusive_counter_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<IntrusiveCounterHandle>;
+	using Manager = ServicePlugin::HandleManager<IntrusiveCounterHandle>;
+	static constexpr IntrusiveCounterSuite suite{
+		&Decorator::create,
+		[](IntrusiveCounterHandle handle)
+		{
+			if (--Manager::to_instance(handle).num_refs == 0)
+				Manager::release(handle);
+		},
+		[](IntrusiveCounterHandle handle) { ++Manager::to_instance(handle).num_refs; },
+		Decorator::decorate(Decorator::free_fn_ptr<&increment>)};
+	return &suite;
+}
+
+UniqueCounterSuite const * unique_counter_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<UniqueCounterHandle>;
+	static constexpr UniqueCounterSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::free_fn_ptr<&increment>)};
+	return &suite;
+}
+
+template <class Handle>
+struct CounterAdapter;
+
+template <class Handle, class Suite>
+using ClientTraits = cppcapi::client::HandleTraits<Handle, Suite, CounterAdapter<Handle>>;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		ClientTraits<SharedCounterHandle, SharedCounterSuite>,
+		ClientTraits<IntrusiveCounterHandle, IntrusiveCounterSuite>,
+		ClientTraits<UniqueCounterHandle, UniqueCounterSuite>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+template <class Handle>
+struct CounterAdapter : ClientPlugin::SuiteAdapter<Handle>
+{
+	using Base = ClientPlugin::SuiteAdapter<Handle>;
+
+	explicit CounterAdapter(typename Base::SuiteFactory suite_factory) : Base{suite_factory}
+	{
+		this->create();
+	}
+
+	int increment()
+	{
+		return this->call(this->suite_.increment);
+	}
+};
+}  // namespace
+
+TEMPLATE_TEST_CASE(
+	"Copying adapters whose suite can add references",
+	"",
+	SharedCounterHandle,
+	IntrusiveCounterHandle)
+{
+	using Adapter = CounterAdapter<TestType>;
+	auto const factory = []
+	{
+		if constexpr (std::is_same_v<TestType, SharedCounterHandle>)
+			return &shared_counter_suite;
+		else
+			return &intrusive_counter_suite;
+	}();
+
+	static_assert(std::is_copy_constructible_v<Adapter>);
+	static_assert(std::is_nothrow_move_constructible_v<Adapter>);
+
+	SECTION("copies reference the same instance")
+	{
+		Adapter original{factory};
+		Adapter copy{original};
+		CHECK(original.increment() == 1);
+		CHECK(copy.increment() == 2);
+		CHECK(Counter::num_alive == 1);
+	}
+
+	SECTION("the instance outlives the adapter it was created with")
+	{
+		std::vector<Adapter> copies;
+		copies.reserve(3);
+		{
+			Adapter const original{factory};
+			for (int idx = 0; idx < 3; ++idx) copies.push_back(original);
+		}
+		CHECK(Counter::num_alive == 1);
+		CHECK(copies.back().increment() == 1);
+		copies.clear();
+		CHECK(Counter::num_alive == 0);
+	}
+
+	CHECK(Counter::num_alive == 0);
+}
+
+SCENARIO("Adapters whose suite cannot add references")
+{
+	static_assert(!std::is_copy_constructible_v<CounterAdapter<UniqueCounterHandle>>);
+	static_assert(std::is_nothrow_move_constructible_v<CounterAdapter<UniqueCounterHandle>>);
+
+	GIVEN("an adapter")
+	{
+		CounterAdapter<UniqueCounterHandle> counter{&unique_counter_suite};
+
+		THEN("it is move-only")
+		{
+			CounterAdapter<UniqueCounterHandle> moved{std::move(counter)};
+			CHECK(moved.increment() == 1);
+		}
+	}
+}
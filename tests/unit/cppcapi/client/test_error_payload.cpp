@@ -0,0 +1,164 @@
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using DictHandle = struct Dict_t *;
+
+struct DictSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, DictHandle *);
+	void (*release)(DictHandle);
+	cppcapi_ErrorCode (*at)(cppcapi_ErrorMessage *, int *, DictHandle, int);
+};
+
+/// Exception carrying the key that wasn't found.
+class KeyNotFound : public std::out_of_range
+{
+public:
+	struct Payload
+	{
+		int key;
+	};
+
+	KeyNotFound(std::string const & message, Payload const payload)
+		: out_of_range{message}, payload_{payload}
+	{
+	}
+
+	[[nodiscard]] Payload payload() const noexcept
+	{
+		return payload_;
+	}
+
+private:
+	Payload payload_;
+};
+
+struct Dict
+{
+	[[nodiscard]] int at(int key) const
+	{
+		auto const it = values.find(key);
+		if (it == values.end())
+			throw KeyNotFound{"Key not found", {key}};
+		return it->second;
+	}
+
+	std::map<int, int> values{{1, 10}};
+};
+
+using ErrorMap = cppcapi::ErrorMap<
+	cppcapi::ErrorTraits<std::invalid_argument, 101>,
+	cppcapi::ErrorTraits<KeyNotFound, 102>>;
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		DictHandle,
+		Dict,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	ErrorMap>;
+
+DictSuite const * dict_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<DictHandle>;
+	static constexpr DictSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::mem_fn_ptr<&Dict::at>)};
+	return &suite;
+}
+
+struct DictAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<DictHandle, DictSuite, DictAdapter, &dict_suite>>,
+	ErrorMap>;
+
+struct DictAdapter : ClientPlugin::SuiteAdapter<DictHandle>
+{
+	DictAdapter() : Base{ksuite_factory}
+	{
+		create();
+	}
+
+	[[nodiscard]] int at(int key) const
+	{
+		return call(suite_.at, key);
+	}
+
+	[[nodiscard]] cppcapi::client::Result<int> find(int key) const
+	{
+		return try_call(suite_.at, key);
+	}
+};
+}  // namespace
+
+SCENARIO("Structured error payloads")
+{
+	GIVEN("an adapter")
+	{
+		DictAdapter const dict;
+
+		WHEN("a call fails with an exception carrying a payload")
+		{
+			THEN("the exception is thrown with its payload")
+			{
+				CHECK(dict.at(1) == 10);
+				try
+				{
+					[[maybe_unused]] int const value = dict.at(42);
+					FAIL("Expected KeyNotFound");
+				}
+				catch (KeyNotFound const & ex)
+				{
+					CHECK(ex.payload().key == 42);
+					CHECK(std::string{ex.what()} == "Key not found");
+				}
+			}
+
+			THEN("the payload is returned with the error")
+			{
+				auto const found = dict.find(7);
+				REQUIRE_FALSE(found);
+				CHECK(found.error().code == 102);
+				CHECK(found.error().message == "Key not found");
+				auto const payload = found.error().payload_as<KeyNotFound::Payload>();
+				REQUIRE(payload.has_value());
+				CHECK(payload->key == 7);
+			}
+		}
+	}
+
+	GIVEN("a call that doesn't request a payload")
+	{
+		DictSuite const & suite = *dict_suite();
+		std::string message(100, '\0');
+		cppcapi_ErrorMessage err{message.size(), 0, message.data()};
+		DictHandle handle = nullptr;
+		REQUIRE(suite.create(&err, &handle) == cppcapi_ok);
+
+		int ret = 0;
+		cppcapi_ErrorCode const code = suite.at(&err, &ret, handle, 42);
+
+		THEN("only the message is written, and the exception has an empty payload")
+		{
+			CHECK(code == 102);
+			CHECK(std::string{err.data, err.size} == "Key not found");
+			CHECK_THROWS_MATCHES(
+				ErrorMap::throw_exception(err, code),
+				KeyNotFound,
+				Catch::Predicate<KeyNotFound>(
+					[](KeyNotFound const & thrown) { return thrown.payload().key == 0; }));
+		}
+
+		suite.release(handle);
+	}
+}
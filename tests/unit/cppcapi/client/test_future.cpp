@@ -0,0 +1,156 @@
+#include <poll.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+#include <cppcapi/thread_pool.hpp>
+
+namespace
+{
+using AccumulatorHandle = struct Accumulator_t *;
+
+struct AccumulatorSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, AccumulatorHandle *);
+	void (*release)(AccumulatorHandle);
+	void (*add)(cppcapi_Completion const *, AccumulatorHandle, int);
+	void (*total)(cppcapi_Completion const *, int *, AccumulatorHandle);
+};
+
+struct Accumulator
+{
+	void add(int value)
+	{
+		if (value < 0)
+			throw std::invalid_argument{"Negative value"};
+		total += value;
+	}
+
+	int total{0};
+};
+
+using ErrorMap = cppcapi::ErrorMap<cppcapi::ErrorTraits<std::invalid_argument, 101>>;
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		AccumulatorHandle,
+		Accumulator,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	ErrorMap>;
+
+AccumulatorSuite const * accumulator_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<AccumulatorHandle>;
+	static constexpr AccumulatorSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate_async(Decorator::mem_fn_ptr<&Accumulator::add>),
+		Decorator::decorate_async([](Accumulator const & self) { return self.total; })};
+	return &suite;
+}
+
+struct AccumulatorAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<cppcapi::client::HandleTraits<
+		AccumulatorHandle,
+		AccumulatorSuite,
+		AccumulatorAdapter,
+		&accumulator_suite>>,
+	ErrorMap>;
+
+struct AccumulatorAdapter : ClientPlugin::SuiteAdapter<AccumulatorHandle>
+{
+	AccumulatorAdapter() : Base{ksuite_factory}
+	{
+		create();
+	}
+
+	Future<void> add(int value, cppcapi::client::AsyncOptions const & options = {})
+	{
+		return call_async(options, suite_.add, value);
+	}
+
+	Future<int> total()
+	{
+		return call_async(suite_.total);
+	}
+};
+}  // namespace
+
+SCENARIO("Calling asynchronous suite functions")
+{
+	GIVEN("an adapter wrapping a service with asynchronous suite functions")
+	{
+		AccumulatorAdapter accumulator;
+
+		WHEN("asynchronous calls are made and waited on")
+		{
+			accumulator.add(1).get();
+			accumulator.add(2).get();
+
+			THEN("out-parameter is available from the future")
+			{
+				CHECK(accumulator.total().get() == 3);
+			}
+		}
+
+		WHEN("an asynchronous call errors")
+		{
+			auto future = accumulator.add(-1);
+
+			THEN("the mapped exception is thrown on getting the result")
+			{
+				CHECK_THROWS_AS(future.get(), std::invalid_argument);
+			}
+		}
+
+		WHEN("an executor is injected")
+		{
+			std::atomic<int> num_submitted{0};
+			cppcapi::ThreadPool pool{1};
+			struct Context
+			{
+				std::atomic<int> & num_submitted;
+				cppcapi_Executor pool_executor;
+			} context{num_submitted, pool.executor()};
+
+			cppcapi_Executor const executor{
+				[](void * ctx, cppcapi_Task task, void * data)
+				{
+					auto * self = static_cast<Context *>(ctx);
+					++self->num_submitted;
+					self->pool_executor.submit(self->pool_executor.context, task, data);
+				},
+				&context};
+
+			accumulator.add(5, {&executor}).get();
+
+			THEN("work was submitted to the injected executor")
+			{
+				CHECK(num_submitted == 1);
+				CHECK(accumulator.total().get() == 5);
+			}
+		}
+
+		WHEN("an eventfd is requested")
+		{
+			auto future = accumulator.add(7, {nullptr, true});
+
+			THEN("eventfd is signalled on completion")
+			{
+				REQUIRE(future.eventfd() >= 0);
+				pollfd fd{future.eventfd(), POLLIN, 0};
+				CHECK(::poll(&fd, 1, 5000) == 1);
+				future.wait();
+				CHECK(future.ready());
+				CHECK(accumulator.total().get() == 7);
+			}
+		}
+	}
+}
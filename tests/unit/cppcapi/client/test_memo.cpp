@@ -0,0 +1,86 @@
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "../../fixtures/tally.hpp"
+
+namespace
+{
+using cppcapitest::num_calls;
+using cppcapitest::PlainTallyHandle;
+using cppcapitest::TallyAdapter;
+using cppcapitest::TallyHandle;
+}  // namespace
+
+SCENARIO("Caching results of pure suite functions")
+{
+	static_assert(
+		sizeof(TallyAdapter<PlainTallyHandle>) ==
+		sizeof(void *) + sizeof(cppcapitest::TallySuite<PlainTallyHandle> const *) +
+			sizeof(PlainTallyHandle));
+
+	num_calls = 0;
+
+	GIVEN("an adapter whose handle declares pure functions")
+	{
+		TallyAdapter<TallyHandle> tally;
+		REQUIRE(tally.init());
+
+		WHEN("pure functions are called repeatedly")
+		{
+			std::size_t const first = tally.size();
+			std::size_t const second = tally.size();
+			std::string const label = tally.label();
+			CHECK(tally.label() == label);
+
+			THEN("the service is only called once per function")
+			{
+				CHECK(first == 0);
+				CHECK(second == 0);
+				CHECK(label == "tally");
+				CHECK(num_calls == 2);
+			}
+		}
+
+		WHEN("another function is called between calls to a pure function")
+		{
+			CHECK(tally.size() == 0);
+			tally.insert(1, 10);
+
+			THEN("the cached result is discarded")
+			{
+				CHECK(tally.size() == 1);
+				CHECK(num_calls == 3);
+			}
+		}
+
+		WHEN("the adapter is moved")
+		{
+			CHECK(tally.size() == 0);
+			TallyAdapter<TallyHandle> const moved{std::move(tally)};
+
+			THEN("the cached results move with the handle")
+			{
+				CHECK(moved.size() == 0);
+				CHECK(num_calls == 1);
+			}
+		}
+	}
+
+	GIVEN("an adapter whose handle declares no pure functions")
+	{
+		TallyAdapter<PlainTallyHandle> tally;
+		REQUIRE(tally.init());
+
+		WHEN("a function is called repeatedly")
+		{
+			CHECK(tally.size() == 0);
+			CHECK(tally.size() == 0);
+
+			THEN("every call reaches the service")
+			{
+				CHECK(num_calls == 2);
+			}
+		}
+	}
+}
@@ -0,0 +1,182 @@
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using NumbersHandle = struct Numbers_t *;
+using NumbersCursor = struct NumbersCursor_t *;
+
+struct NumbersSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, NumbersHandle *, int);
+	void (*release)(NumbersHandle);
+	cppcapi_ErrorCode (*open_values)(cppcapi_ErrorMessage *, NumbersCursor *, NumbersHandle);
+	cppcapi_ErrorCode (*open_squares)(cppcapi_ErrorMessage *, NumbersCursor *, NumbersHandle);
+	cppcapi_ErrorCode (*next_chunk)(
+		cppcapi_ErrorMessage *, std::size_t *, NumbersCursor, int *, std::size_t);
+	void (*close)(NumbersCursor);
+};
+
+struct Numbers
+{
+	explicit Numbers(int const count) : values(static_cast<std::size_t>(count))
+	{
+		std::iota(values.begin(), values.end(), 0);
+	}
+
+	[[nodiscard]] std::vector<int> const & get_values() const
+	{
+		return values;
+	}
+
+	std::vector<int> values;
+};
+
+/// Projection that fails on a particular element.
+struct CheckedInt
+{
+	int operator()(int const value) const
+	{
+		if (value == 13)
+			throw std::runtime_error{"Unlucky"};
+		return value;
+	}
+};
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		NumbersHandle,
+		Numbers,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+/// Number of calls to `next_chunk`.
+std::size_t num_chunks = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+NumbersSuite const * numbers_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<NumbersHandle>;
+	static constexpr NumbersSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate_range<NumbersCursor, int>(
+			Decorator::mem_fn_ptr<&Numbers::get_values>, CheckedInt{}),
+		Decorator::decorate_range<NumbersCursor, int>(
+			[](Numbers const & self)
+			{
+				std::vector<int> squares;
+				for (int const value : self.values) squares.push_back(value * value);
+				return squares;
+			}),
+		[](cppcapi_ErrorMessage * err,
+		   std::size_t * count,
+		   NumbersCursor cursor,
+		   int * out,
+		   std::size_t capacity)
+		{
+			++num_chunks;
+			return Decorator::next_chunk(err, count, cursor, out, capacity);
+		},
+		&Decorator::close_cursor<NumbersCursor>};
+	return &suite;
+}
+
+struct NumbersAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<NumbersHandle, NumbersSuite, NumbersAdapter, &numbers_suite>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+struct NumbersAdapter : ClientPlugin::SuiteAdapter<NumbersHandle>
+{
+	explicit NumbersAdapter(int const count) : Base{ksuite_factory}
+	{
+		create(count);
+	}
+
+	auto values() const
+	{
+		return range<4>(suite_.open_values, suite_.next_chunk, suite_.close);
+	}
+
+	auto squares() const
+	{
+		return range(suite_.open_squares, suite_.next_chunk, suite_.close);
+	}
+};
+}  // namespace
+
+SCENARIO("Iterating a service range in chunks")
+{
+	num_chunks = 0;
+
+	GIVEN("an adapter wrapping a service exposing ranges")
+	{
+		WHEN("a range referenced by the service is iterated")
+		{
+			NumbersAdapter const numbers{10};
+			std::vector<int> values;
+			for (int const value : numbers.values()) values.push_back(value);
+
+			THEN("all elements are received")
+			{
+				CHECK(values == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+			}
+
+			THEN("elements are fetched a chunk at a time")
+			{
+				CHECK(num_chunks == 3);
+			}
+		}
+
+		WHEN("a range that is an exact multiple of the chunk size is iterated")
+		{
+			NumbersAdapter const numbers{8};
+			std::size_t count = 0;
+			for ([[maybe_unused]] int const value : numbers.values()) ++count;
+
+			THEN("an extra call is required to detect the end")
+			{
+				CHECK(count == 8);
+				CHECK(num_chunks == 3);
+			}
+		}
+
+		WHEN("a range returned by value is iterated")
+		{
+			NumbersAdapter const numbers{5};
+			auto squares = numbers.squares();
+			std::vector<int> values{squares.begin(), squares.end()};
+
+			THEN("the range is kept alive by the cursor")
+			{
+				CHECK(values == std::vector<int>{0, 1, 4, 9, 16});
+				CHECK(num_chunks == 1);
+			}
+		}
+
+		WHEN("an element fails to convert")
+		{
+			NumbersAdapter const numbers{20};
+			std::vector<int> values;
+
+			THEN("the error is thrown once iteration reaches the failing chunk")
+			{
+				CHECK_THROWS_AS(
+					[&]
+					{
+						for (int const value : numbers.values()) values.push_back(value);
+					}(),
+					std::runtime_error);
+				CHECK(values.size() == 12);
+			}
+		}
+	}
+}
@@ -0,0 +1,134 @@
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using ParserHandle = struct Parser_t *;
+
+struct ParserSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, ParserHandle *);
+	void (*release)(ParserHandle);
+	cppcapi_ErrorCode (*parse)(cppcapi_ErrorMessage *, int *, ParserHandle, char const *);
+};
+
+struct Parser
+{
+	[[nodiscard]] int parse(char const * text) const
+	{
+		return std::stoi(text, nullptr, base);
+	}
+
+	int base{10};
+};
+
+using ErrorMap = cppcapi::ErrorMap<
+	cppcapi::ErrorTraits<std::invalid_argument, 101>,
+	cppcapi::ErrorTraits<std::out_of_range, 102>>;
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		ParserHandle,
+		Parser,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	ErrorMap>;
+
+ParserSuite const * parser_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<ParserHandle>;
+	static constexpr ParserSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::mem_fn_ptr<&Parser::parse>)};
+	return &suite;
+}
+
+struct ParserAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<ParserHandle, ParserSuite, ParserAdapter, &parser_suite>>,
+	ErrorMap>;
+
+struct ParserAdapter : ClientPlugin::SuiteAdapter<ParserHandle>
+{
+	ParserAdapter() : Base{ksuite_factory}
+	{
+		create();
+	}
+
+	[[nodiscard]] int parse(char const * text) const
+	{
+		return call(suite_.parse, text);
+	}
+};
+}  // namespace
+
+SCENARIO("Status-only suite function calls")
+{
+	GIVEN("a status-only call that fails")
+	{
+		ParserSuite const & suite = *parser_suite();
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		ParserHandle handle = nullptr;
+		REQUIRE(suite.create(&err, &handle) == cppcapi_ok);
+
+		int ret = 0;
+		cppcapi_ErrorCode const code = suite.parse(&err, &ret, handle, "not a number");
+
+		THEN("the error code is returned and the message is not copied")
+		{
+			CHECK(code == 101);
+			CHECK(err.size == 0);
+		}
+
+		THEN("the message is kept alive by the service")
+		{
+			REQUIRE(err.data != nullptr);
+			CHECK(std::string{err.data} == "stoi");
+		}
+
+		suite.release(handle);
+	}
+
+	GIVEN("an adapter")
+	{
+		ParserAdapter const parser;
+
+		WHEN("calls fail within a status-only scope")
+		{
+			cppcapi::client::StatusOnlyScope const scope;
+
+			THEN("exceptions are mapped as usual, with messages read from the service")
+			{
+				CHECK(cppcapi::client::StatusOnlyScope::active());
+				CHECK(parser.parse("42") == 42);
+				CHECK_THROWS_MATCHES(
+					parser.parse("not a number"),
+					std::invalid_argument,
+					Catch::Message("stoi"));
+				CHECK_THROWS_MATCHES(
+					parser.parse("99999999999999999999"),
+					std::out_of_range,
+					Catch::Message("stoi"));
+			}
+		}
+
+		WHEN("calls fail outside of a status-only scope")
+		{
+			THEN("messages are copied to the client as usual")
+			{
+				CHECK_FALSE(cppcapi::client::StatusOnlyScope::active());
+				CHECK_THROWS_MATCHES(
+					parser.parse("not a number"),
+					std::invalid_argument,
+					Catch::Message("stoi"));
+			}
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+#include "../../fixtures/live_counter.hpp"
+
+namespace
+{
+using CounterHandle = struct Counter_t *;
+
+using Counter = cppcapitest::LiveCounter;
+
+struct CounterSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, CounterHandle *);
+	void (*release)(CounterHandle);
+	int (*increment)(CounterHandle);
+};
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		CounterHandle,
+		Counter,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+using Decorator = ServicePlugin::SuiteDecorator<CounterHandle>;
+
+int increment(Counter & self)
+{
+	return ++self.value;
+}
+
+// Decorated functions are constant expressions, so can be used in constant-initialized tables.
+constexpr int (*kincrement)(CounterHandle) =
+	Decorator::decorate(Decorator::free_fn_ptr<&increment>);
+
+/// Number of times the suite factory has been called.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int num_factory_calls = 0;
+
+CounterSuite const * counter_suite()
+{
+	++num_factory_calls;
+	static constexpr CounterSuite suite{&Decorator::create, &Decorator::release, kincrement};
+	static_assert(suite.increment == kincrement);
+	return &suite;
+}
+
+struct CounterAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<CounterHandle, CounterSuite, CounterAdapter>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::runtime_error, 100>>>;
+
+struct CounterAdapter : ClientPlugin::SuiteAdapter<CounterHandle>
+{
+	using Base = ClientPlugin::SuiteAdapter<CounterHandle>;
+
+	explicit CounterAdapter(SuiteFactory suite_factory) : Base{suite_factory}
+	{
+		create();
+	}
+
+	int increment()
+	{
+		return call(suite().increment);
+	}
+
+	/// Address of the suite this adapter calls through.
+	[[nodiscard]] Suite const * suite_address() const
+	{
+		return &suite();
+	}
+};
+}  // namespace
+
+SCENARIO("Sharing constant-initialized suites between adapters")
+{
+	GIVEN("two adapters constructed from the same suite factory")
+	{
+		num_factory_calls = 0;
+		CounterAdapter first{&counter_suite};
+		CounterAdapter second{&counter_suite};
+
+		THEN("both reference the factory's suite rather than copies of it")
+		{
+			CHECK(num_factory_calls == 2);
+			CHECK(first.suite_address() == counter_suite());
+			CHECK(second.suite_address() == first.suite_address());
+		}
+
+		THEN("calls dispatch through the constant-initialized table to separate instances")
+		{
+			CHECK(first.increment() == 1);
+			CHECK(first.increment() == 2);
+			CHECK(second.increment() == 1);
+			CHECK(Counter::num_alive == 2);
+		}
+	}
+
+	CHECK(Counter::num_alive == 0);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+
+#include "../../fixtures/tally.hpp"
+
+namespace
+{
+using cppcapitest::num_calls;
+
+using Adapter = cppcapitest::TallyAdapter<cppcapitest::TallyHandle>;
+}  // namespace
+
+SCENARIO("Calling suite functions without throwing")
+{
+	num_calls = 0;
+
+	GIVEN("an adapter created without throwing")
+	{
+		Adapter tally;
+		REQUIRE(tally.init());
+
+		WHEN("a call succeeds")
+		{
+			REQUIRE(tally.try_insert(1, 10));
+			auto const found = tally.find(1);
+
+			THEN("the result holds the value")
+			{
+				REQUIRE(found.has_value());
+				CHECK(*found == 10);
+				CHECK(found.value_or(0) == 10);
+			}
+		}
+
+		WHEN("a call fails")
+		{
+			auto const found = tally.find(2);
+			auto const inserted = tally.try_insert(2, -1);
+
+			THEN("the result holds the mapped error code and message")
+			{
+				REQUIRE_FALSE(found);
+				CHECK(found.error().code == 101);
+				CHECK(found.value_or(-1) == -1);
+				REQUIRE_FALSE(inserted);
+				CHECK(inserted.error().code == 102);
+				CHECK(inserted.error().message == "Negative value");
+			}
+		}
+
+		WHEN("the adapter is created again")
+		{
+			auto const created = tally.init();
+
+			THEN("the result holds an error")
+			{
+				REQUIRE_FALSE(created);
+				CHECK(created.error().code == cppcapi_error);
+			}
+		}
+
+		WHEN("a pure function is called repeatedly")
+		{
+			CHECK(tally.try_size().value() == 0);
+			CHECK(tally.try_size().value() == 0);
+			REQUIRE(tally.try_insert(1, 10));
+			CHECK(tally.try_size().value() == 1);
+
+			THEN("results are cached until another function is called")
+			{
+				CHECK(num_calls == 3);
+			}
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#include <exception>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+
+#include "../../fixtures/tally.hpp"
+
+namespace
+{
+using cppcapitest::num_calls;
+
+using Handle = cppcapitest::BufferedTallyHandle;
+using Adapter = cppcapitest::TallyAdapter<Handle>;
+}  // namespace
+
+SCENARIO("Coalescing fire-and-forget calls")
+{
+	num_calls = 0;
+
+	GIVEN("an adapter and a write buffer")
+	{
+		Adapter tally;
+		REQUIRE(tally.init());
+		Adapter::Writes writes{cppcapitest::tally_suite<Handle>()->execute, 4};
+
+		WHEN("fewer calls than the threshold are deferred")
+		{
+			tally.insert(writes, 1, 10);
+			tally.insert(writes, 2, 20);
+
+			THEN("no calls have crossed to the service")
+			{
+				CHECK(writes.size() == 2);
+				CHECK(num_calls == 0);
+			}
+
+			THEN("a dependent read flushes the calls first")
+			{
+				CHECK(tally.size(writes) == 2);
+				CHECK(writes.empty());
+				CHECK(num_calls == 2);
+			}
+		}
+
+		WHEN("calls reaching the threshold are deferred")
+		{
+			for (int key = 0; key < 10; ++key) tally.insert(writes, key, key);
+
+			THEN("calls are flushed in batches")
+			{
+				CHECK(num_calls == 2);
+				CHECK(writes.size() == 2);
+			}
+
+			THEN("an explicit flush executes the remainder")
+			{
+				writes.flush();
+				CHECK(num_calls == 3);
+				CHECK(tally.size(writes) == 10);
+			}
+		}
+
+		WHEN("a deferred call fails")
+		{
+			for (int key = 0; key < 6; ++key) tally.insert(writes, key, key == 5 ? -1 : key);
+
+			THEN("the index of the failed call is reported at flush")
+			{
+				try
+				{
+					writes.flush();
+					FAIL("Expected flush to throw");
+				}
+				catch (cppcapi::client::FlushError const & ex)
+				{
+					CHECK(ex.index() == 5);
+					CHECK_THROWS_AS(std::rethrow_if_nested(ex), std::invalid_argument);
+				}
+			}
+
+			THEN("the remaining calls are still executed")
+			{
+				CHECK_THROWS_AS(writes.flush(), cppcapi::client::FlushError);
+				CHECK(writes.empty());
+				CHECK(tally.size(writes) == 5);
+			}
+		}
+	}
+
+	GIVEN("an adapter bound to a write buffer")
+	{
+		Adapter tally;
+		REQUIRE(tally.init());
+		Adapter::Writes writes{cppcapitest::tally_suite<Handle>()->execute, 4};
+		tally.bind_writes(writes);
+		tally.insert(writes, 1, 10);
+		tally.insert(writes, 2, 20);
+
+		THEN("any read flushes the calls first")
+		{
+			CHECK(tally.size() == 2);
+			CHECK(writes.empty());
+			CHECK(num_calls == 2);
+			tally.insert(writes, 3, 30);
+			CHECK(tally.try_size().value() == 3);
+			CHECK(num_calls == 4);
+		}
+
+		WHEN("the write buffer is unbound")
+		{
+			tally.unbind_writes();
+
+			THEN("reads no longer flush")
+			{
+				CHECK(tally.size() == 0);
+				CHECK(writes.size() == 2);
+			}
+		}
+	}
+}
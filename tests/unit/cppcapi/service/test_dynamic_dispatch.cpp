@@ -0,0 +1,224 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using ShapeHandle = struct Shape_t *;
+
+struct ShapeSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, ShapeHandle *, double);
+	void (*release)(ShapeHandle);
+	double (*area)(ShapeHandle);
+	cppcapi_ErrorCode (*scale)(cppcapi_ErrorMessage *, ShapeHandle, double);
+	std::size_t (*combined_name_length)(ShapeHandle, ShapeHandle);
+};
+
+/// Interface class, deliberately without virtual functions.
+struct Shape
+{
+	std::string name;
+};
+
+struct Square final : Shape
+{
+	explicit Square(double const side_) : Shape{"square"}, side{side_} {}
+
+	[[nodiscard]] double area() const
+	{
+		return side * side;
+	}
+
+	void scale(double const factor)
+	{
+		if (factor <= 0)
+			throw std::invalid_argument{"Non-positive scale factor"};
+		side *= factor;
+	}
+
+	double side;
+};
+
+/// Unrelated base preceding the interface, so the interface is at a non-zero offset.
+struct Padding
+{
+	double padding[3]{};
+};
+
+struct Rectangle final : Padding, Shape
+{
+	explicit Rectangle(double const width_) : Shape{"rectangle"}, width{width_}, height{2} {}
+
+	[[nodiscard]] double area() const
+	{
+		return width * height;
+	}
+
+	void scale(double const factor)
+	{
+		width *= factor;
+		height *= factor;
+	}
+
+	double width;
+	double height;
+};
+
+using ServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		ShapeHandle,
+		Shape,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient,
+		cppcapi::service::NoSync,
+		cppcapi::service::DynamicDispatch<ShapeSuite>>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::invalid_argument, 100>>>;
+
+template <class Derived>
+ShapeSuite const * shape_suite()
+{
+	using Decorator = ServicePlugin::SuiteDecorator<ShapeHandle>::Subclass<
+		Derived,
+		&shape_suite<Derived>>;
+	static constexpr ShapeSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::template mem_fn_ptr<&Derived::area>),
+		Decorator::decorate(Decorator::template mem_fn_ptr<&Derived::scale>),
+		Decorator::decorate([](Derived const & self, Shape const & other)
+							{ return self.name.size() + other.name.size(); })};
+	return &suite;
+}
+
+struct ShapeAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::DynamicHandleTraits<ShapeHandle, ShapeSuite, ShapeAdapter>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::invalid_argument, 100>>>;
+
+struct ShapeAdapter : ClientPlugin::SuiteAdapter<ShapeHandle>
+{
+	using Base::Base;
+
+	ShapeAdapter(SuiteFactory suite_factory, double const size) : Base{suite_factory}
+	{
+		create(size);
+	}
+
+	[[nodiscard]] double area() const
+	{
+		return call(suite_.area);
+	}
+
+	void scale(double const factor)
+	{
+		call(suite_.scale, factor);
+	}
+
+	[[nodiscard]] std::size_t combined_name_length(ShapeAdapter const & other) const
+	{
+		return call(suite_.combined_name_length, other);
+	}
+
+	[[nodiscard]] ShapeSuite const * suite() const
+	{
+		return &suite_;
+	}
+};
+}  // namespace
+
+SCENARIO("Dispatching via the suite of an instance's dynamic type")
+{
+	GIVEN("instances of two subclasses created via their own suites")
+	{
+		ShapeAdapter square{&shape_suite<Square>, 3};
+		ShapeAdapter rectangle{&shape_suite<Rectangle>, 3};
+
+		THEN("each handle carries the suite of its dynamic type")
+		{
+			auto const square_handle = static_cast<ShapeHandle>(square);
+			auto const rectangle_handle = static_cast<ShapeHandle>(rectangle);
+			CHECK(cppcapi::dynamic_suite<ShapeSuite>(square_handle) == shape_suite<Square>());
+			CHECK(
+				cppcapi::dynamic_suite<ShapeSuite>(rectangle_handle) == shape_suite<Rectangle>());
+		}
+
+		THEN("calls are dispatched to the subclass")
+		{
+			CHECK(square.area() == 9);
+			CHECK(rectangle.area() == 6);
+		}
+
+		WHEN("a handle created elsewhere is wrapped knowing only the interface")
+		{
+			cppcapi_ErrorMessage err{0, 0, nullptr};
+			ShapeHandle handle = nullptr;
+			REQUIRE(shape_suite<Rectangle>()->create(&err, &handle, 1) == cppcapi_ok);
+			ShapeAdapter const shape{handle};
+
+			THEN("the adapter uses the suite of the dynamic type")
+			{
+				CHECK(shape.suite() == shape_suite<Rectangle>());
+				CHECK(shape.area() == 2);
+			}
+		}
+
+		THEN("other handles are converted knowing only the interface")
+		{
+			// Rectangle's interface is at a different offset to Square's.
+			CHECK(square.combined_name_length(rectangle) == 15);
+			CHECK(rectangle.combined_name_length(square) == 15);
+			CHECK(square.combined_name_length(square) == 12);
+		}
+
+		WHEN("a mutating call is made")
+		{
+			rectangle.scale(2);
+
+			THEN("the subclass instance is updated")
+			{
+				CHECK(rectangle.area() == 24);
+			}
+		}
+
+		WHEN("a call throws")
+		{
+			THEN("the error is propagated")
+			{
+				CHECK_THROWS_AS(square.scale(-1), std::invalid_argument);
+			}
+		}
+
+		WHEN("the handles are converted to the interface class by the service")
+		{
+			using Manager = ServicePlugin::HandleManager<ShapeHandle>;
+
+			THEN("the interface of the instance is found")
+			{
+				auto const square_handle = static_cast<ShapeHandle>(square);
+				auto const rectangle_handle = static_cast<ShapeHandle>(rectangle);
+				CHECK(Manager::to_instance(square_handle).name == "square");
+				CHECK(Manager::to_instance(rectangle_handle).name == "rectangle");
+			}
+		}
+
+		WHEN("a handle is released by the service knowing only the interface")
+		{
+			using Manager = ServicePlugin::HandleManager<ShapeHandle>;
+			cppcapi_ErrorMessage err{0, 0, nullptr};
+			ShapeHandle handle = nullptr;
+			REQUIRE(shape_suite<Rectangle>()->create(&err, &handle, 1) == cppcapi_ok);
+
+			THEN("the release function of the dynamic type's suite is used")
+			{
+				Manager::release(handle);
+			}
+		}
+	}
+}
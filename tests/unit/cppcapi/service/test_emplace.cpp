@@ -0,0 +1,253 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using TrackedHandle = struct Tracked_t *;
+
+/// Counts copies and moves of instances.
+struct Tracked
+{
+	explicit Tracked(int const value_) : value{value_} {}
+
+	explicit Tracked(std::string_view const digits) : value{std::stoi(std::string{digits})} {}
+
+	Tracked(Tracked const & other, int const offset) : value{other.value + offset} {}
+
+	Tracked(Tracked const & other) : value{other.value}
+	{
+		++copies;
+	}
+
+	Tracked(Tracked && other) noexcept : value{other.value}
+	{
+		++moves;
+	}
+
+	Tracked & operator=(Tracked const &) = delete;
+	Tracked & operator=(Tracked &&) = delete;
+	~Tracked() = default;
+
+	static void reset()
+	{
+		copies = 0;
+		moves = 0;
+	}
+
+	int value;
+
+	inline static int copies = 0;	 // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+	inline static int moves = 0;	 // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+};
+
+Tracked make_tracked(int const value)
+{
+	return Tracked{value};
+}
+
+Tracked const & existing_tracked()
+{
+	static Tracked const existing{42};
+	return existing;
+}
+
+struct TrackedSuite
+{
+	TrackedHandle (*make)(int);
+	cppcapi_ErrorCode (*make_or_error)(cppcapi_ErrorMessage *, TrackedHandle *, int);
+	TrackedHandle (*copy_existing)();
+	cppcapi_ErrorCode (*clone)(cppcapi_ErrorMessage *, TrackedHandle *, TrackedHandle);
+	int (*value)(TrackedHandle);
+	void (*release)(TrackedHandle);
+	cppcapi_ErrorCode (*create_from_chars)(
+		cppcapi_ErrorMessage *, TrackedHandle *, char const *, std::size_t);
+	void (*create_from_offset)(TrackedHandle *, TrackedHandle, int);
+	TrackedHandle (*create_from_int)(int);
+};
+
+using NodeHandle = struct Node_t *;
+
+/// Shared instance that can hand out further references to itself.
+struct Node : std::enable_shared_from_this<Node>
+{
+	explicit Node(int const value_) : value{value_} {}
+
+	int value;
+};
+
+Node make_node(int const value)
+{
+	return Node{value};
+}
+
+struct NodeSuite
+{
+	NodeHandle (*make)(int);
+	cppcapi_ErrorCode (*share)(cppcapi_ErrorMessage *, NodeHandle *, NodeHandle);
+	long (*use_count)(NodeHandle);
+	void (*release)(NodeHandle);
+};
+
+using NodePlugin = cppcapi::PluginDefinition<cppcapi::service::HandleMap<
+	cppcapi::service::
+		HandleTraits<NodeHandle, Node, cppcapi::service::HandleOwnershipTag::Shared>>>;
+
+NodeSuite const * node_suite()
+{
+	using Decorator = NodePlugin::SuiteDecorator<NodeHandle>;
+	static constexpr NodeSuite suite{
+		Decorator::decorate<NodeHandle>(Decorator::free_fn_ptr<&make_node>),
+		Decorator::decorate<NodeHandle>([](Node & self) { return self.shared_from_this(); }),
+		Decorator::decorate([](Node const & self) { return self.weak_from_this().use_count(); }),
+		&Decorator::release};
+	return &suite;
+}
+
+template <cppcapi::service::HandleOwnershipTag ownership, class Sync>
+using TrackedPlugin = cppcapi::PluginDefinition<cppcapi::service::HandleMap<
+	cppcapi::service::HandleTraits<TrackedHandle, Tracked, ownership, Sync>>>;
+
+template <class Plugin>
+TrackedSuite const * tracked_suite()
+{
+	using Decorator = typename Plugin::template SuiteDecorator<TrackedHandle>;
+	static constexpr TrackedSuite suite{
+		Decorator::template decorate<TrackedHandle>(Decorator::template free_fn_ptr<&make_tracked>),
+		Decorator::decorate(Decorator::template free_fn_ptr<&make_tracked>),
+		Decorator::template decorate<TrackedHandle>(
+			Decorator::template free_fn_ptr<&existing_tracked>),
+		Decorator::template decorate<TrackedHandle>(
+			[](Tracked const & self) { return Tracked{self.value + 1}; }),
+		Decorator::decorate([](Tracked const & self) { return self.value; }),
+		&Decorator::release,
+		Decorator::template decorate_constructor<std::string_view>(),
+		Decorator::template decorate_constructor<Tracked const &, int>(),
+		Decorator::template decorate_constructor<int>()};
+	return &suite;
+}
+}  // namespace
+
+TEMPLATE_TEST_CASE(
+	"Constructing returned objects in place",
+	"",
+	(TrackedPlugin<cppcapi::service::HandleOwnershipTag::OwnedByClient, cppcapi::service::NoSync>),
+	(TrackedPlugin<
+		cppcapi::service::HandleOwnershipTag::OwnedByClient,
+		cppcapi::service::EmbeddedLock<>>),
+	(TrackedPlugin<cppcapi::service::HandleOwnershipTag::Shared, cppcapi::service::NoSync>))
+{
+	TrackedSuite const & suite = *tracked_suite<TestType>();
+	Tracked::reset();
+
+	SECTION("factory returning by value")
+	{
+		TrackedHandle const handle = suite.make(1);
+
+		CHECK(suite.value(handle) == 1);
+		CHECK(Tracked::copies == 0);
+		CHECK(Tracked::moves == 0);
+		suite.release(handle);
+	}
+
+	SECTION("factory returning by value via out-parameter")
+	{
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		TrackedHandle handle = nullptr;
+		REQUIRE(suite.make_or_error(&err, &handle, 2) == cppcapi_ok);
+
+		CHECK(suite.value(handle) == 2);
+		CHECK(Tracked::copies == 0);
+		CHECK(Tracked::moves == 0);
+		suite.release(handle);
+	}
+
+	SECTION("function bound to a handle returning by value")
+	{
+		TrackedHandle const original = suite.make(3);
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		TrackedHandle handle = nullptr;
+		REQUIRE(suite.clone(&err, &handle, original) == cppcapi_ok);
+
+		CHECK(suite.value(handle) == 4);
+		CHECK(Tracked::copies == 0);
+		CHECK(Tracked::moves == 0);
+		suite.release(handle);
+		suite.release(original);
+	}
+
+	SECTION("factory returning by reference")
+	{
+		TrackedHandle const handle = suite.copy_existing();
+
+		CHECK(suite.value(handle) == 42);
+		CHECK(Tracked::copies == 1);
+		CHECK(Tracked::moves == 0);
+		suite.release(handle);
+	}
+
+	SECTION("named constructors")
+	{
+		cppcapi_ErrorMessage err{0, 0, nullptr};
+		TrackedHandle from_chars = nullptr;
+		REQUIRE(suite.create_from_chars(&err, &from_chars, "123456", 2) == cppcapi_ok);
+		TrackedHandle from_offset = nullptr;
+		suite.create_from_offset(&from_offset, from_chars, 10);
+		TrackedHandle const from_int = suite.create_from_int(7);
+
+		CHECK(suite.value(from_chars) == 12);
+		CHECK(suite.value(from_offset) == 22);
+		CHECK(suite.value(from_int) == 7);
+		CHECK(Tracked::copies == 0);
+		CHECK(Tracked::moves == 0);
+		suite.release(from_int);
+		suite.release(from_offset);
+		suite.release(from_chars);
+	}
+
+	SECTION("named constructor that throws")
+	{
+		std::string storage(100, '\0');
+		cppcapi_ErrorMessage err{storage.size(), 0, storage.data()};
+		TrackedHandle handle = nullptr;
+
+		CHECK(suite.create_from_chars(&err, &handle, "abc", 3) != cppcapi_ok);
+		CHECK(handle == nullptr);
+	}
+}
+
+SCENARIO("Constructing shared objects that share themselves in place")
+{
+	GIVEN("a shared instance deriving from enable_shared_from_this returned by value")
+	{
+		NodeSuite const & suite = *node_suite();
+		NodeHandle const handle = suite.make(1);
+
+		THEN("the instance is owned by the handle's shared_ptr")
+		{
+			CHECK(suite.use_count(handle) == 1);
+		}
+
+		WHEN("the instance shares itself")
+		{
+			cppcapi_ErrorMessage err{0, 0, nullptr};
+			NodeHandle shared = nullptr;
+			REQUIRE(suite.share(&err, &shared, handle) == cppcapi_ok);
+
+			THEN("both handles reference the same instance")
+			{
+				CHECK(suite.use_count(handle) == 2);
+				suite.release(shared);
+				CHECK(suite.use_count(handle) == 1);
+			}
+		}
+
+		suite.release(handle);
+	}
+}
@@ -0,0 +1,129 @@
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/instrumentation.hpp>
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using CounterHandle = struct Counter_t *;
+
+struct Counter
+{
+	int increment(int step)
+	{
+		if (step < 0)
+			throw std::invalid_argument{"Negative step"};
+		return value += step;
+	}
+
+	int value{0};
+};
+
+using Instrumentation = cppcapi::HistogramInstrumentation<8>;
+
+using Plugin = cppcapi::PluginDefinition<
+	Instrumentation,
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		CounterHandle,
+		Counter,
+		cppcapi::service::HandleOwnershipTag::OwnedByService>>>;
+
+using Decorator = Plugin::SuiteDecorator<CounterHandle>;
+
+cppcapi_FunctionStats find_stats(cppcapi_StatsSuite const & suite, std::string_view const name)
+{
+	char storage[100];
+	cppcapi_ErrorMessage err{sizeof(storage), 0, storage};
+	for (std::size_t idx = 0; idx < suite.count(); ++idx)
+	{
+		cppcapi_FunctionStats stats;
+		REQUIRE(suite.get(&err, &stats, idx) == cppcapi_ok);
+		if (std::string_view{stats.name}.find(name) != std::string_view::npos)
+			return stats;
+	}
+	FAIL("No statistics for " << name);
+	return {};
+}
+}  // namespace
+
+SCENARIO("Instrumenting decorated suite functions")
+{
+	static_assert(std::is_same_v<Plugin::Instrumentation, Instrumentation>);
+
+	GIVEN("an instrumented decorated function and a stats suite")
+	{
+		cppcapi_ErrorCode (*increment)(cppcapi_ErrorMessage *, int *, CounterHandle, int) =
+			Decorator::decorate(Decorator::mem_fn_ptr<&Counter::increment>);
+		cppcapi_StatsSuite const & stats_suite = *Instrumentation::stats_suite();
+		stats_suite.reset();
+
+		Counter counter;
+		auto * const handle = reinterpret_cast<CounterHandle>(&counter);
+		char storage[100];
+		cppcapi_ErrorMessage err{sizeof(storage), 0, storage};
+		int out = 0;
+
+		WHEN("calls are made from multiple threads")
+		{
+			CHECK(increment(&err, &out, handle, 1) == cppcapi_ok);
+			CHECK(increment(&err, &out, handle, -1) != cppcapi_ok);
+			std::thread{[&]
+						{
+							cppcapi_ErrorMessage thread_err{sizeof(storage), 0, storage};
+							int thread_out = 0;
+							increment(&thread_err, &thread_out, handle, 2);
+						}}
+				.join();
+
+			THEN("calls, errors and latencies are aggregated")
+			{
+				cppcapi_FunctionStats const stats = find_stats(stats_suite, "Counter::increment");
+				CHECK(stats.calls == 3);
+				CHECK(stats.errors == 1);
+
+				unsigned long long bucketed = 0;
+				for (auto const bucket : stats.buckets) bucketed += bucket;
+				CHECK(bucketed == 3);
+			}
+
+			AND_WHEN("statistics are reset")
+			{
+				stats_suite.reset();
+				increment(&err, &out, handle, 1);
+
+				THEN("only subsequent calls are counted")
+				{
+					cppcapi_FunctionStats const stats =
+						find_stats(stats_suite, "Counter::increment");
+					CHECK(stats.calls == 1);
+					CHECK(stats.errors == 0);
+				}
+			}
+		}
+
+		WHEN("statistics are requested for an unknown index")
+		{
+			cppcapi_FunctionStats stats;
+
+			THEN("an error is returned")
+			{
+				CHECK(stats_suite.get(&err, &stats, 100) != cppcapi_ok);
+			}
+		}
+
+		WHEN("the stats suite is requested again")
+		{
+			cppcapi_StatsSuite const * const again = Instrumentation::stats_suite();
+
+			THEN("the same constant-initialized suite is returned")
+			{
+				CHECK(again == &stats_suite);
+			}
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using WidgetHandle = struct Widget_t *;
+using GadgetHandle = struct Gadget_t *;
+
+struct WidgetSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, WidgetHandle *);
+	void (*release)(WidgetHandle);
+	cppcapi_ErrorCode (*gadget)(cppcapi_ErrorMessage *, GadgetHandle *, WidgetHandle, int);
+	int (*size)(WidgetHandle);
+};
+
+using Plugin = cppcapi::PluginDefinition<cppcapi::service::HandleMap<
+	cppcapi::service::
+		HandleTraits<WidgetHandle, int, cppcapi::service::HandleOwnershipTag::OwnedByClient>,
+	cppcapi::service::
+		HandleTraits<GadgetHandle, double, cppcapi::service::HandleOwnershipTag::Shared>>>;
+
+constexpr cppcapi_SuiteMetadata const & metadata = Plugin::suite_metadata<
+	WidgetHandle,
+	&WidgetSuite::create,
+	&WidgetSuite::release,
+	&WidgetSuite::gadget,
+	&WidgetSuite::size>();
+
+bool ends_with(std::string_view const str, std::string_view const suffix)
+{
+	return str.size() >= suffix.size() && str.substr(str.size() - suffix.size()) == suffix;
+}
+}  // namespace
+
+// Metadata is available at compile time.
+static_assert(metadata.num_functions == 4);
+static_assert(metadata.functions[2].kind == cppcapi_signature_can_output_can_error);
+static_assert(metadata.functions[2].params[1].ownership == cppcapi_ownership_shared);
+
+SCENARIO("Compile-time suite metadata")
+{
+	GIVEN("metadata of a function pointer suite")
+	{
+		THEN("suite and function names are available")
+		{
+			CHECK(ends_with(metadata.name, "::WidgetSuite"));
+			CHECK(ends_with(metadata.functions[0].name, "::WidgetSuite::create"));
+			CHECK(ends_with(metadata.functions[3].name, "::WidgetSuite::size"));
+		}
+
+		THEN("signature kinds are detected")
+		{
+			CHECK(metadata.functions[0].kind == cppcapi_signature_factory_can_output_can_error);
+			CHECK(metadata.functions[1].kind == cppcapi_signature_cannot_output_cannot_error);
+			CHECK(metadata.functions[3].kind == cppcapi_signature_cannot_output_cannot_error);
+		}
+
+		THEN("parameter types and handle ownership are available")
+		{
+			cppcapi_FunctionMetadata const & gadget = metadata.functions[2];
+			REQUIRE(gadget.num_params == 4);
+			CHECK(gadget.params[0].ownership == cppcapi_ownership_none);
+			CHECK(gadget.params[1].ownership == cppcapi_ownership_shared);
+			CHECK(gadget.params[2].ownership == cppcapi_ownership_owned_by_client);
+			CHECK(gadget.params[3].ownership == cppcapi_ownership_none);
+			CHECK(std::string_view{gadget.params[3].type} == "int");
+		}
+	}
+}
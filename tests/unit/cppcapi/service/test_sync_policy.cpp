@@ -0,0 +1,165 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace
+{
+using CounterHandle = struct Counter_t *;
+
+struct Counter
+{
+	void increment()
+	{
+		// Deliberately non-atomic read-modify-write.
+		int const current = value;
+		std::this_thread::yield();
+		value = current + 1;
+	}
+
+	/// Wait until `num_readers` threads are inside this function at once.
+	bool rendezvous(int const num_readers) const
+	{
+		++readers;
+		auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+		while (readers < num_readers)
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+				return false;
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	int value{0};
+	mutable std::atomic<int> readers{0};
+};
+
+struct CounterSuite
+{
+	CounterHandle (*create)();
+	void (*release)(CounterHandle);
+	void (*increment)(CounterHandle);
+	bool (*rendezvous)(CounterHandle, int);
+};
+
+template <cppcapi::service::HandleOwnershipTag ownership, class Sync>
+using CounterPlugin = cppcapi::PluginDefinition<cppcapi::service::HandleMap<
+	cppcapi::service::HandleTraits<CounterHandle, Counter, ownership, Sync>>>;
+
+template <class Plugin>
+CounterSuite const * counter_suite()
+{
+	using Decorator = typename Plugin::template SuiteDecorator<CounterHandle>;
+	static constexpr CounterSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(Decorator::template mem_fn_ptr<&Counter::increment>),
+		Decorator::decorate([](Counter const & self, int num_readers)
+							{ return self.rendezvous(num_readers); })};
+	return &suite;
+}
+
+struct SharedCounterSuite
+{
+	CounterHandle (*create)();
+	void (*release)(CounterHandle);
+	void (*increment_by_value)(CounterHandle);
+	void (*increment_by_const_ref)(CounterHandle);
+};
+
+template <class Plugin>
+SharedCounterSuite const * shared_counter_suite()
+{
+	using Decorator = typename Plugin::template SuiteDecorator<CounterHandle>;
+	static constexpr SharedCounterSuite suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate([](cppcapi::SharedPtr<Counter> self) { self->increment(); }),
+		Decorator::decorate([](cppcapi::SharedPtr<Counter> const & self) { self->increment(); })};
+	return &suite;
+}
+}  // namespace
+
+TEMPLATE_TEST_CASE(
+	"Synchronizing calls to decorated suite functions",
+	"",
+	(CounterPlugin<
+		cppcapi::service::HandleOwnershipTag::OwnedByClient,
+		cppcapi::service::EmbeddedLock<>>),
+	(CounterPlugin<
+		cppcapi::service::HandleOwnershipTag::OwnedByClient,
+		cppcapi::service::EmbeddedLock<cppcapi::service::SpinSharedMutex>>),
+	(CounterPlugin<cppcapi::service::HandleOwnershipTag::Shared, cppcapi::service::StripedLock<>>))
+{
+	constexpr int num_threads = 4;
+	CounterSuite const & suite = *counter_suite<TestType>();
+	CounterHandle const handle = suite.create();
+
+	SECTION("non-const calls are mutually exclusive")
+	{
+		std::vector<std::thread> threads;
+		for (int idx = 0; idx < num_threads; ++idx)
+			threads.emplace_back(
+				[&]
+				{
+					for (int count = 0; count < 100; ++count) suite.increment(handle);
+				});
+		for (auto & thread : threads) thread.join();
+
+		using HandleManager = typename TestType::template HandleManager<CounterHandle>;
+		CHECK(HandleManager::to_instance(handle).value == num_threads * 100);
+	}
+
+	SECTION("const calls can run concurrently")
+	{
+		std::atomic<int> num_met{0};
+		std::vector<std::thread> threads;
+		for (int idx = 0; idx < num_threads; ++idx)
+			threads.emplace_back([&] { num_met += suite.rendezvous(handle, num_threads); });
+		for (auto & thread : threads) thread.join();
+
+		CHECK(num_met == num_threads);
+	}
+
+	suite.release(handle);
+}
+
+TEMPLATE_TEST_CASE(
+	"Synchronizing calls taking a shared pointer to the instance",
+	"",
+	(CounterPlugin<cppcapi::service::HandleOwnershipTag::Shared, cppcapi::service::StripedLock<>>),
+	(CounterPlugin<
+		cppcapi::service::HandleOwnershipTag::Shared,
+		cppcapi::service::StripedLock<64, cppcapi::service::SpinSharedMutex>>))
+{
+	constexpr int num_threads = 4;
+	SharedCounterSuite const & suite = *shared_counter_suite<TestType>();
+	CounterHandle const handle = suite.create();
+
+	SECTION("calls that can mutate via the shared pointer are mutually exclusive")
+	{
+		std::vector<std::thread> threads;
+		for (int idx = 0; idx < num_threads; ++idx)
+			threads.emplace_back(
+				[&]
+				{
+					for (int count = 0; count < 100; ++count)
+					{
+						suite.increment_by_value(handle);
+						suite.increment_by_const_ref(handle);
+					}
+				});
+		for (auto & thread : threads) thread.join();
+
+		using HandleManager = typename TestType::template HandleManager<CounterHandle>;
+		CHECK(HandleManager::to_instance(handle).value == num_threads * 200);
+	}
+
+	suite.release(handle);
+}
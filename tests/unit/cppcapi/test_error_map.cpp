@@ -0,0 +1,212 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/error_map.hpp>
+
+namespace
+{
+template <int n>
+struct NumberedError : std::runtime_error
+{
+	using runtime_error::runtime_error;
+};
+
+/// Previous implementation, matching via nested handlers and throwing via a linear search.
+template <class... ExceptionsAndCodes>
+struct LinearErrorMap
+{
+	template <typename Fn>
+	static cppcapi_ErrorCode wrap_exception(cppcapi_ErrorMessage & err, Fn && fn)
+	{
+		try
+		{
+			return wrap_nested<ExceptionsAndCodes...>(err, std::forward<Fn>(fn));
+		}
+		catch (std::exception const & ex)
+		{
+			cppcapi::detail::extract_exception_message(err, ex);
+			return cppcapi_error;
+		}
+	}
+
+	static void throw_exception(cppcapi_ErrorMessage const & err, cppcapi_ErrorCode const code)
+	{
+		if (code == cppcapi_ok)
+			return;
+
+		(cppcapi::detail::throw_if_matches<ExceptionsAndCodes>(err, code),
+		 ...,
+		 cppcapi::ErrorMap<>::throw_exception(err, code));
+	}
+
+private:
+	template <class ExceptionAndCode, class... Rest, typename Fn>
+	static cppcapi_ErrorCode wrap_nested(cppcapi_ErrorMessage & err, Fn && fn)
+	{
+		try
+		{
+			if constexpr (sizeof...(Rest) > 0)
+				return wrap_nested<Rest...>(err, std::forward<Fn>(fn));
+			else
+				return cppcapi::detail::call_abortable(err, std::forward<Fn>(fn));
+		}
+		catch (typename ExceptionAndCode::Exception const & ex)
+		{
+			cppcapi::detail::extract_exception_message(err, ex);
+			return ExceptionAndCode::code;
+		}
+	}
+};
+
+template <template <class...> class Map, class Seq>
+struct numbered_map;
+
+template <template <class...> class Map, int... ns>
+struct numbered_map<Map, std::integer_sequence<int, ns...>>
+{
+	using type = Map<cppcapi::ErrorTraits<NumberedError<ns>, 100 + ns>...>;
+};
+
+/// Map of `n` distinct exception types, with codes 100 to `100 + n - 1`.
+template <template <class...> class Map, int n>
+using numbered_map_t = typename numbered_map<Map, std::make_integer_sequence<int, n>>::type;
+
+template <class Map, class Exception>
+cppcapi_ErrorCode wrap_throwing(cppcapi_ErrorMessage & err)
+{
+	return Map::wrap_exception(err, [] { throw Exception{"error"}; });
+}
+
+template <class Map>
+std::string catch_thrown(cppcapi_ErrorMessage const & err, cppcapi_ErrorCode const code)
+{
+	try
+	{
+		Map::throw_exception(err, code);
+	}
+	catch (std::exception const & ex)
+	{
+		return ex.what();
+	}
+	return {};
+}
+}  // namespace
+
+SCENARIO("Mapping error codes to exceptions")
+{
+	std::string message = "message";
+	cppcapi_ErrorMessage const err{message.size(), message.size(), message.data()};
+
+	GIVEN("an error map with dense codes")
+	{
+		using Map = numbered_map_t<cppcapi::ErrorMap, 10>;
+
+		THEN("each code throws its exception")
+		{
+			CHECK_THROWS_AS(Map::throw_exception(err, 100), NumberedError<0>);
+			CHECK_THROWS_AS(Map::throw_exception(err, 105), NumberedError<5>);
+			CHECK_THROWS_MATCHES(
+				Map::throw_exception(err, 109), NumberedError<9>, Catch::Message("message"));
+		}
+
+		THEN("unmapped codes fall back to the default exceptions")
+		{
+			CHECK_NOTHROW(Map::throw_exception(err, cppcapi_ok));
+			CHECK_THROWS_AS(Map::throw_exception(err, 99), cppcapi::UnknownError);
+			CHECK_THROWS_AS(Map::throw_exception(err, 110), cppcapi::UnknownError);
+			CHECK_THROWS_AS(Map::throw_exception(err, cppcapi_cancelled), cppcapi::Cancelled);
+		}
+	}
+
+	GIVEN("an error map with sparse and duplicate codes")
+	{
+		using Map = cppcapi::ErrorMap<
+			cppcapi::ErrorTraits<std::out_of_range, 100000>,
+			cppcapi::ErrorTraits<std::invalid_argument, -7>,
+			cppcapi::ErrorTraits<std::domain_error, 42>,
+			cppcapi::ErrorTraits<std::length_error, 42>>;
+
+		THEN("each code throws its exception")
+		{
+			CHECK_THROWS_AS(Map::throw_exception(err, 100000), std::out_of_range);
+			CHECK_THROWS_AS(Map::throw_exception(err, -7), std::invalid_argument);
+			CHECK_THROWS_AS(Map::throw_exception(err, 43), cppcapi::UnknownError);
+		}
+
+		THEN("the first of the duplicates takes precedence")
+		{
+			CHECK_THROWS_AS(Map::throw_exception(err, 42), std::domain_error);
+		}
+	}
+}
+
+SCENARIO("Mapping exceptions to error codes")
+{
+	std::string message(100, '\0');
+	cppcapi_ErrorMessage err{message.size(), 0, message.data()};
+
+	GIVEN("an error map of exceptions deriving from std::exception")
+	{
+		using Map = cppcapi::ErrorMap<
+			cppcapi::ErrorTraits<std::logic_error, 101>,
+			cppcapi::ErrorTraits<std::out_of_range, 102>,
+			cppcapi::ErrorTraits<std::runtime_error, 103>>;
+
+		THEN("exceptions are mapped to their codes")
+		{
+			CHECK(wrap_throwing<Map, std::out_of_range>(err) == 102);
+			CHECK(std::string{err.data, err.size} == "error");
+			CHECK(wrap_throwing<Map, std::runtime_error>(err) == 103);
+			CHECK(wrap_throwing<Map, std::range_error>(err) == 103);
+			CHECK(wrap_throwing<Map, std::invalid_argument>(err) == 101);
+			CHECK(Map::wrap_exception(err, [] { throw std::bad_alloc{}; }) == cppcapi_error);
+			CHECK(wrap_throwing<Map, cppcapi::Cancelled>(err) == cppcapi_cancelled);
+		}
+
+		THEN("codes match the previous implementation")
+		{
+			using Linear = LinearErrorMap<
+				cppcapi::ErrorTraits<std::logic_error, 101>,
+				cppcapi::ErrorTraits<std::out_of_range, 102>,
+				cppcapi::ErrorTraits<std::runtime_error, 103>>;
+			CHECK(
+				wrap_throwing<Map, std::out_of_range>(err) ==
+				wrap_throwing<Linear, std::out_of_range>(err));
+		}
+	}
+}
+
+TEMPLATE_TEST_CASE_SIG(
+	"Error map benchmarks", "[!benchmark]", ((int n), n), 1, 10, 50)
+{
+	using Map = numbered_map_t<cppcapi::ErrorMap, n>;
+	using Linear = numbered_map_t<LinearErrorMap, n>;
+	// The first exception is matched by the outermost handler, so is the worst case when nested.
+	using FirstError = NumberedError<0>;
+	// The last code is the worst case when searched linearly.
+	constexpr cppcapi_ErrorCode last_code = 100 + n - 1;
+
+	std::string message(100, '\0');
+	cppcapi_ErrorMessage err{message.size(), 0, message.data()};
+
+	BENCHMARK("wrap_exception flattened")
+	{
+		return wrap_throwing<Map, FirstError>(err);
+	};
+	BENCHMARK("wrap_exception nested")
+	{
+		return wrap_throwing<Linear, FirstError>(err);
+	};
+	BENCHMARK("throw_exception table")
+	{
+		return catch_thrown<Map>(err, last_code);
+	};
+	BENCHMARK("throw_exception linear")
+	{
+		return catch_thrown<Linear>(err, last_code);
+	};
+}
@@ -0,0 +1,147 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/loader.hpp>
+
+#include "../plugins/counter/client.hpp"
+
+namespace
+{
+using cppcapitest::Counter;
+
+constexpr char const * kplugin_path = CPPCAPI_TEST_COUNTER_PLUGIN_PATH;
+constexpr char const * ksuite_name = cppcapitest::kcounter_suite_name;
+
+/// Add to each counter concurrently, one thread per counter.
+void add_concurrently(std::vector<Counter> const & counters, std::uint64_t const num_adds)
+{
+	std::vector<std::thread> threads;
+	threads.reserve(counters.size());
+	for (Counter const & counter : counters)
+		threads.emplace_back(
+			[&counter, num_adds]
+			{
+				for (std::uint64_t value = 0; value < num_adds; ++value) counter.add(value);
+			});
+	for (std::thread & thread : threads) thread.join();
+}
+}  // namespace
+
+SCENARIO("Loading plugin instances")
+{
+	GIVEN("a plugin loaded twice into the global namespace")
+	{
+		cppcapi::Loader const first{kplugin_path};
+		cppcapi::Loader const second{kplugin_path};
+		auto const first_counter = first.load_adapter<Counter>(ksuite_name);
+		auto const second_counter = second.load_adapter<Counter>(ksuite_name);
+
+		WHEN("each instance's counter is added to")
+		{
+			std::uint64_t const initial = first_counter.total();
+			first_counter.add(1);
+			second_counter.add(2);
+
+			THEN("both instances share the plugin's global state")
+			{
+				CHECK_FALSE(first.isolated());
+				CHECK(first_counter.total() == initial + 3);
+				CHECK(second_counter.total() == initial + 3);
+			}
+		}
+	}
+
+	GIVEN("a plugin loaded eagerly with its suite factory bound")
+	{
+		auto const loader = cppcapi::Loader::load_eager<Counter>(kplugin_path, ksuite_name);
+
+		WHEN("an adapter is made from the bound suite factory")
+		{
+			auto const counter = loader.make_adapter<Counter>();
+			std::uint64_t const initial = counter.total();
+			counter.add(1);
+
+			THEN("the adapter calls into the plugin")
+			{
+				CHECK(counter.total() == initial + 1);
+			}
+		}
+
+		THEN("load timing is reported")
+		{
+			CHECK(loader.timing().open.count() > 0);
+			CHECK(loader.timing().bind.count() > 0);
+			CHECK(loader.timing().num_bound == 1);
+		}
+
+		THEN("adapters can't be made by loaders without the suite factory bound")
+		{
+			cppcapi::Loader const unbound{kplugin_path};
+			CHECK_THROWS_AS(unbound.make_adapter<Counter>(), std::logic_error);
+		}
+	}
+
+#if CPPCAPI_HAS_DLMOPEN
+	GIVEN("a plugin loaded twice into isolated namespaces")
+	{
+		cppcapi::Loader first = cppcapi::Loader::load_isolated(kplugin_path);
+		cppcapi::Loader second = cppcapi::Loader::load_isolated(kplugin_path);
+		auto const first_counter = first.load_adapter<Counter>(ksuite_name);
+		auto const second_counter = second.load_adapter<Counter>(ksuite_name);
+
+		WHEN("each instance's counter is added to")
+		{
+			first_counter.add(1);
+			second_counter.add(2);
+
+			THEN("each instance has its own global state")
+			{
+				CHECK(first.isolated());
+				CHECK(first_counter.total() == 1);
+				CHECK(second_counter.total() == 2);
+			}
+		}
+
+		THEN("exceptions cannot be passed as-is between C++ runtimes")
+		{
+			CHECK_FALSE(first.negotiate_abi());
+		}
+	}
+#endif
+}
+
+#if CPPCAPI_HAS_DLMOPEN
+TEMPLATE_TEST_CASE_SIG(
+	"Plugin instance throughput", "[!benchmark]", ((int num_threads), num_threads), 1, 2, 4)
+{
+	constexpr std::uint64_t num_adds = 10000;
+
+	// One instance, with its global state shared between threads.
+	cppcapi::Loader shared{kplugin_path};
+	std::vector<Counter> shared_counters;
+	// One isolated instance per thread.
+	std::vector<cppcapi::Loader> isolated;
+	std::vector<Counter> isolated_counters;
+
+	for (int idx = 0; idx < num_threads; ++idx)
+	{
+		shared_counters.push_back(shared.load_adapter<Counter>(ksuite_name));
+		isolated.push_back(cppcapi::Loader::load_isolated(kplugin_path));
+		isolated_counters.push_back(isolated.back().load_adapter<Counter>(ksuite_name));
+	}
+
+	BENCHMARK("shared instance")
+	{
+		add_concurrently(shared_counters, num_adds);
+	};
+	BENCHMARK("isolated instances")
+	{
+		add_concurrently(isolated_counters, num_adds);
+	};
+}
+#endif
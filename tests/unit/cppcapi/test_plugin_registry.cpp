@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/plugin_registry.hpp>
+
+#include "../plugins/counter/client.hpp"
+
+namespace
+{
+using cppcapitest::Counter;
+
+constexpr char const * kplugin_name = "cppcapi-test-counter-plugin";
+constexpr char const * ksuite_name = cppcapitest::kcounter_suite_name;
+
+std::filesystem::path plugin_directory()
+{
+	return std::filesystem::path{CPPCAPI_TEST_COUNTER_PLUGIN_PATH}.parent_path();
+}
+}  // namespace
+
+SCENARIO("Loading plugins from directories")
+{
+	GIVEN("a directory containing a plugin and a directory containing a broken plugin")
+	{
+		std::filesystem::path const broken_directory =
+			std::filesystem::temp_directory_path() / "cppcapi-test-plugin-registry";
+		std::filesystem::create_directories(broken_directory);
+		std::ofstream{broken_directory / "libbroken.so"} << "not a DSO";
+		std::ofstream{broken_directory / "README.txt"} << "not a plugin";
+
+		WHEN("the directories are scanned")
+		{
+			auto const paths = cppcapi::PluginRegistry::discover(
+				{plugin_directory(), broken_directory, broken_directory / "missing"});
+
+			THEN("plugin DSOs are found")
+			{
+				auto const num_found = [&paths](std::filesystem::path const & path)
+				{ return std::count(paths.begin(), paths.end(), path); };
+				CHECK(num_found(CPPCAPI_TEST_COUNTER_PLUGIN_PATH) == 1);
+				CHECK(num_found(broken_directory / "libbroken.so") == 1);
+				CHECK(num_found(broken_directory / "README.txt") == 0);
+			}
+		}
+
+		WHEN("the plugins are loaded in parallel")
+		{
+			cppcapi::PluginRegistry registry{RTLD_NOW, 2};
+			std::vector<std::filesystem::path> const paths{
+				CPPCAPI_TEST_COUNTER_PLUGIN_PATH, broken_directory / "libbroken.so"};
+			REQUIRE_NOTHROW(registry.load<Counter>(paths, ksuite_name));
+
+			THEN("the plugin can be found by name and by handle type")
+			{
+				cppcapi::Loader const * by_name = registry.find(kplugin_name);
+				REQUIRE(by_name != nullptr);
+				CHECK(registry.find<cppcapitest_Counter_h>() == by_name);
+				CHECK(registry.find("missing") == nullptr);
+
+				Counter const counter = registry.make_adapter<Counter>();
+				counter.add(3);
+				CHECK(counter.total() == 3);
+			}
+
+			AND_WHEN("more plugins are loaded")
+			{
+				cppcapi::Loader const * by_name = registry.find(kplugin_name);
+				REQUIRE(by_name != nullptr);
+				REQUIRE_NOTHROW(registry.load<Counter>(
+					{broken_directory / "libbroken.so", broken_directory / "libbroken.so"},
+					ksuite_name));
+
+				THEN("plugins found previously are still valid")
+				{
+					CHECK(registry.plugins().size() == 4);
+					CHECK(registry.find(kplugin_name) == by_name);
+					CHECK(registry.find<cppcapitest_Counter_h>() == by_name);
+
+					Counter const counter = by_name->make_adapter<Counter>();
+					counter.add(2);
+					CHECK(counter.total() == 2);
+				}
+			}
+
+			THEN("each plugin's outcome and load time is recorded")
+			{
+				auto const & plugins = registry.plugins();
+				REQUIRE(plugins.size() == 2);
+				CHECK(plugins[0]->name == "broken");
+				CHECK_FALSE(plugins[0]->loader);
+				CHECK_FALSE(plugins[0]->error.empty());
+				CHECK(registry.find("broken") == nullptr);
+				CHECK(plugins[1]->name == kplugin_name);
+				CHECK(plugins[1]->loader);
+				CHECK(plugins[1]->error.empty());
+				CHECK(plugins[1]->load_time.count() > 0);
+			}
+		}
+
+		std::filesystem::remove_all(broken_directory);
+	}
+
+	GIVEN("an empty registry")
+	{
+		cppcapi::PluginRegistry const registry;
+
+		THEN("no plugin provides a suite")
+		{
+			CHECK(registry.find<cppcapitest_Counter_h>() == nullptr);
+			CHECK_THROWS_AS(registry.make_adapter<Counter>(), std::out_of_range);
+		}
+	}
+}
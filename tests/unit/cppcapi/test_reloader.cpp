@@ -0,0 +1,170 @@
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cppcapi/reloader.hpp>
+
+#include "../plugins/counter/client.hpp"
+
+namespace
+{
+using cppcapitest::Counter;
+
+constexpr char const * kplugin_path = CPPCAPI_TEST_COUNTER_PLUGIN_PATH;
+constexpr char const * ksuite_name = cppcapitest::kcounter_suite_name;
+
+/// Load a new build of the plugin, as an independent instance where supported.
+cppcapi::Loader load_build()
+{
+#if CPPCAPI_HAS_DLMOPEN
+	return cppcapi::Loader::load_isolated(kplugin_path, RTLD_NOW);
+#else
+	return cppcapi::Loader{kplugin_path, RTLD_NOW};
+#endif
+}
+}  // namespace
+
+SCENARIO("Reloading a plugin")
+{
+	GIVEN("an adapter created from a reloadable plugin")
+	{
+		cppcapi::Reloader reloader{load_build()};
+		std::optional<cppcapi::Reloadable<Counter>> counter{
+			reloader.make_adapter<Counter>(ksuite_name)};
+		(*counter)->add(2);
+
+		WHEN("the adapter is moved from")
+		{
+			cppcapi::Reloadable<Counter> const moved{std::move(*counter)};
+
+			THEN("the moved-from adapter is stale but keeps its epoch")
+			{
+				CHECK(counter->stale());  // NOLINT(bugprone-use-after-move)
+				CHECK(counter->epoch() == 0);
+				CHECK_FALSE(moved.stale());
+				CHECK(moved.epoch() == 0);
+				CHECK(moved->total() == 2);
+				CHECK_THROWS_AS(counter->adopt(Counter{*moved}), std::logic_error);
+			}
+		}
+
+		WHEN("the plugin is reloaded")
+		{
+			cppcapi::ReloadTiming const timing = reloader.reload(load_build());
+
+			THEN("the existing adapter keeps the previous plugin loaded")
+			{
+				CHECK(timing.num_retained == 1);
+				CHECK(counter->stale());
+				CHECK(counter->epoch() == 0);
+				(*counter)->add(3);
+				CHECK((*counter)->total() == 5);
+			}
+
+			THEN("new adapters are created from the new plugin")
+			{
+				auto const fresh = reloader.make_adapter<Counter>(ksuite_name);
+				CHECK(reloader.epoch() == 1);
+				CHECK(fresh.epoch() == 1);
+				CHECK_FALSE(fresh.stale());
+#if CPPCAPI_HAS_DLMOPEN
+				CHECK(fresh->total() == 0);
+#endif
+			}
+
+			AND_WHEN("the existing adapter is destroyed")
+			{
+				counter.reset();
+
+				THEN("the previous plugin is unloaded")
+				{
+					CHECK(reloader.collect() == 0);
+				}
+			}
+		}
+	}
+
+	GIVEN("an adapter created via a reloadable adapter")
+	{
+		cppcapi::Reloader reloader{cppcapi::Loader{kplugin_path}};
+		std::optional<cppcapi::Reloadable<Counter>> counter{
+			reloader.make_adapter<Counter>(ksuite_name)};
+		std::uint64_t const initial = (*counter)->total();
+		(*counter)->add(1);
+
+		WHEN("a copy of the adapter is adopted")
+		{
+			std::optional<cppcapi::Reloadable<Counter>> copy{counter->adopt(Counter{**counter})};
+
+			AND_WHEN("the plugin is reloaded and the original adapter destroyed")
+			{
+				reloader.reload(cppcapi::Loader{kplugin_path});
+				counter.reset();
+
+				THEN("the copy keeps the previous plugin loaded")
+				{
+					CHECK(reloader.collect() == 1);
+					CHECK(copy->stale());
+					CHECK(copy->epoch() == 0);
+					(*copy)->add(3);
+					CHECK((*copy)->total() == initial + 4);
+				}
+
+				AND_WHEN("the copy is destroyed")
+				{
+					copy.reset();
+
+					THEN("the previous plugin is unloaded")
+					{
+						CHECK(reloader.collect() == 0);
+					}
+				}
+			}
+		}
+	}
+
+	GIVEN("threads creating and calling adapters")
+	{
+		cppcapi::Reloader reloader{cppcapi::Loader{kplugin_path}};
+		std::atomic<bool> stop{false};
+		std::atomic<std::uint64_t> num_calls{0};
+		std::vector<std::thread> threads;
+		for (int idx = 0; idx < 2; ++idx)
+			threads.emplace_back(
+				[&]
+				{
+					while (!stop.load())
+					{
+						auto const counter = reloader.make_adapter<Counter>(ksuite_name);
+						counter->add(1);
+						num_calls.fetch_add(1);
+					}
+				});
+
+		WHEN("the plugin is reloaded repeatedly")
+		{
+			while (num_calls.load() == 0) std::this_thread::yield();
+			std::vector<cppcapi::ReloadTiming> timings;
+			for (int idx = 0; idx < 4; ++idx)
+			{
+				timings.push_back(reloader.reload(cppcapi::Loader{kplugin_path}));
+				std::this_thread::yield();
+			}
+			stop.store(true);
+			for (std::thread & thread : threads) thread.join();
+
+			THEN("calls continue and previous plugins are unloaded once drained")
+			{
+				CHECK(reloader.epoch() == 4);
+				CHECK(reloader.collect() == 0);
+				for (auto const & timing : timings) CHECK(timing.pause.count() >= 0);
+			}
+		}
+	}
+}
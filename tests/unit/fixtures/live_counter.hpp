@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace cppcapitest
+{
+/// Counter tracking the number of live instances, to check handles release them exactly once.
+struct LiveCounter
+{
+	explicit LiveCounter(int const start = 0) : value{start}
+	{
+		++num_alive;
+	}
+
+	LiveCounter(LiveCounter const & other) : value{other.value}
+	{
+		++num_alive;
+	}
+
+	~LiveCounter()
+	{
+		--num_alive;
+	}
+
+	LiveCounter & operator=(LiveCounter const &) = delete;
+
+	[[nodiscard]] int get() const
+	{
+		return value;
+	}
+
+	/// Increment, throwing rather than exceeding a single digit.
+	void increment()
+	{
+		if (value == 9)
+			throw std::out_of_range{"Counter overflow"};
+		++value;
+	}
+
+	int value;
+	/// Reference count, for handles managing their own references.
+	int num_refs{1};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	inline static int num_alive = 0;
+};
+}  // namespace cppcapitest
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <cppcapi/commands.hpp>
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+namespace cppcapitest
+{
+/// Handle whose adapters cache the results of its pure functions.
+using TallyHandle = struct Tally_t *;
+/// Handle declaring no pure functions.
+using PlainTallyHandle = struct PlainTally_t *;
+/// Handle whose adapters can be bound to a write buffer.
+using BufferedTallyHandle = struct BufferedTally_t *;
+
+/// Number of calls that crossed the boundary to the service, other than `create` and `release`.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+inline std::size_t num_calls = 0;
+
+/// Map of keys to non-negative values, for counting calls crossing the boundary.
+struct Tally
+{
+	std::map<int, int> entries;
+	std::string name{"tally"};
+};
+
+template <class Handle>
+struct TallySuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, Handle *);
+	void (*release)(Handle);
+	cppcapi_ErrorCode (*at)(cppcapi_ErrorMessage *, int *, Handle, int);
+	cppcapi_ErrorCode (*insert)(cppcapi_ErrorMessage *, Handle, int, int);
+	cppcapi_ErrorCode (*size)(cppcapi_ErrorMessage *, std::size_t *, Handle);
+	cppcapi_ErrorCode (*label)(cppcapi_ErrorMessage *, char const **, Handle);
+	cppcapi_ErrorCode (*execute)(
+		cppcapi_ErrorMessage *, cppcapi_CommandResult *, cppcapi_CommandBuffer const *);
+};
+
+template <class Handle>
+using TallyCommands = cppcapi::Commands<&TallySuite<Handle>::insert>;
+
+using TallyErrorMap = cppcapi::ErrorMap<
+	cppcapi::ErrorTraits<std::out_of_range, 101>,
+	cppcapi::ErrorTraits<std::invalid_argument, 102>>;
+
+template <class Handle>
+using TallyTraits = cppcapi::service::HandleTraits<
+	Handle,
+	Tally,
+	cppcapi::service::HandleOwnershipTag::OwnedByClient>;
+
+using TallyServicePlugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<
+		TallyTraits<TallyHandle>,
+		TallyTraits<PlainTallyHandle>,
+		TallyTraits<BufferedTallyHandle>>,
+	TallyErrorMap>;
+
+template <class Handle>
+TallySuite<Handle> const * tally_suite()
+{
+	using Decorator = TallyServicePlugin::SuiteDecorator<Handle>;
+	static constexpr TallySuite<Handle> suite{
+		&Decorator::create,
+		&Decorator::release,
+		Decorator::decorate(
+			[](Tally const & self, int key)
+			{
+				++num_calls;
+				return self.entries.at(key);
+			}),
+		Decorator::decorate(
+			[](Tally & self, int key, int value)
+			{
+				++num_calls;
+				if (value < 0)
+					throw std::invalid_argument{"Negative value"};
+				self.entries[key] = value;
+			}),
+		Decorator::decorate(
+			[](Tally const & self)
+			{
+				++num_calls;
+				return self.entries.size();
+			}),
+		Decorator::decorate(
+			[](Tally const & self)
+			{
+				++num_calls;
+				return self.name.c_str();
+			}),
+		[](cppcapi_ErrorMessage * err,
+		   cppcapi_CommandResult * results,
+		   cppcapi_CommandBuffer const * buffer)
+		{
+			// A batch crosses the boundary once, however many calls it executes.
+			std::size_t const crossed = num_calls + 1;
+			cppcapi_ErrorCode const code =
+				Decorator::template execute<TallyCommands<Handle>, &tally_suite<Handle>>(
+					err, results, buffer);
+			num_calls = crossed;
+			return code;
+		}};
+	return &suite;
+}
+
+template <class Handle>
+struct TallyAdapter;
+
+using TallyClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<
+		cppcapi::client::HandleTraits<
+			TallyHandle,
+			TallySuite<TallyHandle>,
+			TallyAdapter<TallyHandle>,
+			&tally_suite<TallyHandle>,
+			&TallySuite<TallyHandle>::size,
+			&TallySuite<TallyHandle>::label>,
+		cppcapi::client::HandleTraits<
+			PlainTallyHandle,
+			TallySuite<PlainTallyHandle>,
+			TallyAdapter<PlainTallyHandle>,
+			&tally_suite<PlainTallyHandle>>,
+		cppcapi::client::WriteBufferedHandleTraits<
+			BufferedTallyHandle,
+			TallySuite<BufferedTallyHandle>,
+			TallyAdapter<BufferedTallyHandle>,
+			&tally_suite<BufferedTallyHandle>>>,
+	TallyErrorMap>;
+
+/// Client adapter for the tally, initially wrapping a null handle until `init` is called.
+template <class Handle>
+struct TallyAdapter : TallyClientPlugin::SuiteAdapter<Handle>
+{
+	using Base = TallyClientPlugin::SuiteAdapter<Handle>;
+	using Writes = typename Base::template WriteBuffer<TallyCommands<Handle>>;
+
+	TallyAdapter() : Base{Base::ksuite_factory} {}
+
+	[[nodiscard]] cppcapi::client::Result<void> init()
+	{
+		return this->try_create();
+	}
+
+	[[nodiscard]] cppcapi::client::Result<int> find(int key) const
+	{
+		return this->try_call(this->suite_.at, key);
+	}
+
+	void insert(int key, int value) const
+	{
+		this->call(this->suite_.insert, key, value);
+	}
+
+	void insert(Writes & writes, int key, int value) const
+	{
+		this->template defer<&TallySuite<Handle>::insert>(writes, key, value);
+	}
+
+	[[nodiscard]] cppcapi::client::Result<void> try_insert(int key, int value) const
+	{
+		return this->try_call(this->suite_.insert, key, value);
+	}
+
+	[[nodiscard]] std::size_t size() const
+	{
+		return this->call(this->suite_.size);
+	}
+
+	[[nodiscard]] std::size_t size(Writes & writes) const
+	{
+		return this->call_after(writes, this->suite_.size);
+	}
+
+	[[nodiscard]] cppcapi::client::Result<std::size_t> try_size() const
+	{
+		return this->try_call(this->suite_.size);
+	}
+
+	[[nodiscard]] std::string label() const
+	{
+		return this->call(this->suite_.label);
+	}
+};
+}  // namespace cppcapitest
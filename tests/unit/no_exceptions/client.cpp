@@ -0,0 +1,73 @@
+// Compile-only check that clients using the non-throwing API build with exceptions disabled.
+
+#include <cstddef>
+#include <stdexcept>
+
+#include <cppcapi/interface.h>
+#include <cppcapi/plugin_definition.hpp>
+
+#if CPPCAPI_EXCEPTIONS
+#error "Expected to be compiled with exceptions disabled"
+#endif
+
+namespace cppcapitest
+{
+using DictHandle = struct Dict_t *;
+
+struct DictSuite
+{
+	cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, DictHandle *);
+	void (*release)(DictHandle);
+	cppcapi_ErrorCode (*at)(cppcapi_ErrorMessage *, int *, DictHandle, int);
+	cppcapi_ErrorCode (*insert)(cppcapi_ErrorMessage *, DictHandle, int, int);
+	cppcapi_ErrorCode (*size)(cppcapi_ErrorMessage *, std::size_t *, DictHandle);
+};
+
+struct DictAdapter;
+
+using ClientPlugin = cppcapi::PluginDefinition<
+	cppcapi::client::HandleMap<cppcapi::client::HandleTraits<
+		DictHandle,
+		DictSuite,
+		DictAdapter,
+		nullptr,
+		&DictSuite::size>>,
+	cppcapi::ErrorMap<cppcapi::ErrorTraits<std::out_of_range, 101>>>;
+
+struct DictAdapter : ClientPlugin::SuiteAdapter<DictHandle>
+{
+	explicit DictAdapter(SuiteFactory suite_factory) : Base{suite_factory} {}
+
+	[[nodiscard]] cppcapi::client::Result<void> init()
+	{
+		return try_create();
+	}
+
+	[[nodiscard]] cppcapi::client::Result<int> find(int key) const
+	{
+		return try_call(suite_.at, key);
+	}
+
+	[[nodiscard]] cppcapi::client::Result<void> insert(int key, int value) const
+	{
+		return try_call(suite_.insert, key, value);
+	}
+
+	[[nodiscard]] cppcapi::client::Result<std::size_t> size() const
+	{
+		return try_call(suite_.size);
+	}
+};
+
+/// Entry point referencing the adapter, so its templates are instantiated.
+int run_client(DictAdapter::SuiteFactory const suite_factory)
+{
+	DictAdapter dict{suite_factory};
+	if (!dict.init() || !dict.insert(1, 10))
+		return -1;
+	auto const found = dict.find(1);
+	if (!found)
+		return found.error().code;
+	return *found + static_cast<int>(dict.size().value_or(0));
+}
+}  // namespace cppcapitest
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include <cppcapi/plugin_definition.hpp>
+
+#include "interface.h"
+
+namespace cppcapitest
+{
+/// Symbol name of the counter plugin's suite factory.
+inline constexpr char const * kcounter_suite_name = "cppcapitest_Counter_suite";
+
+struct Counter;
+
+using CounterClientPlugin = cppcapi::PluginDefinition<cppcapi::client::HandleMap<
+	cppcapi::client::HandleTraits<cppcapitest_Counter_h, cppcapitest_Counter_s, Counter>>>;
+
+/// Client adapter for the counter test plugin.
+struct Counter : CounterClientPlugin::SuiteAdapter<cppcapitest_Counter_h>
+{
+	explicit Counter(SuiteFactory suite_factory) : Base{suite_factory}
+	{
+		create();
+	}
+
+	void add(std::uint64_t value) const
+	{
+		call(suite_.add, value);
+	}
+
+	[[nodiscard]] std::uint64_t total() const
+	{
+		return call(suite_.total);
+	}
+};
+}  // namespace cppcapitest
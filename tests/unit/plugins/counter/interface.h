@@ -0,0 +1,30 @@
+#ifndef cppcapi_test_counter_h
+#define cppcapi_test_counter_h
+
+#include <stdint.h>	 // NOLINT(modernize-deprecated-headers)
+
+#include <cppcapi/interface.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+	typedef struct cppcapitest_Counter_t * cppcapitest_Counter_h;
+
+	typedef struct
+	{
+		cppcapi_ErrorCode (*create)(cppcapi_ErrorMessage *, cppcapitest_Counter_h *);
+		void (*release)(cppcapitest_Counter_h);
+		cppcapi_ErrorCode (*clone)(
+			cppcapi_ErrorMessage *, cppcapitest_Counter_h *, cppcapitest_Counter_h);
+		cppcapi_ErrorCode (*add)(cppcapi_ErrorMessage *, cppcapitest_Counter_h, uint64_t);
+		cppcapi_ErrorCode (*total)(cppcapi_ErrorMessage *, uint64_t *, cppcapitest_Counter_h);
+	} cppcapitest_Counter_s;
+
+	// Test plugin defines:
+	// cppcapitest_Counter_s const * cppcapitest_Counter_suite();
+
+#ifdef __cplusplus
+}
+#endif
+#endif
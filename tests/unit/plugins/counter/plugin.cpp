@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+#include <cppcapi/plugin_definition.hpp>
+
+#include "interface.h"
+
+namespace cppcapitestplugin
+{
+/// State shared by all counters in an instance of the plugin, as commonly found in legacy code.
+struct Globals
+{
+	std::mutex mutex;
+	std::uint64_t total{0};
+	std::uint64_t hash{0};
+};
+
+Globals & globals()
+{
+	static Globals instance;
+	return instance;
+}
+
+struct Counter
+{
+	// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+	void add(std::uint64_t const value)
+	{
+		Globals & state = globals();
+		std::lock_guard const lock{state.mutex};
+		if (state.total + value < state.total)
+			throw std::overflow_error{"Counter overflow"};
+		// Simulate some work requiring the global state.
+		for (int round = 0; round < 64; ++round)
+			state.hash = (state.hash ^ value) * 0x100000001b3ULL;
+		state.total += value;
+	}
+
+	// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+	[[nodiscard]] std::uint64_t total() const
+	{
+		Globals & state = globals();
+		std::lock_guard const lock{state.mutex};
+		return state.total;
+	}
+};
+
+using Plugin = cppcapi::PluginDefinition<
+	cppcapi::service::HandleMap<cppcapi::service::HandleTraits<
+		cppcapitest_Counter_h,
+		Counter,
+		cppcapi::service::HandleOwnershipTag::OwnedByClient>>>;
+}  // namespace cppcapitestplugin
+
+extern "C"
+{
+	using cppcapitestplugin::Counter;
+	using cppcapitestplugin::Plugin;
+
+	__attribute__((visibility("default"))) cppcapitest_Counter_s const *
+	cppcapitest_Counter_suite()
+	{
+		using Decorator = Plugin::SuiteDecorator<cppcapitest_Counter_h>;
+
+		static constexpr cppcapitest_Counter_s suite{
+			&Decorator::create,
+			&Decorator::release,
+			// Counters hold no state of their own, so a copy is as good as a shared instance.
+			// Shared ownership would pull in unique symbols, preventing the plugin being unloaded.
+			Decorator::decorate<cppcapitest_Counter_h>([](Counter const & self) { return self; }),
+			Decorator::decorate(Decorator::mem_fn_ptr<&Counter::add>),
+			Decorator::decorate(Decorator::mem_fn_ptr<&Counter::total>)};
+		return &suite;
+	}
+}